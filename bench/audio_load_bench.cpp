@@ -0,0 +1,109 @@
+// Benchmark of starting the sound engine and loading banks, without the Wwise SDK.
+//
+// Runs against the null and software mixer backends, so it builds with
+// -DPLOP_WWISE=OFF and runs headless. The mixer decodes the media of the
+// banks from plop_wwise/Originals, run it from the repository root.
+
+#include "audio_backend.h"
+#include "bench.h"
+#include "wwise.h"
+#include "wwise_names.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <stdlib.h>
+
+using namespace foundation;
+
+namespace {
+
+constexpr uint32_t ROUNDS = 20;
+
+// Unloads the unreferenced banks and waits for the unloads to finish.
+void evict(wwise::Wwise &wwise) {
+    wwise::evict_unused_banks(wwise);
+    while (wwise.pending_bank_operations > 0) {
+        wwise::update_banks(wwise);
+    }
+}
+
+void run(Allocator &allocator, const wwise::Backend &backend) {
+    wwise::BackendSettings settings;
+    char name[128];
+    Array<uint64_t> samples(allocator);
+
+    // Every bank except Init, which the sound engine loads at startup.
+    Array<AkBankID> bank_ids(allocator);
+    for (uint32_t i = 0; i < wwise::names::BANK_COUNT; ++i) {
+        if (wwise::names::BANKS[i].id != wwise::names::hash("Init")) {
+            array::push_back(bank_ids, wwise::names::BANKS[i].id);
+        }
+    }
+
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        uint64_t start = bench::now_ns();
+        {
+            wwise::Wwise wwise(allocator, settings, &backend);
+        }
+        array::push_back(samples, bench::now_ns() - start);
+    }
+    snprintf(name, sizeof(name), "%s: start and stop, median", backend.name);
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us");
+
+    wwise::Wwise wwise(allocator, settings, &backend);
+    uint64_t resident = 0;
+
+    array::clear(samples);
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        uint64_t start = bench::now_ns();
+        for (uint32_t i = 0; i < array::size(bank_ids); ++i) {
+            wwise::load_bank(wwise, bank_ids[i]);
+        }
+        array::push_back(samples, bench::now_ns() - start);
+
+        resident = wwise.bank_memory;
+        for (uint32_t i = 0; i < array::size(bank_ids); ++i) {
+            wwise::unload_bank(wwise, bank_ids[i]);
+        }
+        evict(wwise);
+    }
+    snprintf(name, sizeof(name), "%s: load %u banks, median", backend.name, array::size(bank_ids));
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us");
+
+    array::clear(samples);
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        uint64_t start = bench::now_ns();
+        for (uint32_t i = 0; i < array::size(bank_ids); ++i) {
+            wwise::load_bank_async(wwise, bank_ids[i]);
+        }
+        if (!wwise::wait_for_banks(wwise, array::begin(bank_ids), array::size(bank_ids))) {
+            printf("error: %s: banks failed to load\n", backend.name);
+            exit(1);
+        }
+        array::push_back(samples, bench::now_ns() - start);
+
+        for (uint32_t i = 0; i < array::size(bank_ids); ++i) {
+            wwise::unload_bank(wwise, bank_ids[i]);
+        }
+        evict(wwise);
+    }
+    snprintf(name, sizeof(name), "%s: load %u banks async, median", backend.name, array::size(bank_ids));
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us");
+
+    snprintf(name, sizeof(name), "%s: bank memory while loaded", backend.name);
+    bench::report(name, (double)resident / 1024.0, "KiB");
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    run(allocator, wwise::NULL_BACKEND);
+    run(allocator, wwise::MIXER_BACKEND);
+
+    memory_globals::shutdown();
+    return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array.h>
+#include <collection_types.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+// Helpers shared by the benchmarks in bench/.
+//
+// Each benchmark is its own executable that prints one line per measurement,
+// so that runs on different machines and configurations can be diffed.
+namespace bench {
+
+inline uint64_t now_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps the compiler from optimizing away a computed value.
+template <typename T>
+inline void do_not_optimize(const T &value) {
+#if defined(_MSC_VER)
+    volatile const T *sink = &value;
+    (void)sink;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// The value at the percentile (0 - 100) of the samples. Sorts the samples.
+inline uint64_t percentile(foundation::Array<uint64_t> &samples, double p) {
+    if (foundation::array::empty(samples)) {
+        return 0;
+    }
+
+    std::sort(foundation::array::begin(samples), foundation::array::end(samples));
+    uint32_t i = (uint32_t)(p / 100.0 * (foundation::array::size(samples) - 1) + 0.5);
+    return samples[i];
+}
+
+// Prints a result as "name: value unit".
+inline void report(const char *name, double value, const char *unit) {
+    printf("%-56s %12.2f %s\n", name, value, unit);
+}
+
+} // namespace bench
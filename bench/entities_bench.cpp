@@ -0,0 +1,130 @@
+// Benchmark of the structure-of-arrays entity store with 100k moving entities.
+//
+// Measures creation, the per frame integrate, handle lookups and churn, and an
+// array-of-structs integrate of the same data for comparison.
+
+#include "bench.h"
+#include "entities.h"
+
+#include <array.h>
+#include <memory.h>
+
+using namespace foundation;
+
+namespace {
+
+constexpr uint32_t ENTITY_COUNT = 100000;
+constexpr uint32_t FRAMES = 1000;
+constexpr uint32_t CHURN_PER_FRAME = 1000;
+constexpr float DT = 1.0f / 60.0f;
+
+struct AosEntity {
+    glm::vec3 position;
+    glm::vec3 velocity;
+    float rotation;
+};
+
+uint32_t xorshift(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float random_velocity(uint32_t &state) {
+    return (float)(xorshift(state) % 2001) / 1000.0f - 1.0f;
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    {
+        plop::Entities entities(allocator);
+        plop::entities::reserve(entities, ENTITY_COUNT);
+        Array<plop::Entity> handles(allocator);
+        array::reserve(handles, ENTITY_COUNT);
+        uint32_t rng = 0x12345678u;
+
+        uint64_t start = bench::now_ns();
+        for (uint32_t i = 0; i < ENTITY_COUNT; ++i) {
+            plop::Entity e = plop::entities::create(entities);
+            plop::entities::set_velocity(entities, e, glm::vec3{random_velocity(rng), random_velocity(rng), 0.0f});
+            array::push_back(handles, e);
+        }
+        bench::report("create 100k entities", (double)(bench::now_ns() - start) / ENTITY_COUNT, "ns/entity");
+
+        Array<uint64_t> frame_ns(allocator);
+        array::reserve(frame_ns, FRAMES);
+        for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+            start = bench::now_ns();
+            plop::entities::integrate(entities, DT);
+            array::push_back(frame_ns, bench::now_ns() - start);
+        }
+        bench::do_not_optimize(entities.position_x[ENTITY_COUNT / 2]);
+        uint64_t soa_ns = bench::percentile(frame_ns, 50);
+        bench::report("integrate 100k entities (SoA), median", (double)soa_ns / 1000.0, "us/frame");
+        bench::report("integrate 100k entities (SoA), median", (double)soa_ns / ENTITY_COUNT, "ns/entity");
+
+        // Handle lookups in random order, the access pattern of gameplay code holding handles.
+        float sum = 0.0f;
+        start = bench::now_ns();
+        for (uint32_t i = 0; i < ENTITY_COUNT; ++i) {
+            plop::Entity e = handles[xorshift(rng) % ENTITY_COUNT];
+            sum += plop::entities::position(entities, e).x;
+        }
+        bench::do_not_optimize(sum);
+        bench::report("position() by random handle", (double)(bench::now_ns() - start) / ENTITY_COUNT, "ns/lookup");
+
+        // Destroy and create a share of the entities each frame, as short lived emitters would.
+        array::clear(frame_ns);
+        for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+            start = bench::now_ns();
+            for (uint32_t i = 0; i < CHURN_PER_FRAME; ++i) {
+                uint32_t slot = xorshift(rng) % ENTITY_COUNT;
+                plop::entities::destroy(entities, handles[slot]);
+                handles[slot] = plop::entities::create(entities);
+            }
+            plop::entities::integrate(entities, DT);
+            array::push_back(frame_ns, bench::now_ns() - start);
+        }
+        bench::report("integrate + 1k destroy/create per frame, median", (double)bench::percentile(frame_ns, 50) / 1000.0, "us/frame");
+
+        uint32_t alive = 0;
+        for (uint32_t i = 0; i < ENTITY_COUNT; ++i) {
+            alive += plop::entities::alive(entities, handles[i]) ? 1 : 0;
+        }
+        if (alive != ENTITY_COUNT || plop::entities::count(entities) != ENTITY_COUNT) {
+            printf("error: %u of %u handles alive, %u entities\n", alive, ENTITY_COUNT, plop::entities::count(entities));
+            return 1;
+        }
+    }
+
+    {
+        Array<AosEntity> entities(allocator);
+        array::resize(entities, ENTITY_COUNT);
+        uint32_t rng = 0x12345678u;
+        for (uint32_t i = 0; i < ENTITY_COUNT; ++i) {
+            entities[i].position = glm::vec3{0.0f, 0.0f, 0.0f};
+            entities[i].velocity = glm::vec3{random_velocity(rng), random_velocity(rng), 0.0f};
+            entities[i].rotation = 0.0f;
+        }
+
+        Array<uint64_t> frame_ns(allocator);
+        array::reserve(frame_ns, FRAMES);
+        for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+            uint64_t start = bench::now_ns();
+            for (uint32_t i = 0; i < ENTITY_COUNT; ++i) {
+                entities[i].position += entities[i].velocity * DT;
+            }
+            array::push_back(frame_ns, bench::now_ns() - start);
+        }
+        bench::do_not_optimize(entities[ENTITY_COUNT / 2].position.x);
+        bench::report("integrate 100k entities (AoS baseline), median", (double)bench::percentile(frame_ns, 50) / 1000.0, "us/frame");
+    }
+
+    memory_globals::shutdown();
+    return 0;
+}
@@ -0,0 +1,201 @@
+// Benchmark of file package LUT look-ups at 100, 10k and 100k files.
+//
+// Builds a package header in memory with that many soundbanks, sets up a
+// CAkFilePackageLUT on it, and looks up files in random order through its hash
+// index and through the binary search the LUT used before, which it still
+// falls back to when the index can't be allocated. Needs the Wwise libraries.
+
+#include "bench.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <algorithm>
+#include <stdlib.h>
+
+#pragma warning(push, 0)
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include <AK/SoundEngine/Common/AkModule.h>
+#include "SoundEngine/Common/AkFilePackageLUT.h"
+#pragma warning(pop)
+
+using namespace foundation;
+
+namespace {
+
+constexpr uint32_t FILE_COUNTS[] = {100, 10000, 100000};
+constexpr uint32_t LOOKUPS = 1000000;
+constexpr uint32_t SETUPS = 20;
+
+// Looks up the soundbanks LUT without its index.
+class BinarySearchLut : public CAkFilePackageLUT {
+  public:
+    const AkFileEntry<AkFileID> *lookup_without_index(AkFileID id) {
+        AkUInt32 file_count;
+        const AkFileEntry<AkFileID> *entries = GetSoundBanks(file_count);
+        const FileLUT<AkFileID> *lut = reinterpret_cast<const FileLUT<AkFileID> *>(reinterpret_cast<const AkUInt32 *>(entries) - 1);
+        return LookupFile<AkFileID>(id, lut, FileIndex(), false);
+    }
+};
+
+// The header of a package, as CAkFilePackageLUT::Setup() reads it.
+struct PackageHeader {
+    char header_definition[AKPK_HEADER_CHUNK_DEF_SIZE];
+    AkUInt32 version;
+    AkUInt32 language_map_size;
+    AkUInt32 soundbanks_lut_size;
+    AkUInt32 stm_files_lut_size;
+    AkUInt32 externals_lut_size;
+};
+
+uint32_t xorshift(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Writes a header with file_count soundbanks, sorted by ID as the packager writes them, and no other files.
+void build_header(Array<AkUInt32> &header, const Array<AkFileID> &ids) {
+    const uint32_t file_count = array::size(ids);
+    const uint32_t entry_words = sizeof(CAkFilePackageLUT::AkFileEntry<AkFileID>) / sizeof(AkUInt32);
+    array::clear(header);
+    array::resize(header, sizeof(PackageHeader) / sizeof(AkUInt32) + 1 + 1 + file_count * entry_words + 1 + 1);
+
+    PackageHeader *package_header = reinterpret_cast<PackageHeader *>(array::begin(header));
+    memcpy(package_header->header_definition, "AKPK", 4);
+    package_header->version = AKPK_CURRENT_VERSION;
+    package_header->language_map_size = sizeof(AkUInt32);
+    package_header->soundbanks_lut_size = sizeof(AkUInt32) * (1 + file_count * entry_words);
+    package_header->stm_files_lut_size = sizeof(AkUInt32);
+    package_header->externals_lut_size = sizeof(AkUInt32);
+
+    AkUInt32 *data = reinterpret_cast<AkUInt32 *>(package_header + 1);
+    *data++ = 0; // No languages
+    *data++ = file_count;
+    CAkFilePackageLUT::AkFileEntry<AkFileID> *entries = reinterpret_cast<CAkFilePackageLUT::AkFileEntry<AkFileID> *>(data);
+    for (uint32_t i = 0; i < file_count; ++i) {
+        entries[i].fileID = ids[i];
+        entries[i].uBlockSize = 16;
+        entries[i].uFileSize = 4096;
+        entries[i].uStartBlock = i * 256;
+        entries[i].uLanguageID = CAkFilePackageLUT::AK_INVALID_LANGUAGE_ID;
+    }
+    data += file_count * entry_words;
+    *data++ = 0; // No streamed files
+    *data++ = 0; // No externals
+}
+
+void run(Allocator &allocator, uint32_t file_count) {
+    uint32_t rng = 0x2545f491u + file_count;
+
+    // Unique IDs, sorted. Misses are IDs that aren't in the package.
+    Array<AkFileID> ids(allocator);
+    array::reserve(ids, file_count * 2);
+    while (array::size(ids) < file_count) {
+        while (array::size(ids) < file_count) {
+            array::push_back(ids, (AkFileID)xorshift(rng));
+        }
+        std::sort(array::begin(ids), array::end(ids));
+        array::resize(ids, (uint32_t)(std::unique(array::begin(ids), array::end(ids)) - array::begin(ids)));
+    }
+
+    Array<AkUInt32> header(allocator);
+    build_header(header, ids);
+    const uint32_t header_size = array::size(header) * sizeof(AkUInt32);
+
+    char name[128];
+    Array<uint64_t> samples(allocator);
+    for (uint32_t i = 0; i < SETUPS; ++i) {
+        BinarySearchLut lut;
+        uint64_t start = bench::now_ns();
+        if (lut.Setup(reinterpret_cast<AkUInt8 *>(array::begin(header)), header_size) != AK_Success) {
+            printf("error: could not set up a LUT of %u files\n", file_count);
+            exit(1);
+        }
+        array::push_back(samples, bench::now_ns() - start);
+    }
+    snprintf(name, sizeof(name), "%6u files: Setup() with index, median", file_count);
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us");
+
+    BinarySearchLut lut;
+    lut.Setup(reinterpret_cast<AkUInt8 *>(array::begin(header)), header_size);
+
+    Array<AkFileID> hits(allocator);
+    Array<AkFileID> misses(allocator);
+    array::reserve(hits, LOOKUPS);
+    array::reserve(misses, LOOKUPS);
+    for (uint32_t i = 0; i < LOOKUPS; ++i) {
+        array::push_back(hits, ids[xorshift(rng) % file_count]);
+        AkFileID miss = xorshift(rng);
+        while (std::binary_search(array::begin(ids), array::end(ids), miss)) {
+            miss = xorshift(rng);
+        }
+        array::push_back(misses, miss);
+    }
+
+    AkFileSystemFlags flags;
+    flags.uCompanyID = AKCOMPANYID_AUDIOKINETIC;
+    flags.uCodecID = AKCODECID_BANK;
+    flags.uCustomParamSize = 0;
+    flags.pCustomParam = NULL;
+    flags.bIsLanguageSpecific = false;
+
+    const Array<AkFileID> *queries[] = {&hits, &misses};
+    const char *query_names[] = {"hit", "miss"};
+    for (uint32_t q = 0; q < 2; ++q) {
+        const Array<AkFileID> &query = *queries[q];
+
+        uint32_t found = 0;
+        uint64_t start = bench::now_ns();
+        for (uint32_t i = 0; i < LOOKUPS; ++i) {
+            found += lut.LookupFile(query[i], &flags) ? 1 : 0;
+        }
+        snprintf(name, sizeof(name), "%6u files: LookupFile() %s, hash index", file_count, query_names[q]);
+        bench::report(name, (double)(bench::now_ns() - start) / LOOKUPS, "ns/lookup");
+
+        uint32_t found_without_index = 0;
+        start = bench::now_ns();
+        for (uint32_t i = 0; i < LOOKUPS; ++i) {
+            found_without_index += lut.lookup_without_index(query[i]) ? 1 : 0;
+        }
+        snprintf(name, sizeof(name), "%6u files: LookupFile() %s, binary search", file_count, query_names[q]);
+        bench::report(name, (double)(bench::now_ns() - start) / LOOKUPS, "ns/lookup");
+
+        const uint32_t expected = q == 0 ? LOOKUPS : 0;
+        if (found != expected || found_without_index != expected) {
+            printf("error: %u files: found %u with the index, %u without, expected %u\n", file_count, found, found_without_index, expected);
+            exit(1);
+        }
+    }
+
+    // The index holds one 32 bit slot per entry at a load factor of at most 1/2.
+    uint32_t slot_count = 1;
+    while (slot_count < file_count * 2) {
+        slot_count <<= 1;
+    }
+    snprintf(name, sizeof(name), "%6u files: index memory", file_count);
+    bench::report(name, (double)slot_count * sizeof(AkUInt32) / 1024.0, "KiB");
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    AkMemSettings mem_settings;
+    AK::MemoryMgr::GetDefaultSettings(mem_settings);
+    if (AK::MemoryMgr::Init(&mem_settings) != AK_Success) {
+        printf("error: could not initialize AK::MemoryMgr\n");
+        return 1;
+    }
+
+    for (uint32_t file_count : FILE_COUNTS) {
+        run(allocator, file_count);
+    }
+
+    AK::MemoryMgr::Term();
+    memory_globals::shutdown();
+    return 0;
+}
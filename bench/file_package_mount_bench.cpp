@@ -0,0 +1,404 @@
+// Benchmark of loading file packages asynchronously while files are streamed from another package.
+//
+// Streams random files of a loaded package from 4 threads through the stream
+// manager, in 16 KiB reads, and times each open and read. Meanwhile, it loads
+// 4 packages of 100k files with LoadFilePackageAsync() in several rounds,
+// checks that their files can be opened once the callbacks are called, and
+// unloads them with UnloadFilePackageAsync(). Reads and opens are reported
+// apart depending on whether a load was in flight when they started: that is
+// the stall the loading causes to streaming. It then queues loads right before
+// Term() to check that the ones not started are cancelled, and prints the
+// device's MountStats. Needs the Wwise libraries, writes its packages in the
+// working directory.
+
+#include "bench.h"
+#include "file_package_writer.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdlib.h>
+#include <thread>
+
+#pragma warning(push, 0)
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include <AK/SoundEngine/Common/AkModule.h>
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include <AK/SoundEngine/Common/IAkStreamMgr.h>
+#include "SoundEngine/Common/AkFilePackageLowLevelIODeferred.h"
+#pragma warning(pop)
+
+using namespace foundation;
+
+namespace {
+
+// The package streamed from while the others are loaded.
+constexpr const char *STREAM_PACKAGE = "mount_bench_stream.pck";
+constexpr uint32_t STREAM_FILES = 64;
+constexpr uint32_t STREAM_FILE_SIZE = 256 * 1024;
+constexpr uint32_t STREAM_BLOCK_SIZE = 2048;
+constexpr uint32_t STREAM_THREADS = 4;
+constexpr uint32_t READ_SIZE = 16 * 1024;
+constexpr AkReal32 READ_DEADLINE_MS = 100.0f;
+
+// The packages loaded asynchronously. Their headers are what takes time to read and index.
+constexpr uint32_t MOUNT_PACKAGES = 4;
+constexpr uint32_t MOUNT_FILES = 100000;
+constexpr uint32_t MOUNT_FIRST_ID = 1000000;
+constexpr uint32_t ROUNDS = 5;
+constexpr uint32_t CANCELLED_LOADS = 8;
+
+constexpr uint32_t IDLE_MS = 1000;
+constexpr uint32_t ROUND_GAP_MS = 200;
+constexpr uint32_t MAX_SAMPLES = 1 << 19;
+
+enum Phase { PHASE_IDLE, PHASE_MOUNTING, PHASE_COUNT };
+
+class PackageIO : public CAkFilePackageLowLevelIODeferred {
+  public:
+    AKRESULT open_file(AkFileID id, AkFileDesc *&file_desc) {
+        AkFileSystemFlags flags;
+        flags.uCompanyID = AKCOMPANYID_AUDIOKINETIC;
+        flags.uCodecID = AKCODECID_VORBIS;
+        flags.uCustomParamSize = 0;
+        flags.pCustomParam = NULL;
+        flags.bIsLanguageSpecific = false;
+
+        AkFileOpenData open_data;
+        open_data.pszFileName = NULL;
+        open_data.fileID = id;
+        open_data.pFlags = &flags;
+        open_data.eOpenMode = AK_OpenModeRead;
+        return Open(open_data, file_desc);
+    }
+};
+
+// The samples are reserved up front so that the stream threads don't allocate.
+struct StreamThread {
+    std::thread thread;
+    Array<uint64_t> *opens[PHASE_COUNT];
+    Array<uint64_t> *reads[PHASE_COUNT];
+    char *buffer;
+    uint32_t seed;
+    uint32_t failed;
+};
+
+// A LoadFilePackageAsync() or UnloadFilePackageAsync() waiting for its callback.
+struct Request {
+    std::atomic<bool> done;
+    AKRESULT result;
+    AkUInt32 package_id;
+    std::thread::id callback_thread;
+};
+
+std::atomic<bool> streaming;
+std::atomic<bool> mounting;
+
+uint32_t xorshift(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void record(Array<uint64_t> &samples, uint64_t value) {
+    if (array::size(samples) < MAX_SAMPLES) {
+        array::push_back(samples, value);
+    }
+}
+
+void stream_files(StreamThread *stream_thread) {
+    AK::MemoryMgr::InitForThread();
+    uint32_t rng = stream_thread->seed;
+
+    AkFileSystemFlags flags;
+    flags.uCompanyID = AKCOMPANYID_AUDIOKINETIC;
+    flags.uCodecID = AKCODECID_VORBIS;
+    flags.uCustomParamSize = 0;
+    flags.pCustomParam = NULL;
+    flags.bIsLanguageSpecific = false;
+
+    AkFileOpenData open_data;
+    open_data.pszFileName = NULL;
+    open_data.pFlags = &flags;
+    open_data.eOpenMode = AK_OpenModeRead;
+
+    while (streaming.load(std::memory_order_acquire)) {
+        open_data.fileID = 1 + xorshift(rng) % STREAM_FILES;
+        AK::IAkStdStream *stream = NULL;
+        uint32_t phase = mounting.load(std::memory_order_acquire) ? PHASE_MOUNTING : PHASE_IDLE;
+        uint64_t start = bench::now_ns();
+        if (AK::IAkStreamMgr::Get()->CreateStd(open_data, stream, true) != AK_Success) {
+            ++stream_thread->failed;
+            continue;
+        }
+        record(*stream_thread->opens[phase], bench::now_ns() - start);
+
+        for (uint32_t position = 0; position < STREAM_FILE_SIZE; position += READ_SIZE) {
+            AkUInt32 size = 0;
+            phase = mounting.load(std::memory_order_acquire) ? PHASE_MOUNTING : PHASE_IDLE;
+            start = bench::now_ns();
+            if (stream->Read(stream_thread->buffer, READ_SIZE, true, AK_DEFAULT_PRIORITY, READ_DEADLINE_MS, size) != AK_Success || size != READ_SIZE) {
+                ++stream_thread->failed;
+                break;
+            }
+            record(*stream_thread->reads[phase], bench::now_ns() - start);
+        }
+        stream->Destroy();
+    }
+    AK::MemoryMgr::TermForThread();
+}
+
+void on_request_done(AkUInt32 package_id, AKRESULT result, void *cookie) {
+    Request *request = static_cast<Request *>(cookie);
+    request->result = result;
+    request->package_id = package_id;
+    request->callback_thread = std::this_thread::get_id();
+    request->done.store(true, std::memory_order_release);
+}
+
+void wait_for(Request *requests, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        while (!requests[i].done.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void mount_package_path(char *path, size_t size, uint32_t index) {
+    snprintf(path, size, "mount_bench_%u.pck", index);
+}
+
+bool load_async(PackageIO &io, uint32_t index, Request &request) {
+    char path[64];
+    mount_package_path(path, sizeof(path), index);
+    AkOSChar *os_path = nullptr;
+    CONVERT_CHAR_TO_OSCHAR(path, os_path);
+    request.done.store(false, std::memory_order_relaxed);
+    return io.LoadFilePackageAsync(os_path, on_request_done, &request) == AK_Success;
+}
+
+void report_samples(Array<uint64_t> &samples, const char *what, const char *phase) {
+    char name[128];
+    snprintf(name, sizeof(name), "%s: stream %s latency p50", phase, what);
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us");
+    snprintf(name, sizeof(name), "%s: stream %s latency p99", phase, what);
+    bench::report(name, (double)bench::percentile(samples, 99) / 1000.0, "us");
+    snprintf(name, sizeof(name), "%s: stream %s latency max", phase, what);
+    bench::report(name, (double)bench::percentile(samples, 100) / 1000.0, "us");
+    snprintf(name, sizeof(name), "%s: stream %ss", phase, what);
+    bench::report(name, (double)array::size(samples), "");
+}
+
+// Streams from the stream threads while the packages are loaded and unloaded ROUNDS times.
+void stream_while_loading(Allocator &allocator, PackageIO &io) {
+    // Each thread has the opens of each phase, then the reads of each phase.
+    Array<uint64_t> *samples[STREAM_THREADS][PHASE_COUNT * 2];
+    Array<char> buffers(allocator);
+    array::resize(buffers, STREAM_THREADS * READ_SIZE);
+    StreamThread stream_threads[STREAM_THREADS];
+    for (uint32_t i = 0; i < STREAM_THREADS; ++i) {
+        for (uint32_t j = 0; j < PHASE_COUNT * 2; ++j) {
+            samples[i][j] = MAKE_NEW(allocator, Array<uint64_t>, allocator);
+            array::reserve(*samples[i][j], MAX_SAMPLES);
+        }
+        StreamThread &stream_thread = stream_threads[i];
+        stream_thread.opens[PHASE_IDLE] = samples[i][0];
+        stream_thread.opens[PHASE_MOUNTING] = samples[i][1];
+        stream_thread.reads[PHASE_IDLE] = samples[i][2];
+        stream_thread.reads[PHASE_MOUNTING] = samples[i][3];
+        stream_thread.buffer = array::begin(buffers) + i * READ_SIZE;
+        stream_thread.seed = 0x9e3779b9u * (i + 1);
+        stream_thread.failed = 0;
+    }
+
+    streaming.store(true, std::memory_order_relaxed);
+    mounting.store(false, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < STREAM_THREADS; ++i) {
+        stream_threads[i].thread = std::thread(stream_files, &stream_threads[i]);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_MS));
+
+    // Load the packages, open one of their files, and unload them.
+    Array<uint64_t> load_times(allocator);
+    Request requests[MOUNT_PACKAGES];
+    const std::thread::id main_thread = std::this_thread::get_id();
+    uint32_t unloads_on_other_threads = 0;
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        mounting.store(true, std::memory_order_release);
+        const uint64_t start = bench::now_ns();
+        for (uint32_t i = 0; i < MOUNT_PACKAGES; ++i) {
+            if (!load_async(io, i, requests[i])) {
+                printf("error: could not queue the load of package %u\n", i);
+                exit(1);
+            }
+        }
+        wait_for(requests, MOUNT_PACKAGES);
+        array::push_back(load_times, bench::now_ns() - start);
+        mounting.store(false, std::memory_order_release);
+
+        for (uint32_t i = 0; i < MOUNT_PACKAGES; ++i) {
+            AkFileDesc *file_desc = NULL;
+            if (requests[i].result != AK_Success || io.open_file(MOUNT_FIRST_ID + i * MOUNT_FILES + MOUNT_FILES / 2, file_desc) != AK_Success) {
+                printf("error: package %u was not loaded, or its files can't be opened: %d\n", i, requests[i].result);
+                exit(1);
+            }
+            io.Close(file_desc);
+        }
+
+        // The last reference to a package may be released by a stream thread that was looking up a file.
+        for (uint32_t i = 0; i < MOUNT_PACKAGES; ++i) {
+            const AkUInt32 package_id = requests[i].package_id;
+            requests[i].done.store(false, std::memory_order_relaxed);
+            if (io.UnloadFilePackageAsync(package_id, on_request_done, &requests[i]) != AK_Success) {
+                printf("error: could not unload package %u\n", package_id);
+                exit(1);
+            }
+        }
+        wait_for(requests, MOUNT_PACKAGES);
+        for (uint32_t i = 0; i < MOUNT_PACKAGES; ++i) {
+            unloads_on_other_threads += requests[i].callback_thread != main_thread ? 1 : 0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(ROUND_GAP_MS));
+    }
+
+    streaming.store(false, std::memory_order_release);
+    uint32_t failed_streams = 0;
+    for (uint32_t i = 0; i < STREAM_THREADS; ++i) {
+        stream_threads[i].thread.join();
+        failed_streams += stream_threads[i].failed;
+    }
+    if (failed_streams > 0) {
+        printf("error: %u streams could not be opened or read\n", failed_streams);
+        exit(1);
+    }
+
+    const char *phase_names[] = {"no load", "load in flight"};
+    Array<uint64_t> merged(allocator);
+    for (uint32_t j = 0; j < PHASE_COUNT * 2; ++j) {
+        array::clear(merged);
+        for (uint32_t i = 0; i < STREAM_THREADS; ++i) {
+            const Array<uint64_t> &thread_samples = *samples[i][j];
+            for (uint32_t k = 0; k < array::size(thread_samples); ++k) {
+                array::push_back(merged, thread_samples[k]);
+            }
+        }
+        report_samples(merged, j < PHASE_COUNT ? "open" : "read", phase_names[j % PHASE_COUNT]);
+    }
+    for (uint32_t i = 0; i < STREAM_THREADS; ++i) {
+        for (uint32_t j = 0; j < PHASE_COUNT * 2; ++j) {
+            MAKE_DELETE(allocator, Array<uint64_t>, samples[i][j]);
+        }
+    }
+
+    char name[128];
+    snprintf(name, sizeof(name), "%u packages of %u files: load time p50", MOUNT_PACKAGES, MOUNT_FILES);
+    bench::report(name, (double)bench::percentile(load_times, 50) / 1e6, "ms");
+    snprintf(name, sizeof(name), "%u packages of %u files: load time max", MOUNT_PACKAGES, MOUNT_FILES);
+    bench::report(name, (double)bench::percentile(load_times, 100) / 1e6, "ms");
+    snprintf(name, sizeof(name), "unload callbacks not on the unloading thread, of %u", ROUNDS * MOUNT_PACKAGES);
+    bench::report(name, (double)unloads_on_other_threads, "");
+
+    CAkFilePackageLowLevelIODeferred::MountStats mount_stats;
+    io.GetMountStats(mount_stats);
+    bench::report("MountStats: packages loaded", (double)mount_stats.uMounts, "");
+    bench::report("MountStats: last load", (double)mount_stats.uLastMountUSec / 1000.0, "ms");
+    bench::report("MountStats: longest load", (double)mount_stats.uMaxMountUSec / 1000.0, "ms");
+    bench::report("MountStats: opens during loads", (double)mount_stats.uOpensDuringMount, "");
+    bench::report("MountStats: slowest open during loads", (double)mount_stats.uMaxOpenDuringMountUSec, "us");
+}
+
+// Queues loads right before Term(), which lets the load in progress finish and cancels the others.
+void cancel_at_term(PackageIO &io) {
+    Request requests[CANCELLED_LOADS];
+    for (uint32_t i = 0; i < CANCELLED_LOADS; ++i) {
+        if (!load_async(io, i % MOUNT_PACKAGES, requests[i])) {
+            printf("error: could not queue the load of package %u\n", i % MOUNT_PACKAGES);
+            exit(1);
+        }
+    }
+    io.Term();
+
+    uint32_t loaded = 0;
+    uint32_t cancelled = 0;
+    for (uint32_t i = 0; i < CANCELLED_LOADS; ++i) {
+        if (!requests[i].done.load(std::memory_order_acquire)) {
+            printf("error: load %u was not called back by Term()\n", i);
+            exit(1);
+        }
+        loaded += requests[i].result == AK_Success ? 1 : 0;
+        cancelled += requests[i].result == AK_Cancelled ? 1 : 0;
+    }
+    if (loaded + cancelled != CANCELLED_LOADS) {
+        printf("error: %u loads queued before Term(), %u loaded and %u cancelled\n", CANCELLED_LOADS, loaded, cancelled);
+        exit(1);
+    }
+
+    char name[128];
+    snprintf(name, sizeof(name), "Term() with %u loads queued: loaded", CANCELLED_LOADS);
+    bench::report(name, (double)loaded, "");
+    snprintf(name, sizeof(name), "Term() with %u loads queued: cancelled", CANCELLED_LOADS);
+    bench::report(name, (double)cancelled, "");
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    AkMemSettings mem_settings;
+    AK::MemoryMgr::GetDefaultSettings(mem_settings);
+    if (AK::MemoryMgr::Init(&mem_settings) != AK_Success) {
+        printf("error: could not initialize AK::MemoryMgr\n");
+        return 1;
+    }
+
+    AkStreamMgrSettings stm_settings;
+    AK::StreamMgr::GetDefaultSettings(stm_settings);
+    if (!AK::StreamMgr::Create(stm_settings)) {
+        printf("error: could not create AK::StreamMgr\n");
+        return 1;
+    }
+
+    AkDeviceSettings device_settings;
+    AK::StreamMgr::GetDefaultDeviceSettings(device_settings);
+    PackageIO io;
+    if (io.Init(device_settings) != AK_Success) {
+        printf("error: could not initialize CAkFilePackageLowLevelIODeferred\n");
+        return 1;
+    }
+    io.SetBasePath(AKTEXT("."));
+
+    char path[64];
+    for (uint32_t i = 0; i < MOUNT_PACKAGES; ++i) {
+        mount_package_path(path, sizeof(path), i);
+        if (!bench::write_file_package(path, MOUNT_FIRST_ID + i * MOUNT_FILES, MOUNT_FILES, 16, 16)) {
+            printf("error: could not write %s\n", path);
+            return 1;
+        }
+    }
+    AkUInt32 stream_package_id;
+    AkOSChar *os_path = nullptr;
+    CONVERT_CHAR_TO_OSCHAR(STREAM_PACKAGE, os_path);
+    if (!bench::write_file_package(STREAM_PACKAGE, 1, STREAM_FILES, STREAM_FILE_SIZE, STREAM_BLOCK_SIZE) || io.LoadFilePackage(os_path, stream_package_id) != AK_Success) {
+        printf("error: could not load %s\n", STREAM_PACKAGE);
+        return 1;
+    }
+
+    stream_while_loading(allocator, io);
+    cancel_at_term(io);
+
+    for (uint32_t i = 0; i < MOUNT_PACKAGES; ++i) {
+        mount_package_path(path, sizeof(path), i);
+        remove(path);
+    }
+    remove(STREAM_PACKAGE);
+
+    AK::IAkStreamMgr::Get()->Destroy();
+    AK::MemoryMgr::Term();
+    memory_globals::shutdown();
+    return 0;
+}
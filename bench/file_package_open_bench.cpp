@@ -0,0 +1,192 @@
+// Benchmark of opening packaged files from several threads, with the snapshot against the package lock.
+//
+// Loads 4 packages of 2000 streamed files and opens and closes random files
+// from 1 to 8 threads, as the stream manager and the bank loader do. Look-ups
+// either go through the snapshot of the packages, without locking, or search
+// the packages one by one under the package lock, which is what they did
+// before the snapshot (and still do if it can't be allocated). The old code
+// also took the lock to close files, so the locked numbers are a lower bound.
+// Needs the Wwise libraries, writes its packages in the working directory.
+
+#include "bench.h"
+#include "file_package_writer.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <atomic>
+#include <stdlib.h>
+#include <thread>
+
+#pragma warning(push, 0)
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include <AK/SoundEngine/Common/AkModule.h>
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include <AK/SoundEngine/Common/IAkStreamMgr.h>
+#include "SoundEngine/Common/AkFilePackageLowLevelIODeferred.h"
+#pragma warning(pop)
+
+using namespace foundation;
+
+namespace {
+
+constexpr uint32_t PACKAGE_COUNT = 4;
+constexpr uint32_t FILES_PER_PACKAGE = 2000;
+constexpr uint32_t FILE_SIZE = 2048;
+constexpr uint32_t THREAD_COUNTS[] = {1, 2, 4, 8};
+constexpr uint32_t MAX_THREADS = 8;
+constexpr uint32_t OPENS_PER_THREAD = 100000;
+
+class PackageIO : public CAkFilePackageLowLevelIODeferred {
+  public:
+    AKRESULT open_file(AkFileID id, AkFileDesc *&file_desc) {
+        AkFileSystemFlags flags;
+        flags.uCompanyID = AKCOMPANYID_AUDIOKINETIC;
+        flags.uCodecID = AKCODECID_VORBIS;
+        flags.uCustomParamSize = 0;
+        flags.pCustomParam = NULL;
+        flags.bIsLanguageSpecific = false;
+
+        AkFileOpenData open_data;
+        open_data.pszFileName = NULL;
+        open_data.fileID = id;
+        open_data.pFlags = &flags;
+        open_data.eOpenMode = AK_OpenModeRead;
+        return Open(open_data, file_desc);
+    }
+
+    void search_under_lock() {
+        AkAutoLock<CAkLock> lock(m_lock);
+        SwapSnapshot(NULL);
+    }
+
+    void search_snapshot() {
+        AkAutoLock<CAkLock> lock(m_lock);
+        PublishSnapshot();
+    }
+};
+
+uint32_t xorshift(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+std::atomic<bool> go;
+std::atomic<uint32_t> failed_opens;
+
+void open_files(PackageIO *io, uint64_t *samples, uint32_t seed) {
+    AK::MemoryMgr::InitForThread();
+    uint32_t rng = seed;
+    while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    for (uint32_t i = 0; i < OPENS_PER_THREAD; ++i) {
+        AkFileDesc *file_desc = NULL;
+        const AkFileID id = 1 + xorshift(rng) % (PACKAGE_COUNT * FILES_PER_PACKAGE);
+        const uint64_t start = bench::now_ns();
+        const AKRESULT result = io->open_file(id, file_desc);
+        samples[i] = bench::now_ns() - start;
+        if (result == AK_Success) {
+            io->Close(file_desc);
+        } else {
+            failed_opens.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    AK::MemoryMgr::TermForThread();
+}
+
+void run(Allocator &allocator, PackageIO &io, const char *scheme, uint32_t thread_count) {
+    // Each thread times its opens in its own part of the samples.
+    Array<uint64_t> samples(allocator);
+    array::resize(samples, thread_count * OPENS_PER_THREAD);
+    std::thread threads[MAX_THREADS];
+    go.store(false, std::memory_order_relaxed);
+    failed_opens.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        threads[i] = std::thread(open_files, &io, array::begin(samples) + i * OPENS_PER_THREAD, 0x9e3779b9u * (i + 1));
+    }
+
+    const uint64_t start = bench::now_ns();
+    go.store(true, std::memory_order_release);
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        threads[i].join();
+    }
+    const uint64_t elapsed = bench::now_ns() - start;
+
+    if (failed_opens.load() > 0) {
+        printf("error: %s: %u opens failed\n", scheme, failed_opens.load());
+        exit(1);
+    }
+
+    char name[128];
+    snprintf(name, sizeof(name), "%s, %u threads: opens", scheme, thread_count);
+    bench::report(name, (double)thread_count * OPENS_PER_THREAD * 1e6 / (double)elapsed, "kopens/s");
+    snprintf(name, sizeof(name), "%s, %u threads: open latency p50", scheme, thread_count);
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us");
+    snprintf(name, sizeof(name), "%s, %u threads: open latency p99", scheme, thread_count);
+    bench::report(name, (double)bench::percentile(samples, 99) / 1000.0, "us");
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    AkMemSettings mem_settings;
+    AK::MemoryMgr::GetDefaultSettings(mem_settings);
+    if (AK::MemoryMgr::Init(&mem_settings) != AK_Success) {
+        printf("error: could not initialize AK::MemoryMgr\n");
+        return 1;
+    }
+
+    AkStreamMgrSettings stm_settings;
+    AK::StreamMgr::GetDefaultSettings(stm_settings);
+    if (!AK::StreamMgr::Create(stm_settings)) {
+        printf("error: could not create AK::StreamMgr\n");
+        return 1;
+    }
+
+    AkDeviceSettings device_settings;
+    AK::StreamMgr::GetDefaultDeviceSettings(device_settings);
+    PackageIO io;
+    if (io.Init(device_settings) != AK_Success) {
+        printf("error: could not initialize CAkFilePackageLowLevelIODeferred\n");
+        return 1;
+    }
+    io.SetBasePath(AKTEXT("."));
+
+    char path[64];
+    for (uint32_t i = 0; i < PACKAGE_COUNT; ++i) {
+        snprintf(path, sizeof(path), "open_bench_%u.pck", i);
+        AkUInt32 package_id;
+        AkOSChar *os_path = nullptr;
+        CONVERT_CHAR_TO_OSCHAR(path, os_path);
+        if (!bench::write_file_package(path, 1 + i * FILES_PER_PACKAGE, FILES_PER_PACKAGE, FILE_SIZE, 16) || io.LoadFilePackage(os_path, package_id) != AK_Success) {
+            printf("error: could not load %s\n", path);
+            return 1;
+        }
+    }
+
+    for (uint32_t thread_count : THREAD_COUNTS) {
+        io.search_under_lock();
+        run(allocator, io, "package lock", thread_count);
+        io.search_snapshot();
+        run(allocator, io, "snapshot", thread_count);
+    }
+
+    io.UnloadAllFilePackages();
+    io.Term();
+    for (uint32_t i = 0; i < PACKAGE_COUNT; ++i) {
+        snprintf(path, sizeof(path), "open_bench_%u.pck", i);
+        remove(path);
+    }
+
+    AK::IAkStreamMgr::Get()->Destroy();
+    AK::MemoryMgr::Term();
+    memory_globals::shutdown();
+    return 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Writes file packages for the benchmarks of CAkFilePackageLowLevelIO, in the
+// format of the Wwise file packager: the header chunk, an empty language map,
+// the LUTs, and then the data of the files, aligned on their block size.
+namespace bench {
+
+// Writes a package of file_count streamed files of file_size bytes each, not language-specific, with the IDs
+// first_id to first_id + file_count - 1. Returns false if the file could not be written.
+inline bool write_file_package(const char *path, uint32_t first_id, uint32_t file_count, uint32_t file_size, uint32_t block_size) {
+    const uint32_t entry_size = 5 * sizeof(uint32_t);
+    const uint32_t lut_size = sizeof(uint32_t) + file_count * entry_size;
+
+    // Version and the sizes of the language map and the three LUTs, then the map and the LUTs.
+    const uint32_t header_size = 5 * sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t) + lut_size + sizeof(uint32_t);
+    const uint32_t data_start = (8 + header_size + block_size - 1) / block_size * block_size;
+    const uint32_t file_blocks = (file_size + block_size - 1) / block_size;
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool ok = true;
+    auto write_u32 = [&](uint32_t value) { ok = ok && fwrite(&value, sizeof(value), 1, file) == 1; };
+
+    fwrite("AKPK", 1, 4, file);
+    write_u32(header_size);
+    write_u32(1);                // Version
+    write_u32(sizeof(uint32_t)); // Language map
+    write_u32(sizeof(uint32_t)); // Soundbanks LUT
+    write_u32(lut_size);         // Streamed files LUT
+    write_u32(sizeof(uint32_t)); // Externals LUT
+    write_u32(0);                // No languages
+    write_u32(0);                // No soundbanks
+
+    // Entries are sorted by ID, then by language.
+    write_u32(file_count);
+    for (uint32_t i = 0; i < file_count; ++i) {
+        write_u32(first_id + i);
+        write_u32(block_size);
+        write_u32(file_size);
+        write_u32(data_start / block_size + i * file_blocks);
+        write_u32(0); // Not language-specific
+    }
+    write_u32(0); // No externals
+
+    static char block[64 * 1024];
+    for (uint32_t i = 0; i < sizeof(block); ++i) {
+        block[i] = (char)(i * 31);
+    }
+    for (uint32_t written = 8 + header_size; ok && written < data_start; ++written) {
+        ok = fputc(0, file) != EOF;
+    }
+    for (uint64_t remaining = (uint64_t)file_count * file_blocks * block_size; ok && remaining > 0;) {
+        const size_t size = remaining < sizeof(block) ? (size_t)remaining : sizeof(block);
+        ok = fwrite(block, 1, size, file) == size;
+        remaining -= size;
+    }
+
+    return fclose(file) == 0 && ok;
+}
+
+} // namespace bench
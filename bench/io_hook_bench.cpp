@@ -0,0 +1,194 @@
+// Benchmark of the POSIX streaming I/O hook, io_uring against the pread() thread pool.
+//
+// Reads a 64 MiB file through CAkDefaultIOHookDeferred::BatchRead() in batches
+// of the device's uMaxConcurrentIO transfers, the way the stream manager hands
+// them over, once with io_uring and once with the pool threads. The file is in
+// the page cache after it's written, so this measures what the hook adds on
+// top of the copies rather than the drive. Needs the Wwise libraries, Linux
+// only, writes io_hook_bench.tmp in the working directory.
+
+#include "bench.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+
+#pragma warning(push, 0)
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include <AK/SoundEngine/Common/AkModule.h>
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include <AK/SoundEngine/Common/IAkStreamMgr.h>
+#include "AkDefaultIOHookDeferred.h"
+#pragma warning(pop)
+
+using namespace foundation;
+
+namespace {
+
+constexpr const char *FILE_NAME = "io_hook_bench.tmp";
+constexpr uint32_t FILE_SIZE = 64 * 1024 * 1024;
+constexpr uint32_t READ_SIZES[] = {16 * 1024, 256 * 1024};
+constexpr uint32_t PASSES = 4;
+
+struct Read {
+    AkAsyncIOTransferInfo info;
+    uint64_t submit_ns;
+    uint64_t complete_ns;
+    AKRESULT result;
+};
+
+std::atomic<uint32_t> reads_done;
+
+void AKSOUNDENGINE_CALL on_read(AkAsyncIOTransferInfo *info, AKRESULT result) {
+    Read *read = static_cast<Read *>(info->pCookie);
+    read->complete_ns = bench::now_ns();
+    read->result = result;
+    reads_done.fetch_add(1, std::memory_order_release);
+}
+
+bool write_file() {
+    FILE *file = fopen(FILE_NAME, "wb");
+    if (!file) {
+        return false;
+    }
+    static char block[1024 * 1024];
+    for (uint32_t i = 0; i < sizeof(block); ++i) {
+        block[i] = (char)(i * 31);
+    }
+    bool ok = true;
+    for (uint32_t written = 0; ok && written < FILE_SIZE; written += sizeof(block)) {
+        ok = fwrite(block, 1, sizeof(block), file) == sizeof(block);
+    }
+    return fclose(file) == 0 && ok;
+}
+
+void run(Allocator &allocator, bool allow_io_uring) {
+    AkDeviceSettings device_settings;
+    AK::StreamMgr::GetDefaultDeviceSettings(device_settings);
+    const uint32_t in_flight = device_settings.uMaxConcurrentIO;
+
+    CAkDefaultIOHookDeferred hook;
+    if (hook.Init(device_settings, allow_io_uring) != AK_Success) {
+        printf("error: could not initialize CAkDefaultIOHookDeferred\n");
+        exit(1);
+    }
+    if (allow_io_uring && !hook.UsesIoUring()) {
+        printf("io_uring is unavailable, skipped\n");
+        hook.Term();
+        return;
+    }
+    const char *mode = hook.UsesIoUring() ? "io_uring" : "pread pool";
+
+    AkFileDesc file_desc = AkFileDesc();
+    file_desc.hFile = fopen(FILE_NAME, "rb");
+    file_desc.iFileSize = FILE_SIZE;
+    if (!file_desc.hFile) {
+        printf("error: could not open %s\n", FILE_NAME);
+        exit(1);
+    }
+
+    Array<Read> reads(allocator);
+    Array<AK::StreamMgr::IAkLowLevelIOHook::BatchIoTransferItem> items(allocator);
+    Array<char> buffers(allocator);
+    Array<uint64_t> latencies(allocator);
+    array::resize(reads, in_flight);
+    array::resize(items, in_flight);
+
+    char name[128];
+    for (uint32_t read_size : READ_SIZES) {
+        array::resize(buffers, in_flight * read_size);
+        array::clear(latencies);
+        uint32_t failed = 0;
+
+        const uint64_t start = bench::now_ns();
+        for (uint32_t pass = 0; pass < PASSES; ++pass) {
+            for (uint32_t position = 0; position < FILE_SIZE; position += in_flight * read_size) {
+                const uint32_t count = (FILE_SIZE - position) / read_size < in_flight ? (FILE_SIZE - position) / read_size : in_flight;
+                reads_done.store(0, std::memory_order_relaxed);
+                for (uint32_t i = 0; i < count; ++i) {
+                    Read &read = reads[i];
+                    read.info = AkAsyncIOTransferInfo();
+                    read.info.pBuffer = array::begin(buffers) + i * read_size;
+                    read.info.uFilePosition = position + i * read_size;
+                    read.info.uBufferSize = read_size;
+                    read.info.uRequestedSize = read_size;
+                    read.info.pCallback = on_read;
+                    read.info.pCookie = &read;
+                    read.submit_ns = bench::now_ns();
+
+                    items[i].pFileDesc = &file_desc;
+                    items[i].ioHeuristics = AkIoHeuristics();
+                    items[i].pTransferInfo = &read.info;
+                }
+                hook.BatchRead(count, array::begin(items));
+
+                // Yields rather than spins, so the completion or pool threads get the core on small machines.
+                while (reads_done.load(std::memory_order_acquire) < count) {
+                    AkThreadYield();
+                }
+                for (uint32_t i = 0; i < count; ++i) {
+                    failed += reads[i].result == AK_Success ? 0 : 1;
+                    array::push_back(latencies, reads[i].complete_ns - reads[i].submit_ns);
+                }
+            }
+        }
+        const uint64_t elapsed = bench::now_ns() - start;
+        bench::do_not_optimize(buffers[read_size / 2]);
+
+        if (failed > 0) {
+            printf("error: %s: %u reads failed\n", mode, failed);
+            exit(1);
+        }
+
+        const double reads_total = (double)array::size(latencies);
+        snprintf(name, sizeof(name), "%s, %3u KiB reads, %u in flight: reads", mode, read_size / 1024, in_flight);
+        bench::report(name, reads_total * 1e9 / (double)elapsed / 1000.0, "kreads/s");
+        snprintf(name, sizeof(name), "%s, %3u KiB reads, %u in flight: throughput", mode, read_size / 1024, in_flight);
+        bench::report(name, (double)PASSES * FILE_SIZE * 1e3 / (double)elapsed, "MB/s");
+        snprintf(name, sizeof(name), "%s, %3u KiB reads, %u in flight: latency p50", mode, read_size / 1024, in_flight);
+        bench::report(name, (double)bench::percentile(latencies, 50) / 1000.0, "us");
+        snprintf(name, sizeof(name), "%s, %3u KiB reads, %u in flight: latency p99", mode, read_size / 1024, in_flight);
+        bench::report(name, (double)bench::percentile(latencies, 99) / 1000.0, "us");
+    }
+
+    fclose(file_desc.hFile);
+    hook.Term();
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    AkMemSettings mem_settings;
+    AK::MemoryMgr::GetDefaultSettings(mem_settings);
+    if (AK::MemoryMgr::Init(&mem_settings) != AK_Success) {
+        printf("error: could not initialize AK::MemoryMgr\n");
+        return 1;
+    }
+
+    AkStreamMgrSettings stm_settings;
+    AK::StreamMgr::GetDefaultSettings(stm_settings);
+    if (!AK::StreamMgr::Create(stm_settings)) {
+        printf("error: could not create AK::StreamMgr\n");
+        return 1;
+    }
+
+    if (!write_file()) {
+        printf("error: could not write %s\n", FILE_NAME);
+        return 1;
+    }
+
+    run(allocator, true);
+    run(allocator, false);
+    remove(FILE_NAME);
+
+    AK::IAkStreamMgr::Get()->Destroy();
+    AK::MemoryMgr::Term();
+    memory_globals::shutdown();
+    return 0;
+}
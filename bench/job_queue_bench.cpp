@@ -0,0 +1,232 @@
+// Benchmark of handing sound engine jobs to worker threads, per-worker queues against one shared queue.
+//
+// The per-worker queues are AK::JobWorkerMgr as the game runs it. The shared
+// queue is the scheme it replaced, kept here with the same sound engine queue,
+// semaphore and thread primitives: every request goes through one queue and
+// releases one semaphore all the workers sleep on. Jobs are requested the way
+// the sound engine does, through AkJobMgrSettings::fnRequestJobWorker, and only
+// spin for JOB_US so the handoff dominates. Needs the Wwise libraries.
+
+#include "bench.h"
+#include "cpu_topology.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <atomic>
+#include <thread>
+
+#pragma warning(push, 0)
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include <AK/SoundEngine/Common/AkModule.h>
+#include <AK/Tools/Common/AkFifoQueue.h>
+#include "SoundEngine/Common/AkJobWorkerMgr.h"
+#pragma warning(pop)
+
+using namespace foundation;
+
+namespace {
+
+constexpr uint32_t ROUNDS = 2000;
+constexpr uint32_t BATCHES = 20000;
+constexpr uint32_t JOB_US = 2;
+
+// Long enough for the workers to go to sleep between latency rounds.
+constexpr uint32_t IDLE_GAP_US = 500;
+
+// When the first and the last job of a request started, and how many jobs have finished.
+std::atomic<uint64_t> first_start_ns;
+std::atomic<uint64_t> last_start_ns;
+std::atomic<uint32_t> jobs_done;
+
+void AKSOUNDENGINE_CALL run_job(AkJobType, AkUInt32) {
+    const uint64_t start = bench::now_ns();
+    uint64_t expected = 0;
+    first_start_ns.compare_exchange_strong(expected, start, std::memory_order_relaxed);
+    uint64_t last = last_start_ns.load(std::memory_order_relaxed);
+    while (last < start && !last_start_ns.compare_exchange_weak(last, start, std::memory_order_relaxed)) {
+    }
+
+    while (bench::now_ns() - start < JOB_US * 1000) {
+    }
+    jobs_done.fetch_add(1, std::memory_order_release);
+}
+
+// The shared queue scheme. Woken workers spin on the queue head until the request they were woken for shows up.
+namespace shared_queue {
+
+typedef AkFifoQueue<AkJobType, AkJobType_Generic, ArrayPoolLEngineDefault> JobTypeQueue;
+
+struct Worker {
+    AkThread thread;
+    std::atomic<bool> keep_alive;
+};
+
+JobTypeQueue queue;
+AkSemaphore semaphore;
+AkJobWorkerFunc job_worker = nullptr;
+Worker workers[plop::MAX_LOGICAL_PROCESSORS];
+uint32_t worker_count = 0;
+
+void AKSOUNDENGINE_CALL request_job_worker(AkJobWorkerFunc function, AkJobType job_type, AkUInt32 count, void *) {
+    job_worker = function;
+    for (AkUInt32 i = 0; i < count; ++i) {
+        while (!queue.Enqueue(job_type)) {
+            AkThreadYield();
+        }
+    }
+    AKPLATFORM::AkReleaseSemaphore(semaphore, count);
+}
+
+AK_DECLARE_THREAD_ROUTINE(worker_main) {
+    Worker &worker = *AK_GET_THREAD_ROUTINE_PARAMETER_PTR(Worker);
+    AK::MemoryMgr::InitForThread();
+
+    AKPLATFORM::AkWaitForSemaphore(semaphore);
+    while (worker.keep_alive.load(std::memory_order_acquire)) {
+        AkJobType job_type;
+        while (!queue.Dequeue(job_type)) {
+            AkSpinHint();
+        }
+        job_worker(job_type, 0);
+        AKPLATFORM::AkWaitForSemaphore(semaphore);
+    }
+
+    AK::MemoryMgr::TermForThread();
+    AkExitThread(AK_RETURN_THREAD_OK);
+}
+
+void init(uint32_t count) {
+    uint32_t entries = 2;
+    while (entries < count * AK_NUM_JOB_TYPES) {
+        entries <<= 1;
+    }
+    queue.Init(entries);
+    AKPLATFORM::AkCreateSemaphore(semaphore, 0);
+
+    AkThreadProperties properties;
+    AKPLATFORM::AkGetDefaultHighPriorityThreadProperties(properties);
+    worker_count = count;
+    for (uint32_t i = 0; i < count; ++i) {
+        workers[i].keep_alive.store(true, std::memory_order_relaxed);
+        AKPLATFORM::AkCreateThread(worker_main, &workers[i], properties, &workers[i].thread, "shared_queue worker");
+    }
+}
+
+void term() {
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        workers[i].keep_alive.store(false, std::memory_order_release);
+    }
+
+    // Woken workers without a request would spin on the queue, so give each one to dequeue.
+    request_job_worker(job_worker ? job_worker : run_job, AkJobType_Generic, worker_count, nullptr);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        AKPLATFORM::AkWaitForSingleThread(&workers[i].thread);
+        AKPLATFORM::AkCloseThread(&workers[i].thread);
+    }
+
+    AKPLATFORM::AkDestroySemaphore(semaphore);
+    queue.Term();
+}
+
+} // namespace shared_queue
+
+typedef decltype(AkJobMgrSettings::fnRequestJobWorker) RequestFunction;
+
+void wait_for_jobs(uint32_t count) {
+    while (jobs_done.load(std::memory_order_acquire) < count) {
+        AkSpinHint();
+    }
+}
+
+void measure(Allocator &allocator, const char *scheme, RequestFunction request, uint32_t worker_count) {
+    char name[128];
+    Array<uint64_t> first(allocator);
+    Array<uint64_t> all(allocator);
+    array::reserve(first, ROUNDS);
+    array::reserve(all, ROUNDS);
+
+    // Request-to-start latency from idle, for one worker and for all of them.
+    const uint32_t request_counts[] = {1, worker_count};
+    for (uint32_t pass = 0; pass < (worker_count > 1 ? 2u : 1u); ++pass) {
+        const uint32_t requested = request_counts[pass];
+        array::clear(first);
+        array::clear(all);
+        for (uint32_t round = 0; round < ROUNDS; ++round) {
+            std::this_thread::sleep_for(std::chrono::microseconds(IDLE_GAP_US));
+
+            jobs_done.store(0, std::memory_order_relaxed);
+            first_start_ns.store(0, std::memory_order_relaxed);
+            last_start_ns.store(0, std::memory_order_relaxed);
+            const uint64_t start = bench::now_ns();
+            request(run_job, AkJobType_Generic, requested, nullptr);
+            wait_for_jobs(requested);
+
+            array::push_back(first, first_start_ns.load(std::memory_order_relaxed) - start);
+            array::push_back(all, last_start_ns.load(std::memory_order_relaxed) - start);
+        }
+
+        snprintf(name, sizeof(name), "%s, %2u workers: request %2u, first start p50", scheme, worker_count, requested);
+        bench::report(name, (double)bench::percentile(first, 50) / 1000.0, "us");
+        snprintf(name, sizeof(name), "%s, %2u workers: request %2u, first start p99", scheme, worker_count, requested);
+        bench::report(name, (double)bench::percentile(first, 99) / 1000.0, "us");
+        if (requested > 1) {
+            snprintf(name, sizeof(name), "%s, %2u workers: request %2u, all started p50", scheme, worker_count, requested);
+            bench::report(name, (double)bench::percentile(all, 50) / 1000.0, "us");
+            snprintf(name, sizeof(name), "%s, %2u workers: request %2u, all started p99", scheme, worker_count, requested);
+            bench::report(name, (double)bench::percentile(all, 99) / 1000.0, "us");
+        }
+    }
+
+    // Throughput of back to back requests for all workers, as the audio graph makes within a frame.
+    jobs_done.store(0, std::memory_order_relaxed);
+    const uint64_t start = bench::now_ns();
+    for (uint32_t batch = 0; batch < BATCHES; ++batch) {
+        request(run_job, AkJobType_Generic, worker_count, nullptr);
+    }
+    wait_for_jobs(BATCHES * worker_count);
+    const uint64_t elapsed = bench::now_ns() - start;
+
+    snprintf(name, sizeof(name), "%s, %2u workers: throughput", scheme, worker_count);
+    bench::report(name, (double)BATCHES * worker_count * 1e3 / (double)elapsed, "Mjobs/s");
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    AkMemSettings mem_settings;
+    AK::MemoryMgr::GetDefaultSettings(mem_settings);
+    if (AK::MemoryMgr::Init(&mem_settings) != AK_Success) {
+        printf("error: could not initialize AK::MemoryMgr\n");
+        return 1;
+    }
+    AKPLATFORM::UpdatePerformanceFrequency();
+
+    plop::CpuTopology topology;
+    plop::cpu_topology::detect(topology);
+    const uint32_t max_workers = topology.logical_count > 1 ? topology.logical_count - 1 : 1;
+
+    for (uint32_t worker_count = 1; worker_count <= max_workers; worker_count *= 2) {
+        AK::JobWorkerMgr::InitSettings settings;
+        AK::JobWorkerMgr::GetDefaultInitSettings(settings);
+        settings.uNumWorkerThreads = worker_count;
+        settings.eTrimPolicy = AK::JobWorkerMgr::TrimPolicy_Never;
+        if (AK::JobWorkerMgr::InitWorkers(settings) != AK_Success) {
+            printf("error: could not start %u job workers\n", worker_count);
+            return 1;
+        }
+        measure(allocator, "per-worker queues", settings.GetJobMgrSettings().fnRequestJobWorker, worker_count);
+        AK::JobWorkerMgr::TermWorkers();
+
+        shared_queue::init(worker_count);
+        measure(allocator, "shared queue", shared_queue::request_job_worker, worker_count);
+        shared_queue::term();
+    }
+
+    AK::MemoryMgr::Term();
+    memory_globals::shutdown();
+    return 0;
+}
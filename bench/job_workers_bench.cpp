@@ -0,0 +1,129 @@
+// Benchmark of the sound engine's audio frame time by job worker count.
+//
+// Starts the sound engine rendering offline with 1 job worker up to one per
+// free core, unpinned and then pinned, plays a few hundred piano voices on
+// their own positioned game objects, and times AK::SoundEngine::RenderAudio,
+// which renders one frame on this thread and hands its voice and bus jobs to
+// the workers. Needs the Wwise libraries, run it from the repository root.
+
+#include "audio_backend.h"
+#include "bench.h"
+#include "cpu_topology.h"
+#include "wwise.h"
+#include "Wwise_IDs.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <math.h>
+
+using namespace foundation;
+
+namespace {
+
+const uint32_t VOICE_COUNTS[] = {64, 256};
+constexpr uint32_t FRAMES = 500;
+
+const AkBankID BANKS[] = {
+    AK::BANKS::MIX_MASTER,
+    AK::BANKS::DEBUG_SOUNDS,
+    AK::BANKS::PLAYER,
+};
+
+const AkUniqueID EVENTS[] = {
+    AK::EVENTS::PLAY_PIANO_C_001,
+    AK::EVENTS::PLAY_PIANO_D_001,
+    AK::EVENTS::PLAY_PIANO_E_001,
+    AK::EVENTS::PLAY_PIANO_F_001,
+    AK::EVENTS::PLAY_PIANO_G_001,
+    AK::EVENTS::PLAY_PIANO_A_001,
+    AK::EVENTS::PLAY_PIANO_BB_001,
+};
+constexpr uint32_t EVENT_COUNT = sizeof(EVENTS) / sizeof(EVENTS[0]);
+
+void run(Allocator &allocator, uint32_t worker_count, bool pinned, uint32_t voice_count) {
+    wwise::BackendSettings settings;
+    settings.job_workers = worker_count;
+    settings.pin_threads = pinned;
+    settings.offline_render = true;
+
+    wwise::Wwise wwise(allocator, settings, &wwise::WWISE_BACKEND);
+    for (uint32_t i = 0; i < sizeof(BANKS) / sizeof(BANKS[0]); ++i) {
+        wwise::load_bank(wwise, BANKS[i]);
+    }
+
+    // Spread around the listener, so every voice is spatialized.
+    Array<AkGameObjectID> game_objects(allocator);
+    array::resize(game_objects, voice_count);
+    for (uint32_t i = 0; i < voice_count; ++i) {
+        char name[32];
+        snprintf(name, sizeof(name), "voice %u", i);
+        game_objects[i] = wwise::register_game_object(wwise, name);
+
+        const float angle = (float)i * 2.0f * (float)M_PI / (float)voice_count;
+        const float distance = 2.0f + (float)(i % 8) * 2.0f;
+        wwise::set_position(wwise, game_objects[i], glm::vec3(cosf(angle) * distance, 0.0f, sinf(angle) * distance));
+    }
+    wwise::submit_transforms(wwise);
+
+    wwise::JobStats before;
+    wwise::job_stats(wwise, before);
+
+    Array<uint64_t> samples(allocator);
+    array::reserve(samples, FRAMES);
+    uint64_t voices_playing = 0;
+    for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+        // Voices that finished start over, so the frames render about the same number.
+        for (uint32_t i = 0; i < voice_count; ++i) {
+            const uint32_t playing = wwise.backend->playing_count(wwise.backend_instance, game_objects[i]);
+            if (playing == 0) {
+                wwise::post_event(wwise, EVENTS[i % EVENT_COUNT], game_objects[i]);
+            }
+            voices_playing += playing;
+        }
+
+        uint64_t start = bench::now_ns();
+        wwise.backend->render(wwise.backend_instance);
+        array::push_back(samples, bench::now_ns() - start);
+    }
+
+    wwise::JobStats after;
+    wwise::job_stats(wwise, after);
+
+    char name[128];
+    const char *pinning = pinned ? "pinned" : "unpinned";
+    snprintf(name, sizeof(name), "%2u workers, %s, %3u voices: render, median", worker_count, pinning, voice_count);
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us/frame");
+    snprintf(name, sizeof(name), "%2u workers, %s, %3u voices: render, p99", worker_count, pinning, voice_count);
+    bench::report(name, (double)bench::percentile(samples, 99) / 1000.0, "us/frame");
+    snprintf(name, sizeof(name), "%2u workers, %s, %3u voices: voices playing", worker_count, pinning, voice_count);
+    bench::report(name, (double)voices_playing / FRAMES, "per frame");
+    snprintf(name, sizeof(name), "%2u workers, %s, %3u voices: worker requests", worker_count, pinning, voice_count);
+    bench::report(name, (double)(after.requests - before.requests) / FRAMES, "per frame");
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    plop::CpuTopology topology;
+    plop::cpu_topology::detect(topology);
+
+    // One worker per core the default settings leave free, at least one.
+    const wwise::BackendSettings defaults;
+    const uint32_t free_cores = topology.core_count > defaults.reserved_cores ? topology.core_count - defaults.reserved_cores : 1;
+
+    // Unpinned first, since pinning the sound engine also pins this thread to the main thread's core.
+    for (uint32_t pass = 0; pass < 2; ++pass) {
+        for (uint32_t v = 0; v < sizeof(VOICE_COUNTS) / sizeof(VOICE_COUNTS[0]); ++v) {
+            for (uint32_t worker_count = 1; worker_count <= free_cores; ++worker_count) {
+                run(allocator, worker_count, pass == 1, VOICE_COUNTS[v]);
+            }
+        }
+    }
+
+    memory_globals::shutdown();
+    return 0;
+}
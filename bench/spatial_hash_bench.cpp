@@ -0,0 +1,142 @@
+// Benchmark of the spatial hash at 1k, 10k and 100k entities.
+//
+// Entities are spread at the same density at every size, so a query finds
+// about the same number of neighbours and only the cost of the structure
+// grows. Radius queries are compared with a linear scan of the entities.
+
+#include "bench.h"
+#include "entities.h"
+#include "spatial_hash.h"
+
+#include <array.h>
+#include <memory.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+using namespace foundation;
+
+namespace {
+
+constexpr uint32_t ENTITY_COUNTS[] = {1000, 10000, 100000};
+constexpr float AREA_PER_ENTITY = 64.0f;
+constexpr float CELL_SIZE = 16.0f;
+constexpr float QUERY_RADIUS = 16.0f;
+constexpr uint32_t QUERY_COUNT = 1000;
+constexpr uint32_t BUILDS = 100;
+
+uint32_t xorshift(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float random_coord(uint32_t &state, float extent) {
+    return (float)(xorshift(state) % 65536) / 65536.0f * extent;
+}
+
+void run(Allocator &allocator, uint32_t entity_count) {
+    const float extent = sqrtf((float)entity_count * AREA_PER_ENTITY);
+    uint32_t rng = 0x9e3779b9u;
+
+    plop::Entities entities(allocator);
+    plop::entities::reserve(entities, entity_count);
+    for (uint32_t i = 0; i < entity_count; ++i) {
+        plop::Entity e = plop::entities::create(entities);
+        plop::entities::set_position(entities, e, glm::vec3{random_coord(rng, extent), random_coord(rng, extent), 0.0f});
+    }
+
+    // Enough buckets for about one cell per bucket.
+    uint32_t bucket_count_log2 = 1;
+    while ((1u << bucket_count_log2) < entity_count * AREA_PER_ENTITY / (CELL_SIZE * CELL_SIZE)) {
+        ++bucket_count_log2;
+    }
+    plop::SpatialHash spatial_hash(allocator, CELL_SIZE, bucket_count_log2);
+
+    char name[128];
+    Array<uint64_t> samples(allocator);
+
+    for (uint32_t i = 0; i < BUILDS; ++i) {
+        uint64_t start = bench::now_ns();
+        plop::spatial_hash::build(spatial_hash, entities);
+        array::push_back(samples, bench::now_ns() - start);
+    }
+    snprintf(name, sizeof(name), "%6u entities: build, median", entity_count);
+    bench::report(name, (double)bench::percentile(samples, 50) / 1000.0, "us");
+
+    Array<glm::vec3> centers(allocator);
+    Array<float> radii(allocator);
+    for (uint32_t i = 0; i < QUERY_COUNT; ++i) {
+        array::push_back(centers, glm::vec3{random_coord(rng, extent), random_coord(rng, extent), 0.0f});
+        array::push_back(radii, QUERY_RADIUS);
+    }
+
+    Array<plop::Entity> results(allocator);
+    array::reserve(results, entity_count);
+    uint64_t found = 0;
+    uint64_t start = bench::now_ns();
+    for (uint32_t i = 0; i < QUERY_COUNT; ++i) {
+        array::clear(results);
+        plop::spatial_hash::query_radius(spatial_hash, centers[i], QUERY_RADIUS, results);
+        found += array::size(results);
+    }
+    snprintf(name, sizeof(name), "%6u entities: query_radius", entity_count);
+    bench::report(name, (double)(bench::now_ns() - start) / QUERY_COUNT, "ns/query");
+
+    uint64_t aabb_found = 0;
+    start = bench::now_ns();
+    for (uint32_t i = 0; i < QUERY_COUNT; ++i) {
+        array::clear(results);
+        glm::vec3 half{QUERY_RADIUS, QUERY_RADIUS, QUERY_RADIUS};
+        plop::spatial_hash::query_aabb(spatial_hash, centers[i] - half, centers[i] + half, results);
+        aabb_found += array::size(results);
+    }
+    snprintf(name, sizeof(name), "%6u entities: query_aabb", entity_count);
+    bench::report(name, (double)(bench::now_ns() - start) / QUERY_COUNT, "ns/query");
+    bench::do_not_optimize(aabb_found);
+
+    Array<uint32_t> offsets(allocator);
+    start = bench::now_ns();
+    plop::spatial_hash::query_radius_batch(spatial_hash, array::begin(centers), array::begin(radii), QUERY_COUNT, results, offsets);
+    snprintf(name, sizeof(name), "%6u entities: query_radius_batch", entity_count);
+    bench::report(name, (double)(bench::now_ns() - start) / QUERY_COUNT, "ns/query");
+
+    // The linear scan that proximity checks would otherwise do.
+    uint64_t scan_found = 0;
+    const float r2 = QUERY_RADIUS * QUERY_RADIUS;
+    const uint32_t n = plop::entities::count(entities);
+    start = bench::now_ns();
+    for (uint32_t i = 0; i < QUERY_COUNT; ++i) {
+        for (uint32_t j = 0; j < n; ++j) {
+            float dx = entities.position_x[j] - centers[i].x;
+            float dy = entities.position_y[j] - centers[i].y;
+            float dz = entities.position_z[j] - centers[i].z;
+            scan_found += (dx * dx + dy * dy + dz * dz <= r2) ? 1 : 0;
+        }
+    }
+    snprintf(name, sizeof(name), "%6u entities: linear scan", entity_count);
+    bench::report(name, (double)(bench::now_ns() - start) / QUERY_COUNT, "ns/query");
+
+    snprintf(name, sizeof(name), "%6u entities: neighbours per query", entity_count);
+    bench::report(name, (double)found / QUERY_COUNT, "entities");
+
+    if (found != scan_found || array::size(results) != found) {
+        printf("error: spatial hash found %llu, batch %u, linear scan %llu\n", (unsigned long long)found, array::size(results), (unsigned long long)scan_found);
+        exit(1);
+    }
+}
+
+} // namespace
+
+int main() {
+    memory_globals::init();
+    Allocator &allocator = memory_globals::default_allocator();
+
+    for (uint32_t entity_count : ENTITY_COUNTS) {
+        run(allocator, entity_count);
+    }
+
+    memory_globals::shutdown();
+    return 0;
+}
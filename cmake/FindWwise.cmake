@@ -15,8 +15,7 @@
 ##########################################################################
 
 ##########################################################################
-#   NOTE: Make sure to set the WWISE_SDK environment variable            #
-#         to the root of the Wwise SDK.                                  #
+#   NOTE: Make sure to set WWISE_SDK to the root of the Wwise SDK.       #
 #                                                                        #
 # Once done, this module will define:                                    #
 #                                                                        #
@@ -30,10 +29,6 @@
 
 include (FindPackageHandleStandardArgs)
 
-if (NOT EXISTS ${WWISE_SDK})
-  message (FATAL_ERROR "'${WWISE_SDK}' does not exist")
-endif()
-
 find_path(Wwise_INCLUDE_DIR
   NAMES "AK/AkWwiseSDKVersion.h"
   PATHS "${WWISE_SDK}/include"
@@ -46,7 +41,16 @@ else()
   set(SDK_BUILD_CONFIG Debug)
 endif()
 
-set (ABI_DIR x64_vc170)
+# The SDK's directory of libraries for the platform.
+if (WIN32)
+  set (ABI_DIR x64_vc170)
+elseif (APPLE)
+  set (ABI_DIR Mac)
+elseif (CMAKE_SYSTEM_PROCESSOR MATCHES "aarch64|arm64")
+  set (ABI_DIR Linux_aarch64)
+else()
+  set (ABI_DIR Linux_x64)
+endif()
 
 set (libNames
   AkAudioInputSource AkCompressorFX AkDelayFX AkExpanderFX AkFlangerFX
@@ -61,11 +65,17 @@ if (CMAKE_BUILD_TYPE MATCHES Release)
   list(FILTER libNames EXCLUDE REGEX "CommunicationCentral")
 endif()
 
-set(SDK_LIB_DIR ${WWISE_SDK}/${ABI_DIR}/${SDK_BUILD_CONFIG}/lib)
+find_path(SDK_LIB_DIR
+  NAMES "${CMAKE_STATIC_LIBRARY_PREFIX}AkSoundEngine${CMAKE_STATIC_LIBRARY_SUFFIX}"
+  PATHS "${WWISE_SDK}/${ABI_DIR}/${SDK_BUILD_CONFIG}/lib"
+  NO_DEFAULT_PATH
+  NO_CMAKE_FIND_ROOT_PATH
+)
 
 foreach(name ${libNames})
   add_library(${name} STATIC IMPORTED)
-  set_property(TARGET ${name} PROPERTY IMPORTED_LOCATION "${SDK_LIB_DIR}/${name}.lib")
+  set_property(TARGET ${name} PROPERTY IMPORTED_LOCATION
+    "${SDK_LIB_DIR}/${CMAKE_STATIC_LIBRARY_PREFIX}${name}${CMAKE_STATIC_LIBRARY_SUFFIX}")
 endforeach()
 
 set(Wwise_LIBRARIES
@@ -95,6 +105,12 @@ if (CMAKE_BUILD_TYPE MATCHES Release)
   list(FILTER Wwise_LIBRARIES EXCLUDE REGEX "CommunicationCentral")
 endif()
 
+# The sound engine's own system dependencies outside of Windows.
+if (UNIX)
+  find_package(Threads REQUIRED)
+  list(APPEND Wwise_LIBRARIES Threads::Threads ${CMAKE_DL_LIBS})
+endif()
+
 # Handle QUIETLY and REQUIRED args and set Wwise_FOUND to true if all libs found
 find_package_handle_standard_args(Wwise
     REQUIRED_VARS
@@ -0,0 +1,154 @@
+# Generates the X-macro table of Wwise names used by src/wwise_names.h.
+#
+# Reads the SoundBank metadata (SoundbanksInfo.xml) for names, IDs and bank
+# membership, and the generated Wwise_IDs.h for the IDs the game code refers to.
+# Every event, game parameter, bank and bus ID in Wwise_IDs.h is emitted as a
+# WWISE_CHECK so the build fails if the two files disagree. The original media
+# files referenced by each event are emitted as WWISE_EVENT_MEDIA.
+#
+# Usage:
+#   cmake -DSOUNDBANKS_INFO=<SoundbanksInfo.xml> -DWWISE_IDS=<Wwise_IDs.h> -DOUTPUT=<wwise_names.inl> -P GenerateWwiseNames.cmake
+
+cmake_minimum_required(VERSION 3.21)
+
+if (NOT EXISTS "${SOUNDBANKS_INFO}")
+    message(FATAL_ERROR "SoundBank metadata '${SOUNDBANKS_INFO}' does not exist")
+endif()
+
+if (NOT EXISTS "${WWISE_IDS}")
+    message(FATAL_ERROR "Wwise IDs header '${WWISE_IDS}' does not exist")
+endif()
+
+file(READ "${SOUNDBANKS_INFO}" xml)
+
+set(kinds Event GameParameter StateGroup SwitchGroup Bus AuxBus)
+set(names "")
+set(bank_lines "")
+set(bank_index 0)
+set(event_media "")
+
+# Walk the <SoundBank> elements one at a time, CMake regexes have no lazy quantifiers.
+string(FIND "${xml}" "<SoundBank " bank_begin)
+while (bank_begin GREATER -1)
+    string(SUBSTRING "${xml}" ${bank_begin} -1 xml)
+    string(FIND "${xml}" "</SoundBank>" bank_end)
+    if (bank_end EQUAL -1)
+        message(FATAL_ERROR "Unterminated <SoundBank> in '${SOUNDBANKS_INFO}'")
+    endif()
+    string(SUBSTRING "${xml}" 0 ${bank_end} bank)
+
+    string(REGEX MATCH "<SoundBank Id=\"([0-9]+)\"" _ "${bank}")
+    set(bank_id ${CMAKE_MATCH_1})
+    string(REGEX MATCH "<ShortName>([^<]+)</ShortName>" _ "${bank}")
+    set(bank_name ${CMAKE_MATCH_1})
+
+    string(APPEND bank_lines "WWISE_BANK(${bank_index}, \"${bank_name}\", ${bank_id}U)\n")
+
+    set(key "Bank_${bank_id}")
+    list(APPEND names ${key})
+    set(name_${key} "${bank_name}")
+    set(id_${key} ${bank_id})
+    set(kind_${key} Bank)
+    set(banks_${key} ${bank_index})
+
+    foreach(kind ${kinds})
+        string(REGEX MATCHALL "<${kind} Id=\"[0-9]+\" Name=\"[^\"]+\"" elements "${bank}")
+        foreach(element ${elements})
+            string(REGEX MATCH "Id=\"([0-9]+)\" Name=\"([^\"]+)\"" _ "${element}")
+            set(key "${kind}_${CMAKE_MATCH_1}")
+            if (NOT DEFINED id_${key})
+                list(APPEND names ${key})
+                set(name_${key} "${CMAKE_MATCH_2}")
+                set(id_${key} ${CMAKE_MATCH_1})
+                set(kind_${key} ${kind})
+                set(banks_${key} "")
+            endif()
+            list(APPEND banks_${key} ${bank_index})
+        endforeach()
+    endforeach()
+
+    string(REGEX MATCHALL "<File Id=\"[0-9]+\"[^>]*>[ \t\r\n]*<ShortName>[^<]+</ShortName>" files "${bank}")
+    foreach(file ${files})
+        string(REGEX MATCH "Id=\"([0-9]+)\"[^>]*>[ \t\r\n]*<ShortName>([^<]+)</ShortName>" _ "${file}")
+        set(media_${CMAKE_MATCH_1} "${CMAKE_MATCH_2}")
+    endforeach()
+
+    string(REGEX MATCHALL "<Event Id=\"[0-9]+\" Name=\"[^\"]+\">[ \t\r\n]*<MediaRefs>([ \t\r\n]*<MediaRef Id=\"[0-9]+\"/>)+" events "${bank}")
+    foreach(event ${events})
+        string(REGEX MATCH "<Event Id=\"([0-9]+)\"" _ "${event}")
+        set(event_id ${CMAKE_MATCH_1})
+        string(REGEX MATCHALL "<MediaRef Id=\"[0-9]+\"" refs "${event}")
+        foreach(ref ${refs})
+            string(REGEX MATCH "[0-9]+" media_id "${ref}")
+            list(APPEND event_media "${event_id}:${media_id}")
+        endforeach()
+    endforeach()
+
+    math(EXPR bank_index "${bank_index} + 1")
+    string(SUBSTRING "${xml}" ${bank_end} -1 xml)
+    string(FIND "${xml}" "<SoundBank " bank_begin)
+endwhile()
+
+if (bank_index GREATER 64)
+    message(FATAL_ERROR "Bank membership is a 64 bit mask, found ${bank_index} banks")
+endif()
+
+set(name_lines "")
+foreach(key ${names})
+    set(mask "")
+    list(REMOVE_DUPLICATES banks_${key})
+    foreach(b ${banks_${key}})
+        if (mask)
+            string(APPEND mask " | ")
+        endif()
+        string(APPEND mask "WWISE_BANK_BIT(${b})")
+    endforeach()
+    string(APPEND name_lines "WWISE_NAME(${kind_${key}}, \"${name_${key}}\", ${id_${key}}U, ${mask})\n")
+endforeach()
+
+# Media may be in another bank than the event, so resolve the names once all banks are read.
+set(media_lines "")
+list(REMOVE_DUPLICATES event_media)
+foreach(pair ${event_media})
+    string(REPLACE ":" ";" pair "${pair}")
+    list(GET pair 0 event_id)
+    list(GET pair 1 media_id)
+    if (DEFINED media_${media_id})
+        string(APPEND media_lines "WWISE_EVENT_MEDIA(${event_id}U, \"${media_${media_id}}\")\n")
+    endif()
+endforeach()
+
+# Every constant in Wwise_IDs.h, grouped by its namespace. Only the groups that are
+# listed per bank in SoundbanksInfo.xml can be checked.
+set(checked_groups EVENTS GAME_PARAMETERS BANKS BUSSES AUX_BUSSES)
+set(kind_of_EVENTS Event)
+set(kind_of_GAME_PARAMETERS GameParameter)
+set(kind_of_BANKS Bank)
+set(kind_of_BUSSES Bus)
+set(kind_of_AUX_BUSSES AuxBus)
+file(STRINGS "${WWISE_IDS}" id_header)
+set(check_lines "")
+set(group "")
+foreach(line ${id_header})
+    if (line MATCHES "namespace ([A-Z_]+)")
+        set(group ${CMAKE_MATCH_1})
+    elseif (group IN_LIST checked_groups AND line MATCHES "static const AkUniqueID ([A-Z0-9_]+) = ")
+        string(APPEND check_lines "WWISE_CHECK(${group}, ${kind_of_${group}}, ${CMAKE_MATCH_1})\n")
+    endif()
+endforeach()
+
+set(content "// Generated by cmake/GenerateWwiseNames.cmake from SoundbanksInfo.xml and Wwise_IDs.h. Do not edit.\n\n")
+string(APPEND content "#if defined(WWISE_BANK)\n${bank_lines}#endif\n\n")
+string(APPEND content "#if defined(WWISE_NAME)\n${name_lines}#endif\n\n")
+string(APPEND content "#if defined(WWISE_EVENT_MEDIA)\n${media_lines}#endif\n\n")
+string(APPEND content "#if defined(WWISE_CHECK)\n${check_lines}#endif\n")
+
+# Only touch the output when it changes, so dependents don't rebuild needlessly.
+if (EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+    if (previous STREQUAL content)
+        return()
+    endif()
+endif()
+
+file(WRITE "${OUTPUT}" "${content}")
@@ -34,7 +34,7 @@ written agreement between you and Audiokinetic Inc.
 #include <stdio.h>
 #include <AK/Tools/Common/AkAssert.h>
 
-#include "../Win32/AkFileHelpers.h"
+#include "AkFileHelpers.h"
 
 #include "AkGeneratedSoundBanksResolver.h"
 
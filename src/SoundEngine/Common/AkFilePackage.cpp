@@ -31,12 +31,18 @@ void CAkFilePackage::Destroy()
 {
 	// Cache memory pointer to ensure memory is free'd _after_ deleting this.
 	void * pToRelease	= m_pToRelease;
+	AkUInt32 uPackageID = m_uPackageID;
+	AkFilePackageCallback pDestroyedCallback = m_pDestroyedCallback;
+	void * pDestroyedCookie = m_pDestroyedCookie;
 
 	// Call destructor.
 	this->~CAkFilePackage();
 
 	// Free memory.
 	ClearMemory(pToRelease);
+
+	if (pDestroyedCallback)
+		pDestroyedCallback(uPackageID, AK_Success, pDestroyedCookie);
 }
 
 void CAkFilePackage::ClearMemory(
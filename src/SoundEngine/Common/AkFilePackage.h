@@ -31,6 +31,14 @@ written agreement between you and Audiokinetic Inc.
 #include <AK/SoundEngine/Common/AkSoundEngine.h>
 #include <AK/Tools/Common/AkObject.h>
 #include <AK/Tools/Common/AkListBare.h>
+#include <AK/Tools/Common/AkAtomic.h>
+
+// Called when a package is loaded or destroyed (see CAkFilePackageLowLevelIO::LoadFilePackageAsync()).
+typedef void (*AkFilePackageCallback)(
+	AkUInt32		in_uPackageID,		// Package ID, AK_INVALID_UNIQUE_ID if it could not be loaded.
+	AKRESULT		in_eResult,			// Result of the operation.
+	void *			in_pCookie			// Cookie passed with the callback.
+	);
 
 //-----------------------------------------------------------------------------
 // Name: Base class for items that can be chained in AkListBareLight lists.
@@ -102,19 +110,26 @@ public:
 	// Getters.
 	inline AkUInt32 ID() { return m_uPackageID; }
 	inline AkUInt32 HeaderSize() { return m_uHeaderSize; }
+	// References are held by the package list, snapshots and file descriptors, on any thread.
 	inline void AddRef() 
 	{ 
-		m_uRefCount++;
+		AkAtomicInc32(&m_iRefCount);
 	}
 	inline void Release() 
 	{ 		
-		m_uRefCount--;
-		if (m_uRefCount == 0)
+		if (AkAtomicDec32(&m_iRefCount) == 0)
 		{
 			Destroy();
 		}
 	}
 
+	// Sets a callback to call once the package is destroyed, after the last reference is released.
+	inline void SetDestroyedCallback( AkFilePackageCallback in_pCallback, void * in_pCookie )
+	{
+		m_pDestroyedCallback = in_pCallback;
+		m_pDestroyedCookie = in_pCookie;
+	}
+
 	// Members.
 	// ------------------------------
 	CAkFilePackageLUT	lut;		// Package look-up table.
@@ -130,7 +145,9 @@ protected:
 		: m_uPackageID(in_uPackageID)
 		, m_uHeaderSize(in_uHeaderSize)
 		, m_pToRelease(in_pToRelease)
-		, m_uRefCount(1)
+		, m_iRefCount(1)
+		, m_pDestroyedCallback(NULL)
+		, m_pDestroyedCookie(NULL)
 	{
 	}
 	virtual ~CAkFilePackage() {}
@@ -145,7 +162,9 @@ protected:
 
 protected:
 	void *				m_pToRelease;	// LUT storage (only keep this pointer to release memory).
-	AkUInt32			m_uRefCount;	// Reference count
+	AkAtomic32			m_iRefCount;	// Reference count
+	AkFilePackageCallback m_pDestroyedCallback;
+	void *				m_pDestroyedCookie;
 };
 
 //-----------------------------------------------------------------------------
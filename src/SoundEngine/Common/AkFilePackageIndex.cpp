@@ -0,0 +1,244 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkFilePackageIndex.cpp
+//
+// Index of the files of all loaded packages.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AkFilePackageIndex.h"
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+
+// Files that soundbank look-ups search in a package. Like CAkFilePackageLUT::LookupFile(), they fall
+// back to the streamed files when the package has no soundbank LUT.
+static const CAkFilePackageLUT::AkFileEntry<AkFileID> * GetBankLookupFiles(
+	const CAkFilePackageLUT &	in_lut,
+	AkUInt32 &					out_uNumFiles
+	)
+{
+	const CAkFilePackageLUT::AkFileEntry<AkFileID> * pBanks = in_lut.GetSoundBanks( out_uNumFiles );
+	return pBanks ? pBanks : in_lut.GetStmFiles( out_uNumFiles );
+}
+
+CAkFilePackageIndex::CAkFilePackageIndex()
+	: m_bValid( false )
+{
+}
+
+CAkFilePackageIndex::~CAkFilePackageIndex()
+{
+	Clear();
+}
+
+AKRESULT CAkFilePackageIndex::Build(
+	const ListFilePackages &	in_packages		// Loaded packages.
+	)
+{
+	Clear();
+
+	// Size the tables.
+	AkUInt32 uNumBanks = 0, uNumStmFiles = 0, uNumExternals = 0;
+	for ( ListFilePackages::Iterator it = in_packages.Begin(); it != in_packages.End(); ++it )
+	{
+		const CAkFilePackageLUT & lut = (*it)->lut;
+		AkUInt16 uLangID = lut.GetCurLanguageID();
+		AkUInt32 uNumFiles;
+		const CAkFilePackageLUT::AkFileEntry<AkFileID> * pBanks = GetBankLookupFiles( lut, uNumFiles );
+		uNumBanks += Table<AkFileID>::CountKeys( pBanks, uNumFiles, uLangID );
+		const CAkFilePackageLUT::AkFileEntry<AkFileID> * pStmFiles = lut.GetStmFiles( uNumFiles );
+		uNumStmFiles += Table<AkFileID>::CountKeys( pStmFiles, uNumFiles, uLangID );
+		const CAkFilePackageLUT::AkFileEntry<AkUInt64> * pExternals = lut.GetExternals( uNumFiles );
+		uNumExternals += Table<AkUInt64>::CountKeys( pExternals, uNumFiles, uLangID );
+	}
+
+	if ( !m_soundBanks.Alloc( uNumBanks )
+		|| !m_stmFiles.Alloc( uNumStmFiles )
+		|| !m_externals.Alloc( uNumExternals ) )
+	{
+		Clear();
+		return AK_InsufficientMemory;
+	}
+
+	// Fill them from the highest priority package to the lowest: the first entry of a key wins.
+	for ( ListFilePackages::Iterator it = in_packages.Begin(); it != in_packages.End(); ++it )
+	{
+		const CAkFilePackageLUT & lut = (*it)->lut;
+		AkUInt16 uLangID = lut.GetCurLanguageID();
+		AkUInt32 uNumFiles;
+		const CAkFilePackageLUT::AkFileEntry<AkFileID> * pBanks = GetBankLookupFiles( lut, uNumFiles );
+		m_soundBanks.Insert( pBanks, uNumFiles, uLangID, *it );
+		const CAkFilePackageLUT::AkFileEntry<AkFileID> * pStmFiles = lut.GetStmFiles( uNumFiles );
+		m_stmFiles.Insert( pStmFiles, uNumFiles, uLangID, *it );
+		const CAkFilePackageLUT::AkFileEntry<AkUInt64> * pExternals = lut.GetExternals( uNumFiles );
+		m_externals.Insert( pExternals, uNumFiles, uLangID, *it );
+	}
+
+	m_bValid = true;
+	return AK_Success;
+}
+
+void CAkFilePackageIndex::Clear()
+{
+	m_soundBanks.Free();
+	m_stmFiles.Free();
+	m_externals.Free();
+	m_bValid = false;
+}
+
+const CAkFilePackageLUT::AkFileEntry<AkFileID> * CAkFilePackageIndex::LookupFile(
+	AkFileID			in_uID,			// File ID.
+	AkFileSystemFlags * in_pFlags,		// Special flags. Do not pass NULL.
+	CAkFilePackage *&	out_pPackage	// Returned package.
+	) const
+{
+	AKASSERT( m_bValid && in_pFlags && in_pFlags->uCompanyID == AKCOMPANYID_AUDIOKINETIC );
+
+	const Table<AkFileID> & table = AK::IsBankCodecID( in_pFlags->uCodecID ) ? m_soundBanks : m_stmFiles;
+	const Table<AkFileID>::Slot * pSlot = table.Find( in_uID, in_pFlags->bIsLanguageSpecific );
+	if ( !pSlot )
+		return NULL;
+
+	out_pPackage = pSlot->pPackage;
+	return pSlot->pEntry;
+}
+
+const CAkFilePackageLUT::AkFileEntry<AkUInt64> * CAkFilePackageIndex::LookupFile(
+	AkUInt64			in_uID,			// File ID.
+	AkFileSystemFlags * in_pFlags,		// Special flags. Do not pass NULL.
+	CAkFilePackage *&	out_pPackage	// Returned package.
+	) const
+{
+	AKASSERT( m_bValid && in_pFlags );
+
+	if ( in_pFlags->uCompanyID != AKCOMPANYID_AUDIOKINETIC_EXTERNAL )
+		return NULL;
+
+	const Table<AkUInt64>::Slot * pSlot = m_externals.Find( in_uID, in_pFlags->bIsLanguageSpecific );
+	if ( !pSlot )
+		return NULL;
+
+	out_pPackage = pSlot->pPackage;
+	return pSlot->pEntry;
+}
+
+template <class T_FILEID>
+AkUInt32 CAkFilePackageIndex::Table<T_FILEID>::CountKeys(
+	const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntries,
+	AkUInt32			in_uNumFiles,
+	AkUInt16			in_uLangID
+	)
+{
+	AkUInt32 uNumKeys = 0;
+	for ( AkUInt32 i = 0; i < in_uNumFiles; ++i )
+	{
+		if ( in_pEntries[i].uLanguageID == CAkFilePackageLUT::AK_INVALID_LANGUAGE_ID )
+			++uNumKeys;
+		if ( in_pEntries[i].uLanguageID == in_uLangID )
+			++uNumKeys;
+	}
+	return uNumKeys;
+}
+
+template <class T_FILEID>
+bool CAkFilePackageIndex::Table<T_FILEID>::Alloc( AkUInt32 in_uNumKeys )
+{
+	AKASSERT( !pSlots );
+	if ( in_uNumKeys == 0 )
+		return true;
+
+	// Keep the load factor at or below 1/2 so that probe sequences stay short.
+	AkUInt32 uNumSlots = 1;
+	while ( uNumSlots < in_uNumKeys * 2 )
+		uNumSlots <<= 1;
+
+	pSlots = (Slot*)AkAlloc( AkMemID_FilePackage, uNumSlots * sizeof( Slot ) );
+	if ( !pSlots )
+		return false;
+	memset( (void*)pSlots, 0, uNumSlots * sizeof( Slot ) );
+	uMask = uNumSlots - 1;
+	return true;
+}
+
+template <class T_FILEID>
+void CAkFilePackageIndex::Table<T_FILEID>::Free()
+{
+	if ( pSlots )
+		AkFree( AkMemID_FilePackage, pSlots );
+	pSlots = NULL;
+	uMask = 0;
+}
+
+template <class T_FILEID>
+void CAkFilePackageIndex::Table<T_FILEID>::Insert(
+	const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntries,
+	AkUInt32			in_uNumFiles,
+	AkUInt16			in_uLangID,
+	CAkFilePackage *	in_pPackage
+	)
+{
+	// Same rule as CAkFilePackageLUT::LookupFile(): language-specific look-ups match the current
+	// language of the package, other look-ups match the files that are not language-specific.
+	for ( AkUInt32 i = 0; i < in_uNumFiles; ++i )
+	{
+		if ( in_pEntries[i].uLanguageID == CAkFilePackageLUT::AK_INVALID_LANGUAGE_ID )
+			Insert( in_pEntries[i].fileID, false, in_pEntries + i, in_pPackage );
+		if ( in_pEntries[i].uLanguageID == in_uLangID )
+			Insert( in_pEntries[i].fileID, true, in_pEntries + i, in_pPackage );
+	}
+}
+
+template <class T_FILEID>
+void CAkFilePackageIndex::Table<T_FILEID>::Insert(
+	T_FILEID			in_fileID,
+	bool				in_bIsLanguageSpecific,
+	const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntry,
+	CAkFilePackage *	in_pPackage
+	)
+{
+	AKASSERT( pSlots );
+	AkUInt32 uSlot = CAkFilePackageLUT::FileKeySlot<T_FILEID>( in_fileID, in_bIsLanguageSpecific, uMask );
+	while ( pSlots[ uSlot ].pEntry )
+	{
+		if ( pSlots[ uSlot ].fileID == in_fileID && pSlots[ uSlot ].bIsLanguageSpecific == (AkUInt32)in_bIsLanguageSpecific )
+			return;	// Already provided by a package of higher priority.
+		uSlot = ( uSlot + 1 ) & uMask;
+	}
+
+	pSlots[ uSlot ].fileID = in_fileID;
+	pSlots[ uSlot ].bIsLanguageSpecific = in_bIsLanguageSpecific;
+	pSlots[ uSlot ].pEntry = in_pEntry;
+	pSlots[ uSlot ].pPackage = in_pPackage;
+}
+
+template <class T_FILEID>
+const typename CAkFilePackageIndex::Table<T_FILEID>::Slot * CAkFilePackageIndex::Table<T_FILEID>::Find(
+	T_FILEID			in_fileID,
+	bool				in_bIsLanguageSpecific
+	) const
+{
+	if ( !pSlots )
+		return NULL;
+
+	// Probe until the key or an empty slot is found. The table is never more than half full.
+	AkUInt32 uSlot = CAkFilePackageLUT::FileKeySlot<T_FILEID>( in_fileID, in_bIsLanguageSpecific, uMask );
+	while ( pSlots[ uSlot ].pEntry )
+	{
+		if ( pSlots[ uSlot ].fileID == in_fileID && pSlots[ uSlot ].bIsLanguageSpecific == (AkUInt32)in_bIsLanguageSpecific )
+			return pSlots + uSlot;
+		uSlot = ( uSlot + 1 ) & uMask;
+	}
+	return NULL;
+}
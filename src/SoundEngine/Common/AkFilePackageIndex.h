@@ -0,0 +1,114 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkFilePackageIndex.h
+//
+// Index of the files of all loaded packages, used by CAkFilePackageLowLevelIO
+// to find a packaged file with a single look-up, however many packages are
+// loaded.
+//
+// Each file ID maps to the entry of the package that has the highest priority,
+// that is the first package of the list that contains it: packages loaded last
+// come first, so that patches and DLC override the files of the base game.
+// Language-specific look-ups are resolved with the current language of each
+// package, so the index must be rebuilt when packages are loaded or unloaded,
+// and when the language changes. Soundbank look-ups search the streamed files
+// of the packages that have no soundbank LUT, as CAkFilePackageLUT does.
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef _AK_FILE_PACKAGE_INDEX_H_
+#define _AK_FILE_PACKAGE_INDEX_H_
+
+#include "AkFilePackage.h"
+
+//-----------------------------------------------------------------------------
+// Name: class CAkFilePackageIndex.
+// Desc: Open addressing hash tables on (file ID, language-specific flag) for the
+// soundbanks, streamed files and external sources of a list of packages.
+//-----------------------------------------------------------------------------
+class CAkFilePackageIndex
+{
+public:
+	CAkFilePackageIndex();
+	~CAkFilePackageIndex();
+
+	// (Re)builds the index from a list of packages, sorted from highest to lowest priority.
+	// Returns AK_InsufficientMemory if the tables could not be allocated: the index is then
+	// invalid, and files must be searched package by package.
+	AKRESULT Build(
+		const ListFilePackages &	in_packages		// Loaded packages.
+		);
+
+	// Frees the tables. The index is invalid until the next Build().
+	void Clear();
+
+	inline bool IsValid() const { return m_bValid; }
+
+	// Find a file entry by ID, and the package that contains it.
+	// The result is the same as searching the LUT of each package in order.
+	const CAkFilePackageLUT::AkFileEntry<AkFileID> * LookupFile(
+		AkFileID			in_uID,				// File ID.
+		AkFileSystemFlags * in_pFlags,			// Special flags. Do not pass NULL.
+		CAkFilePackage *&	out_pPackage		// Returned package.
+		) const;
+
+	// Find a file entry by ID with 64 bit ID.
+	const CAkFilePackageLUT::AkFileEntry<AkUInt64> * LookupFile(
+		AkUInt64			in_uID,				// File ID.
+		AkFileSystemFlags * in_pFlags,			// Special flags. Do not pass NULL.
+		CAkFilePackage *&	out_pPackage		// Returned package.
+		) const;
+
+private:
+
+	template <class T_FILEID>
+	struct Table
+	{
+		struct Slot
+		{
+			T_FILEID		fileID;
+			AkUInt32		bIsLanguageSpecific;	// Key is (fileID, bIsLanguageSpecific).
+			const CAkFilePackageLUT::AkFileEntry<T_FILEID> * pEntry;	// NULL if the slot is empty.
+			CAkFilePackage * pPackage;
+		};
+
+		Table() : pSlots( NULL ), uMask( 0 ) {}
+
+		// Number of keys that a package adds: shared files can be opened both as
+		// language-specific and not when the package has no current language.
+		static AkUInt32 CountKeys( const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntries, AkUInt32 in_uNumFiles, AkUInt16 in_uLangID );
+
+		// Allocates the slots for in_uNumKeys keys. Returns false if out of memory.
+		bool Alloc( AkUInt32 in_uNumKeys );
+		void Free();
+
+		// Adds the keys of a package that are not already in the table.
+		void Insert( const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntries, AkUInt32 in_uNumFiles, AkUInt16 in_uLangID, CAkFilePackage * in_pPackage );
+		void Insert( T_FILEID in_fileID, bool in_bIsLanguageSpecific, const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntry, CAkFilePackage * in_pPackage );
+
+		const Slot * Find( T_FILEID in_fileID, bool in_bIsLanguageSpecific ) const;
+
+		Slot *		pSlots;		// NULL if the table is empty.
+		AkUInt32	uMask;		// Number of slots - 1. The number of slots is a power of two.
+	};
+
+	Table<AkFileID>		m_soundBanks;
+	Table<AkFileID>		m_stmFiles;
+	Table<AkUInt64>		m_externals;
+	bool				m_bValid;
+};
+
+#endif //_AK_FILE_PACKAGE_INDEX_H_
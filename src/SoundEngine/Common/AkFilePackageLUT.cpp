@@ -61,6 +61,51 @@ CAkFilePackageLUT::CAkFilePackageLUT()
 
 CAkFilePackageLUT::~CAkFilePackageLUT()
 {
+	ClearIndex( m_soundBanksIndex );
+	ClearIndex( m_stmFilesIndex );
+	ClearIndex( m_externalsIndex );
+}
+
+template <class T_FILEID>
+void CAkFilePackageLUT::BuildIndex(
+	const FileLUT<T_FILEID> *	in_pLut,		// LUT to index.
+	FileIndex &					io_index		// Returned index.
+	)
+{
+	ClearIndex( io_index );
+	if ( !in_pLut->HasFiles() )
+		return;
+
+	// Keep the load factor at or below 1/2 so that probe sequences stay short.
+	AkUInt32 uNumSlots = 1;
+	while ( uNumSlots < in_pLut->NumFiles() * 2 )
+		uNumSlots <<= 1;
+
+	AkUInt32 * pSlots = (AkUInt32*)AkAlloc( AkMemID_FilePackage, uNumSlots * sizeof( AkUInt32 ) );
+	if ( !pSlots )
+		return;	// Look-ups fall back to the binary search.
+	memset( pSlots, 0, uNumSlots * sizeof( AkUInt32 ) );
+
+	const AkFileEntry<T_FILEID> * pTable = in_pLut->FileEntries();
+	const AkUInt32 uMask = uNumSlots - 1;
+	for ( AkUInt32 uEntry = 0; uEntry < in_pLut->NumFiles(); ++uEntry )
+	{
+		AkUInt32 uSlot = FileKeySlot<T_FILEID>( pTable[ uEntry ].fileID, pTable[ uEntry ].uLanguageID, uMask );
+		while ( pSlots[ uSlot ] )
+			uSlot = ( uSlot + 1 ) & uMask;
+		pSlots[ uSlot ] = uEntry + 1;
+	}
+
+	io_index.pSlots = pSlots;
+	io_index.uMask = uMask;
+}
+
+void CAkFilePackageLUT::ClearIndex( FileIndex & io_index )
+{
+	if ( io_index.pSlots )
+		AkFree( AkMemID_FilePackage, io_index.pSlots );
+	io_index.pSlots = NULL;
+	io_index.uMask = 0;
 }
 
 // Create a new LUT from a packaged file header.
@@ -109,6 +154,11 @@ AKRESULT CAkFilePackageLUT::Setup(
 
 	m_pExternals	= (FileLUT<AkUInt64>*)in_pData;
 
+	// Index the LUTs. Entries are hashed on their file ID and language ID, which are unique together.
+	BuildIndex<AkFileID>( m_pSoundBanks, m_soundBanksIndex );
+	BuildIndex<AkFileID>( m_pStmFiles, m_stmFilesIndex );
+	BuildIndex<AkUInt64>( m_pExternals, m_externalsIndex );
+
 	return AK_Success;
 }
 
@@ -124,12 +174,12 @@ const CAkFilePackageLUT::AkFileEntry<AkFileID> * CAkFilePackageLUT::LookupFile(
 		&& m_pSoundBanks
 		&& m_pSoundBanks->HasFiles() )
 	{
-		return LookupFile<AkFileID>( in_uID, m_pSoundBanks, in_pFlags->bIsLanguageSpecific );
+		return LookupFile<AkFileID>( in_uID, m_pSoundBanks, m_soundBanksIndex, in_pFlags->bIsLanguageSpecific );
 	}
 	else if ( m_pStmFiles && m_pStmFiles->HasFiles() )
 	{
 		// We assume that the file is a streamed audio file.
-		return LookupFile<AkFileID>( in_uID, m_pStmFiles, in_pFlags->bIsLanguageSpecific );
+		return LookupFile<AkFileID>( in_uID, m_pStmFiles, m_stmFilesIndex, in_pFlags->bIsLanguageSpecific );
 	}
 	// No table loaded.
 	return NULL;
@@ -147,7 +197,7 @@ const CAkFilePackageLUT::AkFileEntry<AkUInt64> * CAkFilePackageLUT::LookupFile(
 		&& m_pExternals 
 		&& m_pExternals->HasFiles() )
 	{
-		return LookupFile<AkUInt64>( in_uID, m_pExternals, in_pFlags->bIsLanguageSpecific );
+		return LookupFile<AkUInt64>( in_uID, m_pExternals, m_externalsIndex, in_pFlags->bIsLanguageSpecific );
 	}
 
 	// No table loaded.
@@ -22,6 +22,8 @@ written agreement between you and Audiokinetic Inc.
 // The header of these file packages contains look-up tables that describe the 
 // internal offset of each file it references, their block size (required alignment), 
 // and their language. Each combination of AkFileID and Language ID is unique.
+// Setup() builds a hash index of each table on the side, so that a look-up is
+// usually a single probe; the header data itself is not modified.
 //
 // The language was created dynamically when the package was created. The header 
 // also contains a map of language names (strings) to their ID, so that the proper 
@@ -72,6 +74,10 @@ public:
     CAkFilePackageLUT();
     virtual ~CAkFilePackageLUT();
 
+	// Not copyable: the LUT owns the memory of its indexes.
+	CAkFilePackageLUT( const CAkFilePackageLUT & ) = delete;
+	CAkFilePackageLUT & operator=( const CAkFilePackageLUT & ) = delete;
+
 	// Create a new LUT from a packaged file header.
 	// The LUT sets pointers to appropriate location inside header data (in_pData).
 	AKRESULT Setup(
@@ -99,15 +105,33 @@ public:
 		);
 
 	// Find a soundbank ID by its name (by hashing its name)
-	AkFileID GetSoundBankID( 
+	static AkFileID GetSoundBankID( 
 		const AkOSChar*			in_pszBankName		// Soundbank name.
 		);
 
     // Return the id of an external file (by hashing its name in 64 bits)
-	AkUInt64 GetExternalID( 
+	static AkUInt64 GetExternalID( 
 		const AkOSChar*			in_pszExternalName		// External Source name.
 		);	
 
+	// Access to the LUTs and to the current language, to index the files of several packages together
+	// (see CAkFilePackageIndex). Return NULL if the table is empty.
+	const AkFileEntry<AkFileID> * GetSoundBanks( AkUInt32 & out_uNumFiles ) const { return GetFiles<AkFileID>( m_pSoundBanks, out_uNumFiles ); }
+	const AkFileEntry<AkFileID> * GetStmFiles( AkUInt32 & out_uNumFiles ) const { return GetFiles<AkFileID>( m_pStmFiles, out_uNumFiles ); }
+	const AkFileEntry<AkUInt64> * GetExternals( AkUInt32 & out_uNumFiles ) const { return GetFiles<AkUInt64>( m_pExternals, out_uNumFiles ); }
+	inline AkUInt16 GetCurLanguageID() const { return m_curLangID; }
+
+	// Home slot of a (file ID, language ID) pair in an open addressing table of in_uMask + 1 slots, a power of two.
+	template <class T_FILEID>
+	static AkForceInline AkUInt32 FileKeySlot( T_FILEID in_uID, AkUInt32 in_uLangID, AkUInt32 in_uMask )
+	{
+		// Fibonacci hashing: the slot is the top bits of the product, which every bit of the key reaches, so the
+		// language in the high bits spreads localized variants of a file as well as the file ID does.
+		AkUInt64 uKey = (AkUInt64)in_uID ^ ( (AkUInt64)in_uLangID << 48 );
+		AkUInt64 uHash = ( uKey * 0x9E3779B97F4A7C15ULL ) >> 32;
+		return (AkUInt32)( ( uHash * ( (AkUInt64)in_uMask + 1 ) ) >> 32 );
+	}
+
 protected:
 	static void RemoveFileExtension( AkOSChar* in_pstring );
 	static void _MakeLower( AkOSChar* in_pString );
@@ -131,11 +155,40 @@ protected:
 		AkUInt32		m_uNumFiles;
 	};
 
+	//
+	// File LUT indexes.
+	// Open addressing hash table on (file ID, language ID), with linear probing.
+	// Each slot holds the position of an entry in the LUT + 1, or 0 if it is empty.
+	//
+	struct FileIndex
+	{
+		FileIndex() : pSlots( NULL ), uMask( 0 ) {}
+		AkUInt32 *		pSlots;		// NULL if the table has no index: look-ups use a binary search.
+		AkUInt32		uMask;		// Number of slots - 1. The number of slots is a power of two.
+	};
+
+	// Helper: Build the index of a LUT. Leaves io_index empty if the LUT has no files or if memory is not available.
+	template <class T_FILEID>
+	static void BuildIndex(
+		const FileLUT<T_FILEID> *	in_pLut,				// LUT to index.
+		FileIndex &					io_index				// Returned index.
+		);
+
+	static void ClearIndex( FileIndex & io_index );
+
+	template <class T_FILEID>
+	static const AkFileEntry<T_FILEID> * GetFiles( const FileLUT<T_FILEID> * in_pLut, AkUInt32 & out_uNumFiles )
+	{
+		out_uNumFiles = ( in_pLut && in_pLut->HasFiles() ) ? in_pLut->NumFiles() : 0;
+		return out_uNumFiles ? in_pLut->FileEntries() : NULL;
+	}
+
 	// Helper: Find a file entry by ID.
 	template <class T_FILEID>
 	const AkFileEntry<T_FILEID> * LookupFile(
 		T_FILEID					in_uID,					// File ID.
 		const FileLUT<T_FILEID> *	in_pLut,				// LUT to search.
+		const FileIndex &			in_index,				// Index of in_pLut.
 		bool						in_bIsLanguageSpecific	// True: match language ID.
 		);
 
@@ -175,6 +228,11 @@ private:
 
 	// External Sources LUT.
     FileLUT<AkUInt64> *			m_pExternals;
+
+	// Indexes of the LUTs above.
+	FileIndex			m_soundBanksIndex;
+	FileIndex			m_stmFilesIndex;
+	FileIndex			m_externalsIndex;
 };
 
 // Helper: Find a file entry by ID.
@@ -182,6 +240,7 @@ template <class T_FILEID>
 const CAkFilePackageLUT::AkFileEntry<T_FILEID> * CAkFilePackageLUT::LookupFile(
 	T_FILEID					in_uID,					// File ID.
 	const FileLUT<T_FILEID> *	in_pLut,				// LUT to search.
+	const FileIndex &			in_index,				// Index of in_pLut.
 	bool						in_bIsLanguageSpecific	// True: match language ID.
 	)
 {
@@ -190,6 +249,20 @@ const CAkFilePackageLUT::AkFileEntry<T_FILEID> * CAkFilePackageLUT::LookupFile(
 	AKASSERT( pTable && in_pLut->HasFiles() );
 	AkUInt16 uLangID = in_bIsLanguageSpecific ? m_curLangID : AK_INVALID_LANGUAGE_ID;
 
+	if ( in_index.pSlots )
+	{
+		// Probe until the entry or an empty slot is found. The table is never more than half full.
+		AkUInt32 uSlot = FileKeySlot<T_FILEID>( in_uID, uLangID, in_index.uMask );
+		while ( in_index.pSlots[ uSlot ] )
+		{
+			const AkFileEntry<T_FILEID> * pEntry = pTable + in_index.pSlots[ uSlot ] - 1;
+			if ( pEntry->fileID == in_uID && pEntry->uLanguageID == uLangID )
+				return pEntry;
+			uSlot = ( uSlot + 1 ) & in_index.uMask;
+		}
+		return NULL;
+	}
+
 	// Binary search. LUT items should be sorted by fileID, then by language ID.
 	AkInt32 uTop = 0, uBottom = in_pLut->NumFiles()-1;
 	do
@@ -34,7 +34,13 @@ written agreement between you and Audiokinetic Inc.
 //
 // LoadFilePackage() returns a package ID that can be used to unload it. Any number
 // of packages can be loaded simultaneously. When Open() is called, the last package 
-// loaded is searched first, then the previous one, and so on.
+// loaded is searched first, then the previous one, and so on. The files of all
+// loaded packages are indexed together (see CAkFilePackageIndex), so that this
+// search is a single look-up.
+//
+// Look-ups do not lock: they use the current snapshot of the packages (see
+// CAkFilePackageSnapshot), which is replaced when packages are loaded or unloaded,
+// or when the language changes. Only these changes take the lock.
 //
 // The language ID was created dynamically when the package was created. The header 
 // also contains a map of language names (strings) to their ID, so that the proper 
@@ -43,7 +49,8 @@ written agreement between you and Audiokinetic Inc.
 // except for the trailing slash.
 //
 // The type of package is also a template argument. By default, it is a disk package
-// (see AkDiskPackage.h).
+// (see CAkDiskPackage below). CAkMappedPackage (see AkMappedPackage.h) maps the
+// package file in memory instead, and completes reads with a copy.
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -51,9 +58,12 @@ written agreement between you and Audiokinetic Inc.
 #define _AK_FILE_PACKAGE_LOW_LEVEL_IO_H_
 
 #include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
 #include "AkFilePackage.h"
+#include "AkFilePackageSnapshot.h"
 #include <AK/Tools/Common/AkAutoLock.h>
 #include <AK/Tools/Common/AkLock.h>
+#include <AK/Tools/Common/AkPlatformFuncs.h>
 
 //-----------------------------------------------------------------------------
 // Name: AkFilePackageReader 
@@ -223,6 +233,11 @@ public:
 
 	AkFileDesc* GetFileDesc() {return m_reader.GetFileDesc();}
 
+	// Disk packages are read through the low-level I/O hook, and have no view of their files in memory.
+	inline bool ReadMapped( AkAsyncIOTransferInfo & /*io_transferInfo*/ ) { return false; }
+	inline const AkUInt8 * GetView( AkUInt64 /*in_uOffset*/, AkUInt64 /*in_uSize*/ ) const { return NULL; }
+	inline void AdviseOpen( AkUInt64 /*in_uOffset*/, AkUInt64 /*in_uSize*/ ) {}
+
 protected:
 	
 	AkFilePackageReader	m_reader;	// READER object. Holds the stream used to read the package. Closed only upon package destruction.
@@ -268,8 +283,8 @@ public:
 	// Returns AK_Success if successful, AK_InvalidLanguage if the current language 
 	// does not exist in the LUT (not necessarily an error), AK_Fail for any other reason.
 	// Also returns a package ID which can be used to unload it (see UnloadFilePackage()).
-	// WARNING: This method is not thread safe. Ensure there are no I/O occurring on this device
-	// when loading a file package.
+	// Files can be opened on this device meanwhile, but this call blocks until the header is read:
+	// use LoadFilePackageAsync() during gameplay.
     virtual AKRESULT LoadFilePackage(
         const AkOSChar* in_pszFilePackageName,	// File package name. Location is resolved using base class' Open().
 		AkUInt32 &		out_uPackageID			// Returned package ID.
@@ -277,24 +292,82 @@ public:
 	
 	// Unload a file package.
 	// Returns AK_Success if in_uPackageID exists, AK_Fail otherwise.
-	// WARNING: This method is not thread safe. Ensure there are no I/O occurring on this device
-	// when unloading a file package.
+	// The package cannot be found by Open() anymore when this returns. Files that are already open
+	// keep it alive: it is destroyed when the last one is closed.
 	virtual AKRESULT UnloadFilePackage( 
 		AkUInt32	in_uPackageID			// Returned package ID.
 		);
 
 	// Unload all file packages.
 	// Returns AK_Success;
-	// WARNING: This method is not thread safe. Ensure there are no I/O occurring on this device
-	// when unloading a file package.
+	// Same as UnloadFilePackage() for each package.
     virtual AKRESULT UnloadAllFilePackages();
 
+	// Asynchronous file package loading:
+	// Queues the package to be loaded by a thread of this device, and returns right away.
+	// The header is read at the lowest priority, so that streams being played are served first, and
+	// the package is published to Open() at once: look-ups never wait for it.
+	// in_pCallback is called from the loading thread with the package ID and the result of LoadFilePackage(),
+	// or AK_Cancelled if the device is terminated first.
+	// Returns AK_InsufficientMemory or AK_Fail if the request could not be queued; in_pCallback is not called then.
+	AKRESULT LoadFilePackageAsync(
+		const AkOSChar*			in_pszFilePackageName,	// File package name. Location is resolved using base class' Open().
+		AkFilePackageCallback	in_pCallback,			// Called when the package is loaded.
+		void*					in_pCookie				// Passed to in_pCallback.
+		);
+
+	// Asynchronous file package unloading:
+	// Same as UnloadFilePackage(), but in_pCallback is called once the package is destroyed, after the last
+	// file opened from it is closed. It is called from the thread that drops the last reference to the package:
+	// - the thread that closes that file;
+	// - a streaming thread that was looking up a file when the package was unloaded: it releases the snapshot
+	//   of the packages it searched at the end of Open() (FindInPackages()), and with it the package;
+	// - or this call, if no file is open and no look-up is in progress.
+	// The first two hold up streaming until in_pCallback returns: keep it short, and do not block in it.
+	// Returns AK_IDNotFound if in_uPackageID does not exist; in_pCallback is not called then.
+	AKRESULT UnloadFilePackageAsync(
+		AkUInt32				in_uPackageID,			// Package ID.
+		AkFilePackageCallback	in_pCallback,			// Called when the package is destroyed.
+		void*					in_pCookie				// Passed to in_pCallback.
+		);
+
+	// Timings of asynchronous package loading, since this object was created.
+	struct MountStats
+	{
+		AkUInt64	uMounts;					// Packages loaded by LoadFilePackageAsync(), successfully or not.
+		AkUInt64	uLastMountUSec;				// Time from the request to the callback, for the last one.
+		AkUInt64	uMaxMountUSec;
+		AkUInt64	uOpensDuringMount;			// Look-ups of files while a package was being loaded.
+		AkUInt64	uMaxOpenDuringMountUSec;	// Longest of them. Only the look-up: stream reads are not timed here.
+	};
+
+	// Snapshot of the timings. Can be called from any thread.
+	void GetMountStats(
+		MountStats&				out_stats				// Returned timings.
+		);
+
 	// Change the policy when a file is not found in a package.
 	// By default, when a file is not found in a package, it will fall back on T_LLIOHOOK
 	// This behavior can be turned off by passing false to this function.
 	// By turning off this behavior, files will be searched in packages exclusively, with no fallback.
 	void SetPackageFallbackBehavior(bool bFallback) { m_bFallback = bFallback; }
 
+	// Gives direct access to a packaged file when its package is in memory (see CAkMappedPackage), for instance
+	// to load a bank with AK::SoundEngine::LoadBankMemoryView() without copying it.
+	// The package stays loaded until ReleaseFileView() is called with out_pPackage, after the bank is unloaded.
+	// Returns AK_FileNotFound if no package has the file, AK_Fail if the file cannot be viewed in place
+	// (package not in memory, or file not aligned on AK_BANK_PLATFORM_DATA_ALIGNMENT).
+	AKRESULT GetFileView(
+		const AkFileOpenData& in_FileOpen,		// File name or file ID, and flags, as for Open().
+		const void*&	out_pData,				// Returned address of the file.
+		AkUInt32&		out_uSize,				// Returned file size.
+		CAkFilePackage*& out_pPackage			// Returned package to pass to ReleaseFileView().
+		);
+
+	void ReleaseFileView(
+		CAkFilePackage*	in_pPackage				// Package returned by GetFileView().
+		);
+
 	//
 	// Overriden base class policies.
 	// ---------------------------------------------------------------
@@ -317,6 +390,9 @@ public:
 	// Override BatchOpen: Files contained in package must be opened differently
 	virtual void BatchOpen(AkUInt32 in_uNumFiles, AkAsyncFileOpenData** in_ppItems) override;
 
+	// Override BatchRead: Packages in memory complete the reads of their files themselves
+	virtual void BatchRead(AkUInt32 in_uNumTransfers, AK::StreamMgr::IAkLowLevelIOHook::BatchIoTransferItem* in_pTransferItems) override;
+
 	// Override Close: Do not close handle if file descriptor is part of the current packaged file.
 	virtual AKRESULT Close(
 		AkFileDesc* in_pFileDesc			// File descriptor.
@@ -373,6 +449,19 @@ protected:
 		AkPackageFileDesc*& out_pFileDesc        // Returned file descriptor.
 	);
 
+	// Helper: FindInPackages() without the timings.
+	AKRESULT SearchPackages(
+		const AkFileOpenData& in_FileOpen,
+		AkPackageFileDesc*& out_pFileDesc        // Returned file descriptor.
+	);
+
+	// Loads a file package and publishes it. Shared by LoadFilePackage() and LoadFilePackageAsync().
+	AKRESULT MountFilePackage(
+        const AkOSChar*			in_pszFilePackageName,	// File package name.
+		AkPriority				in_readerPriority,		// File package reader priority heuristic.
+		AkUInt32 &				out_uPackageID			// Returned package ID.
+		);
+
 		// Loads a file package, with a given file package reader.
 	AKRESULT _LoadFilePackage(
         const AkOSChar*			in_pszFilePackageName,	// File package name. Location is resolved using base class' Open().
@@ -382,7 +471,7 @@ protected:
         );
 
     // Searches the LUT to find the file data associated with the FileID.
-    // Returns AK_Success if the file is found.
+    // Returns AK_Success if the file is found. m_lock must be held.
 	template <class T_FILEID>
     AKRESULT FindPackagedFile( 
 		T_PACKAGE *			in_pPackage,	// Package to search into.
@@ -391,6 +480,70 @@ protected:
 		AkPackageFileDesc*&		out_pFileDesc	// Returned file descriptor.
 		);	
 
+	// Creates the file descriptor of a packaged file.
+	template <class T_FILEID>
+	AKRESULT OpenPackagedFile(
+		T_PACKAGE *			in_pPackage,	// Package that contains the file.
+		const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntry,	// Entry of the file in the package LUT.
+		AkPackageFileDesc*&	out_pFileDesc	// Returned file descriptor.
+		);
+
+	// Snapshot handling methods.
+    // ------------------------------------------
+
+	// Returns the current snapshot with a reference, or NULL if there is none. Does not lock.
+	// Not free either: with the Release() of the caller, a look-up costs 4 atomic read-modify-writes
+	// (the reader slot increment and decrement, the snapshot AddRef() and Release()), all on cache lines
+	// shared by the streaming threads. See bench/file_package_open_bench.cpp for what it buys under contention.
+	CAkFilePackageSnapshot * AcquireSnapshot();
+
+	// Replaces the current snapshot by one of m_packages, after a change of the package list or language.
+	// Publishes NULL if out of memory: look-ups then search m_packages with m_lock held. m_lock must be held.
+	void PublishSnapshot();
+
+	// Replaces the current snapshot. The previous one is released once no AcquireSnapshot() can still be reading it.
+	void SwapSnapshot( CAkFilePackageSnapshot * in_pSnapshot );
+
+	// Asynchronous loading handling methods.
+    // ------------------------------------------
+
+	struct MountRequest
+	{
+		MountRequest *			pNextItem;
+		AkFilePackageCallback	pCallback;
+		void *					pCookie;
+		AkInt64					iRequestTick;
+		AkOSChar				szName[1];		// Package name, allocated with the request.
+	};
+
+	static AK_DECLARE_THREAD_ROUTINE(MountThread)
+	{
+		AK::MemoryMgr::InitForThread();
+		AK_GET_THREAD_ROUTINE_PARAMETER_PTR(CAkFilePackageLowLevelIO)->ProcessMountQueue();
+		AK::MemoryMgr::TermForThread();
+		AkExitThread(AK_RETURN_THREAD_OK);
+	}
+
+	// Loads the queued packages, until StopMountThread().
+	void ProcessMountQueue();
+
+	// Stops the loading thread, after its current package. The packages still queued are cancelled.
+	void StopMountThread();
+
+	static AkUInt64 TicksToUSec(AkInt64 in_ticks)
+	{
+		return AK::g_fFreqRatio > 0.0f ? (AkUInt64)(in_ticks * 1000.0 / AK::g_fFreqRatio) : 0;
+	}
+
+	// Raises io_iMax to in_iValue. A compare and swap loop, so that a smaller value stored concurrently
+	// cannot overwrite a larger one.
+	static void AtomicStoreMax64(AkAtomic64* io_iMax, AkInt64 in_iValue)
+	{
+		AkInt64 iMax = AkAtomicLoad64(io_iMax);
+		while (in_iValue > iMax && !AkAtomicCas64(io_iMax, in_iValue, iMax))
+			iMax = AkAtomicLoad64(io_iMax);
+	}
+
 	inline AkPackageFileDesc* CastFileDesc(AkFileDesc* in_pFileDesc) const { return static_cast<AkPackageFileDesc*>(in_pFileDesc); }
 
 protected:
@@ -399,7 +552,28 @@ protected:
 
 	// List of loaded packages.
 	ListFilePackages	m_packages;
-	CAkLock				m_lock;
+	CAkLock				m_lock;					// Serializes changes to m_packages, and look-ups without a snapshot.
+
+	// Snapshot of m_packages, read without locking.
+	// Readers count themselves in one of two slots, chosen by the epoch: a writer flips the
+	// epoch and waits for each slot to drain, so new readers never delay it.
+	AkAtomicPtr			m_pSnapshot;
+	AkAtomic32			m_iSnapshotEpoch;
+	AkAtomic32			m_iSnapshotReaders[2];
+
+	// Queue of LoadFilePackageAsync(), first in first out, protected by m_lock. The semaphore counts its items.
+	MountRequest*		m_pMountQueueFirst;
+	MountRequest*		m_pMountQueueLast;
+	AkSemaphore			m_mountSemaphore;
+	AkThread			m_mountThread;			// Started by the first LoadFilePackageAsync().
+	bool				m_bMountThreadStarted;
+	AkAtomic32			m_iMountsInProgress;	// Queued or loading.
+	AkAtomic64			m_iMounts;
+	AkAtomic64			m_iLastMountTicks;
+	AkAtomic64			m_iMaxMountTicks;
+	AkAtomic64			m_iOpensDuringMount;
+	AkAtomic64			m_iMaxOpenTicksDuringMount;
+
 	bool				m_bRegisteredToLangChg;	// True after registering to language change notifications.
 	bool				m_bFallback;
 };
@@ -54,9 +54,24 @@ written agreement between you and Audiokinetic Inc.
 
 template <class T_LLIOHOOK, class T_PACKAGE>
 CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::CAkFilePackageLowLevelIO()
-: m_bRegisteredToLangChg( false )
+: m_pSnapshot( NULL )
+, m_iSnapshotEpoch( 0 )
+, m_bRegisteredToLangChg( false )
 , m_bFallback( true )
 {
+	m_iSnapshotReaders[0] = 0;
+	m_iSnapshotReaders[1] = 0;
+
+	m_pMountQueueFirst = NULL;
+	m_pMountQueueLast = NULL;
+	AKPLATFORM::AkClearThread(&m_mountThread);
+	m_bMountThreadStarted = false;
+	m_iMountsInProgress = 0;
+	m_iMounts = 0;
+	m_iLastMountTicks = 0;
+	m_iMaxMountTicks = 0;
+	m_iOpensDuringMount = 0;
+	m_iMaxOpenTicksDuringMount = 0;
 }
 
 template <class T_LLIOHOOK, class T_PACKAGE>
@@ -68,8 +83,10 @@ CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::~CAkFilePackageLowLevelIO()
 template <class T_LLIOHOOK, class T_PACKAGE>
 void CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::Term()
 {
+	StopMountThread();
     UnloadAllFilePackages();
 	m_packages.Term();
+	SwapSnapshot( NULL );
 	if ( m_bRegisteredToLangChg )
 		AK::StreamMgr::RemoveLanguageChangeObserver( this );
 	T_LLIOHOOK::Term();
@@ -81,7 +98,6 @@ template <class T_LLIOHOOK, class T_PACKAGE>
 AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::Open(const AkFileOpenData& in_FileOpen, AkFileDesc*& out_pFileDesc)
 {
 	{
-		AkAutoLock<CAkLock> lock(m_lock);
 		AkPackageFileDesc* pDesc = nullptr;
 		AKRESULT eResult = FindInPackages(in_FileOpen, pDesc);
 		if (eResult == AK_Success)
@@ -108,7 +124,6 @@ inline void CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::BatchOpen(AkUInt32
 
 	// First, look for all files in the batch in the packages, and keep track of those not found
 	{
-		AkAutoLock<CAkLock> lock(m_lock);
 		for (int i = 0; i < (int)in_uNumFiles; i++)
 		{
 			AkPackageFileDesc* pDesc = nullptr;
@@ -134,6 +149,65 @@ inline void CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::BatchOpen(AkUInt32
 	}
 }
 
+template<class T_LLIOHOOK, class T_PACKAGE>
+inline void CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::BatchRead(AkUInt32 in_uNumTransfers, AK::StreamMgr::IAkLowLevelIOHook::BatchIoTransferItem* in_pTransferItems)
+{
+	AkUInt32 uNumItemsForHook = 0;
+	AK::StreamMgr::IAkLowLevelIOHook::BatchIoTransferItem* arItemsForHook = (AK::StreamMgr::IAkLowLevelIOHook::BatchIoTransferItem*)AkAlloca(sizeof(AK::StreamMgr::IAkLowLevelIOHook::BatchIoTransferItem) * in_uNumTransfers);
+
+	// The descriptor holds a reference to its package, no lock needed
+	for (AkUInt32 i = 0; i < in_uNumTransfers; ++i)
+	{
+		CAkFilePackage* pPackage = CastFileDesc(in_pTransferItems[i].pFileDesc)->pPackage;
+		if (!pPackage || !static_cast<T_PACKAGE*>(pPackage)->ReadMapped(*in_pTransferItems[i].pTransferInfo))
+		{
+			arItemsForHook[uNumItemsForHook] = in_pTransferItems[i];
+			uNumItemsForHook++;
+		}
+	}
+
+	if (uNumItemsForHook > 0)
+		T_LLIOHOOK::BatchRead(uNumItemsForHook, arItemsForHook);
+}
+
+template<class T_LLIOHOOK, class T_PACKAGE>
+AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::GetFileView(
+	const AkFileOpenData& in_FileOpen,
+	const void*&	out_pData,
+	AkUInt32&		out_uSize,
+	CAkFilePackage*& out_pPackage
+	)
+{
+	AkPackageFileDesc* pDesc = nullptr;
+	AKRESULT eResult = FindInPackages(in_FileOpen, pDesc);
+	if (eResult != AK_Success)
+		return eResult;
+
+	T_PACKAGE* pPackage = static_cast<T_PACKAGE*>(pDesc->pPackage);
+	const AkUInt8* pData = pPackage->GetView((AkUInt64)pDesc->uSector * pDesc->uBlockSize, (AkUInt64)pDesc->iFileSize);
+	if (!pData || (AkUIntPtr)pData % AK_BANK_PLATFORM_DATA_ALIGNMENT != 0)
+	{
+		pPackage->Release();
+		AkDelete(AkMemID_Streaming, pDesc);
+		return AK_Fail;
+	}
+
+	// The reference the descriptor held on the package goes to the caller
+	out_pData = pData;
+	out_uSize = (AkUInt32)pDesc->iFileSize;
+	out_pPackage = pPackage;
+	AkDelete(AkMemID_Streaming, pDesc);
+	return AK_Success;
+}
+
+template<class T_LLIOHOOK, class T_PACKAGE>
+void CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::ReleaseFileView(
+	CAkFilePackage*	in_pPackage
+	)
+{
+	in_pPackage->Release();
+}
+
 template<class T_LLIOHOOK, class T_PACKAGE>
 inline AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::OutputSearchedPaths(
 	AKRESULT in_result,
@@ -146,10 +220,13 @@ inline AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::OutputSearchedP
 		return AK_InvalidParameter;
 
 	AkOSChar buf[256];
-	for (ListFilePackages::Iterator it = m_packages.Begin(); it != m_packages.End(); ++it)
 	{
-		AK_OSPRINTF(buf, 256, AKTEXT("Package #%u; "), (*it)->ID());
-		AKPLATFORM::SafeStrCat(out_searchedPath, buf, in_pathSize);
+		AkAutoLock<CAkLock> lock(m_lock);
+		for (ListFilePackages::Iterator it = m_packages.Begin(); it != m_packages.End(); ++it)
+		{
+			AK_OSPRINTF(buf, 256, AKTEXT("Package #%u; "), (*it)->ID());
+			AKPLATFORM::SafeStrCat(out_searchedPath, buf, in_pathSize);
+		}
 	}
 	if (!m_bFallback && in_FileOpen.eOpenMode == AK_OpenModeRead)
 		return AK_Success;
@@ -170,15 +247,12 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::Close(
 	if (!in_pFileDesc)
 		return AK_Success;
 
+	// Do not close handle if it is that of the file package (closed only when the package is destroyed).
+	if (IsInPackage(in_pFileDesc))
 	{
-		AkAutoLock<CAkLock> lock(m_lock);
-		// Do not close handle if it is that of the file package (closed only in UnloadFilePackage()).
-		if (IsInPackage(in_pFileDesc))
-		{
-			CastFileDesc(in_pFileDesc)->pPackage->Release();
-			AkDelete(AkMemID_Streaming, in_pFileDesc);
-			return AK_Success;
-		}
+		CastFileDesc(in_pFileDesc)->pPackage->Release();
+		AkDelete(AkMemID_Streaming, in_pFileDesc);
+		return AK_Success;
 	}
 	return T_LLIOHOOK::Close(in_pFileDesc);
 }
@@ -189,11 +263,8 @@ AkUInt32 CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::GetBlockSize(
     AkFileDesc &  in_fileDesc     // File descriptor.
     )
 {
-	{
-		AkAutoLock<CAkLock> lock(m_lock);
-		if (IsInPackage(&in_fileDesc))
-			return CastFileDesc(&in_fileDesc)->uBlockSize;
-	}
+	if (IsInPackage(&in_fileDesc))
+		return CastFileDesc(&in_fileDesc)->uBlockSize;
 
 	return T_LLIOHOOK::GetBlockSize( in_fileDesc );
 }
@@ -239,6 +310,9 @@ void CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::OnLanguageChange(
 		(*it)->lut.SetCurLanguage( in_pLanguageName );
 		++it;
 	}
+
+	// Language-specific files resolve to other entries now.
+	PublishSnapshot();
 }
 
 // Searches the LUT to find the file data associated with the FileID.
@@ -252,26 +326,81 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::FindPackagedFile(
 	AkPackageFileDesc*&	out_pFileDesc	// Returned file descriptor.
 	)
 {
-	AkAutoLock<CAkLock> lock(m_lock);
 	AKASSERT( in_pPackage && in_pFlags );
 	const CAkFilePackageLUT::AkFileEntry<T_FILEID> * pEntry = in_pPackage->lut.LookupFile( in_fileID, in_pFlags );
 
 	if ( pEntry )
-	{
-		out_pFileDesc = CastFileDesc(CreateDescriptor(in_pPackage->GetFileDesc()));
-		if (!out_pFileDesc)
-			return AK_InsufficientMemory;
+		return OpenPackagedFile( in_pPackage, pEntry, out_pFileDesc );
+	return AK_FileNotFound;
+}
 
-		// Fill file descriptor.
-		out_pFileDesc->iFileSize = pEntry->uFileSize;
-		out_pFileDesc->uSector	= pEntry->uStartBlock;
-		out_pFileDesc->uBlockSize = pEntry->uBlockSize;
-		out_pFileDesc->pPackage = in_pPackage;
-		in_pPackage->AddRef();
-		
-		return AK_Success;
+// Creates the file descriptor of a packaged file.
+template <class T_LLIOHOOK, class T_PACKAGE> 
+template <class T_FILEID>
+AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::OpenPackagedFile( 
+	T_PACKAGE *			in_pPackage,	// Package that contains the file.
+	const CAkFilePackageLUT::AkFileEntry<T_FILEID> * in_pEntry,	// Entry of the file in the package LUT.
+	AkPackageFileDesc*&	out_pFileDesc	// Returned file descriptor.
+	)
+{
+	out_pFileDesc = CastFileDesc(CreateDescriptor(in_pPackage->GetFileDesc()));
+	if (!out_pFileDesc)
+		return AK_InsufficientMemory;
+
+	// Fill file descriptor.
+	out_pFileDesc->iFileSize = in_pEntry->uFileSize;
+	out_pFileDesc->uSector	= in_pEntry->uStartBlock;
+	out_pFileDesc->uBlockSize = in_pEntry->uBlockSize;
+	out_pFileDesc->pPackage = in_pPackage;
+	in_pPackage->AddRef();
+	in_pPackage->AdviseOpen( (AkUInt64)in_pEntry->uStartBlock * in_pEntry->uBlockSize, in_pEntry->uFileSize );
+	
+	return AK_Success;
+}
+
+template <class T_LLIOHOOK, class T_PACKAGE>
+CAkFilePackageSnapshot * CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::AcquireSnapshot()
+{
+	// Count this reader until the snapshot is referenced, so that SwapSnapshot() does not release it in between.
+	AkInt32 iSlot = AkAtomicLoad32( &m_iSnapshotEpoch ) & 1;
+	AkAtomicInc32( &m_iSnapshotReaders[iSlot] );
+	CAkFilePackageSnapshot * pSnapshot = (CAkFilePackageSnapshot*)AkAtomicLoadPtr( &m_pSnapshot );
+	if ( pSnapshot )
+		pSnapshot->AddRef();
+	AkAtomicDec32( &m_iSnapshotReaders[iSlot] );
+	return pSnapshot;
+}
+
+template <class T_LLIOHOOK, class T_PACKAGE>
+void CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::PublishSnapshot()
+{
+	CAkFilePackageSnapshot * pSnapshot = CAkFilePackageSnapshot::Create( m_packages );
+	if ( !pSnapshot )
+		AK::Monitor::PostString("Could not index file packages, files will be searched package by package", AK::Monitor::ErrorLevel_Message);
+	SwapSnapshot( pSnapshot );
+}
+
+template <class T_LLIOHOOK, class T_PACKAGE>
+void CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::SwapSnapshot(
+	CAkFilePackageSnapshot * in_pSnapshot
+	)
+{
+	CAkFilePackageSnapshot * pOldSnapshot = (CAkFilePackageSnapshot*)AkAtomicExchangePtr( &m_pSnapshot, in_pSnapshot );
+	if ( !pOldSnapshot )
+		return;
+
+	// A reader may have loaded the old pointer and not referenced it yet. Flip the epoch so that new
+	// readers count themselves in the other slot, and wait for the current one to drain. Twice, because
+	// a reader may have read the epoch before the first flip and counted itself in the other slot.
+	for ( AkUInt32 uPass = 0; uPass < 2; ++uPass )
+	{
+		AkInt32 iEpoch = AkAtomicLoad32( &m_iSnapshotEpoch );
+		AkAtomicStore32( &m_iSnapshotEpoch, iEpoch + 1 );
+		while ( AkAtomicLoad32( &m_iSnapshotReaders[iEpoch & 1] ) != 0 )
+			AkSpinHint();
 	}
-	return AK_FileNotFound;
+
+	pOldSnapshot->Release();
 }
 
 // File package loading:
@@ -287,6 +416,17 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::LoadFilePackage(
     const AkOSChar *    in_pszFilePackageName,	// File package name. 
 	AkUInt32 &			out_uPackageID			// Returned package ID.
     )
+{
+	return MountFilePackage( in_pszFilePackageName, AK_DEFAULT_PRIORITY, out_uPackageID );
+}
+
+// Loads a file package and publishes it.
+template <class T_LLIOHOOK, class T_PACKAGE>
+AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::MountFilePackage(
+    const AkOSChar *    in_pszFilePackageName,	// File package name. 
+	AkPriority			in_readerPriority,		// File package reader priority heuristic.
+	AkUInt32 &			out_uPackageID			// Returned package ID.
+    )
 {
 	// Open package file.
 	AkFilePackageReader filePackageReader;
@@ -297,26 +437,191 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::LoadFilePackage(
 	filePackageReader.SetName( in_pszFilePackageName );
 
 	T_PACKAGE * pPackage;
-	eRes = _LoadFilePackage( in_pszFilePackageName, filePackageReader, AK_DEFAULT_PRIORITY, pPackage );
+	eRes = _LoadFilePackage( in_pszFilePackageName, filePackageReader, in_readerPriority, pPackage );
 	if ( eRes == AK_Success
 		|| eRes == AK_InvalidLanguage )
 	{
 		AKASSERT( pPackage );
 		// Add to packages list.
 		AkAutoLock<CAkLock> lock(m_lock);
+
+		// The language may have changed while the header was read.
+		eRes = pPackage->lut.SetCurLanguage( AK::StreamMgr::GetCurrentLanguage() );
+
 		m_packages.AddFirst( pPackage );
+		PublishSnapshot();
 		
 		out_uPackageID = pPackage->ID();
 	}
 	return eRes;
 }
 
+template <class T_LLIOHOOK, class T_PACKAGE>
+AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::LoadFilePackageAsync(
+    const AkOSChar *		in_pszFilePackageName,	// File package name. 
+	AkFilePackageCallback	in_pCallback,			// Called when the package is loaded.
+	void *					in_pCookie				// Passed to in_pCallback.
+    )
+{
+	AKASSERT( in_pszFilePackageName && in_pCallback );
+
+	size_t uNameLength = AKPLATFORM::OsStrLen( in_pszFilePackageName ) + 1;
+	MountRequest * pRequest = (MountRequest*)AkAlloc( AkMemID_FilePackage, sizeof( MountRequest ) + ( uNameLength - 1 ) * sizeof( AkOSChar ) );
+	if ( !pRequest )
+		return AK_InsufficientMemory;
+
+	pRequest->pNextItem = NULL;
+	pRequest->pCallback = in_pCallback;
+	pRequest->pCookie = in_pCookie;
+	AKPLATFORM::PerformanceCounter( &pRequest->iRequestTick );
+	AKPLATFORM::SafeStrCpy( pRequest->szName, in_pszFilePackageName, uNameLength );
+
+	AkAutoLock<CAkLock> lock(m_lock);
+	if ( !m_bMountThreadStarted )
+	{
+		if ( AKPLATFORM::AkCreateSemaphore( m_mountSemaphore, 0 ) != AK_Success )
+		{
+			AkFree( AkMemID_FilePackage, pRequest );
+			return AK_Fail;
+		}
+
+		AkThreadProperties threadProperties;
+		AKPLATFORM::AkGetDefaultThreadProperties( threadProperties );
+		AKPLATFORM::AkCreateThread(
+			MountThread,
+			this,
+			threadProperties,
+			&m_mountThread,
+			"AK::FilePackageLowLevelIO::Mount" );
+		if ( !AKPLATFORM::AkIsValidThread( &m_mountThread ) )
+		{
+			AKPLATFORM::AkDestroySemaphore( m_mountSemaphore );
+			AkFree( AkMemID_FilePackage, pRequest );
+			return AK_Fail;
+		}
+		m_bMountThreadStarted = true;
+	}
+
+	if ( m_pMountQueueLast )
+		m_pMountQueueLast->pNextItem = pRequest;
+	else
+		m_pMountQueueFirst = pRequest;
+	m_pMountQueueLast = pRequest;
+
+	AkAtomicInc32( &m_iMountsInProgress );
+	AKPLATFORM::AkReleaseSemaphore( m_mountSemaphore );
+	return AK_Success;
+}
+
+template <class T_LLIOHOOK, class T_PACKAGE>
+void CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::ProcessMountQueue()
+{
+	for (;;)
+	{
+		AKPLATFORM::AkWaitForSemaphore( m_mountSemaphore );
+
+		MountRequest * pRequest;
+		{
+			AkAutoLock<CAkLock> lock(m_lock);
+			pRequest = m_pMountQueueFirst;
+			if ( pRequest )
+			{
+				m_pMountQueueFirst = pRequest->pNextItem;
+				if ( !m_pMountQueueFirst )
+					m_pMountQueueLast = NULL;
+			}
+		}
+
+		// Only StopMountThread() wakes the thread with an empty queue
+		if ( !pRequest )
+			break;
+
+		AkUInt32 uPackageID = AK_INVALID_UNIQUE_ID;
+		AKRESULT eResult = MountFilePackage( pRequest->szName, AK_MIN_PRIORITY, uPackageID );
+
+		AkInt64 iNow;
+		AKPLATFORM::PerformanceCounter( &iNow );
+		AkInt64 iMountTicks = iNow - pRequest->iRequestTick;
+		AkAtomicInc64( &m_iMounts );
+		AkAtomicStore64( &m_iLastMountTicks, iMountTicks );
+		AtomicStoreMax64( &m_iMaxMountTicks, iMountTicks );
+		AkAtomicDec32( &m_iMountsInProgress );
+
+		pRequest->pCallback( uPackageID, eResult, pRequest->pCookie );
+		AkFree( AkMemID_FilePackage, pRequest );
+	}
+}
+
+template <class T_LLIOHOOK, class T_PACKAGE>
+void CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::StopMountThread()
+{
+	if ( !m_bMountThreadStarted )
+		return;
+
+	// Cancel the packages that are still queued
+	MountRequest * pRequest;
+	{
+		AkAutoLock<CAkLock> lock(m_lock);
+		pRequest = m_pMountQueueFirst;
+		m_pMountQueueFirst = NULL;
+		m_pMountQueueLast = NULL;
+	}
+	while ( pRequest )
+	{
+		MountRequest * pNext = pRequest->pNextItem;
+		AkAtomicDec32( &m_iMountsInProgress );
+		pRequest->pCallback( AK_INVALID_UNIQUE_ID, AK_Cancelled, pRequest->pCookie );
+		AkFree( AkMemID_FilePackage, pRequest );
+		pRequest = pNext;
+	}
+
+	// The thread leaves when it wakes up to the empty queue
+	AKPLATFORM::AkReleaseSemaphore( m_mountSemaphore );
+	AKPLATFORM::AkWaitForSingleThread( &m_mountThread );
+	AKPLATFORM::AkCloseThread( &m_mountThread );
+	AKPLATFORM::AkClearThread( &m_mountThread );
+	AKPLATFORM::AkDestroySemaphore( m_mountSemaphore );
+	m_bMountThreadStarted = false;
+}
+
+template <class T_LLIOHOOK, class T_PACKAGE>
+void CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::GetMountStats(
+	MountStats&				out_stats				// Returned timings.
+	)
+{
+	out_stats.uMounts = (AkUInt64)AkAtomicLoad64( &m_iMounts );
+	out_stats.uLastMountUSec = TicksToUSec( AkAtomicLoad64( &m_iLastMountTicks ) );
+	out_stats.uMaxMountUSec = TicksToUSec( AkAtomicLoad64( &m_iMaxMountTicks ) );
+	out_stats.uOpensDuringMount = (AkUInt64)AkAtomicLoad64( &m_iOpensDuringMount );
+	out_stats.uMaxOpenDuringMountUSec = TicksToUSec( AkAtomicLoad64( &m_iMaxOpenTicksDuringMount ) );
+}
+
 
 template <class T_LLIOHOOK, class T_PACKAGE>
 AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::FindInPackages(
 	const AkFileOpenData& in_FileOpen,	///< File name or file ID (only one should be valid!), open flags, open mode
 	AkPackageFileDesc*& out_pFileDesc        // Returned file descriptor.
 )
+{
+	// Only time the look-ups that could be slowed down by a package being loaded (see GetMountStats()).
+	if (AkAtomicLoad32(&m_iMountsInProgress) == 0)
+		return SearchPackages(in_FileOpen, out_pFileDesc);
+
+	AkInt64 iStart, iEnd;
+	AKPLATFORM::PerformanceCounter(&iStart);
+	AKRESULT eResult = SearchPackages(in_FileOpen, out_pFileDesc);
+	AKPLATFORM::PerformanceCounter(&iEnd);
+
+	AkAtomicInc64(&m_iOpensDuringMount);
+	AtomicStoreMax64(&m_iMaxOpenTicksDuringMount, iEnd - iStart);
+	return eResult;
+}
+
+template <class T_LLIOHOOK, class T_PACKAGE>
+AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::SearchPackages(
+	const AkFileOpenData& in_FileOpen,	///< File name or file ID (only one should be valid!), open flags, open mode
+	AkPackageFileDesc*& out_pFileDesc        // Returned file descriptor.
+)
 {
 	if (in_FileOpen.eOpenMode != AK_OpenModeRead	//Can't write file in a package.
 		|| in_FileOpen.pFlags == NULL)				//And we need the codec ID.
@@ -324,8 +629,6 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::FindInPackages(
 		return AK_FileNotFound;
 	}
 
-	AkAutoLock<CAkLock> lock(m_lock);
-
 	const AkOSChar* pFileName = in_FileOpen.pszFileName;
 	AkOSChar szFileName[20];
 	if (in_FileOpen.pszFileName == NULL)
@@ -334,23 +637,47 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK, T_PACKAGE>::FindInPackages(
 		pFileName = szFileName;
 	}
 
-	ListFilePackages::Iterator it = m_packages.Begin();
-	AKRESULT eResult;
-	while (it != m_packages.End())
+	// Hash the name once: IDs are the same in all packages.
+	const bool bIsExternal = in_FileOpen.pFlags->uCompanyID != AKCOMPANYID_AUDIOKINETIC;
+	AkFileID fileID = in_FileOpen.fileID;
+	AkUInt64 externalID = 0;
+	if (bIsExternal)
+		externalID = CAkFilePackageLUT::GetExternalID(pFileName);
+	else if (AK::IsBankCodecID(in_FileOpen.pFlags->uCodecID) && in_FileOpen.pszFileName)
+		fileID = CAkFilePackageLUT::GetSoundBankID(in_FileOpen.pszFileName);
+
+	CAkFilePackageSnapshot* pSnapshot = AcquireSnapshot();
+	if (pSnapshot)
 	{
-		if (in_FileOpen.pFlags->uCompanyID == AKCOMPANYID_AUDIOKINETIC)
+		// The snapshot keeps its packages alive until the descriptor has its own reference.
+		AKRESULT eResult = AK_FileNotFound;
+		CAkFilePackage* pPackage = nullptr;
+		if (bIsExternal)
 		{
-			AkFileID fileID = in_FileOpen.fileID;
-			if (AK::IsBankCodecID(in_FileOpen.pFlags->uCodecID) && in_FileOpen.pszFileName)
-				fileID = (*it)->lut.GetSoundBankID(in_FileOpen.pszFileName);
-
-			eResult = FindPackagedFile((T_PACKAGE*)(*it), fileID, in_FileOpen.pFlags, out_pFileDesc);
+			const CAkFilePackageLUT::AkFileEntry<AkUInt64>* pEntry = pSnapshot->Index().LookupFile(externalID, in_FileOpen.pFlags, pPackage);
+			if (pEntry)
+				eResult = OpenPackagedFile((T_PACKAGE*)pPackage, pEntry, out_pFileDesc);
 		}
 		else
 		{
-			AkUInt64 fileID = (*it)->lut.GetExternalID(pFileName);
-			 eResult = FindPackagedFile((T_PACKAGE*)(*it), fileID, in_FileOpen.pFlags, out_pFileDesc);
+			const CAkFilePackageLUT::AkFileEntry<AkFileID>* pEntry = pSnapshot->Index().LookupFile(fileID, in_FileOpen.pFlags, pPackage);
+			if (pEntry)
+				eResult = OpenPackagedFile((T_PACKAGE*)pPackage, pEntry, out_pFileDesc);
 		}
+		pSnapshot->Release(); // 4th atomic read-modify-write of the look-up, see AcquireSnapshot().
+		return eResult;
+	}
+
+	// No snapshot (out of memory): search the packages one by one.
+	AkAutoLock<CAkLock> lock(m_lock);
+	ListFilePackages::Iterator it = m_packages.Begin();
+	AKRESULT eResult;
+	while (it != m_packages.End())
+	{
+		if (bIsExternal)
+			eResult = FindPackagedFile((T_PACKAGE*)(*it), externalID, in_FileOpen.pFlags, out_pFileDesc);
+		else
+			eResult = FindPackagedFile((T_PACKAGE*)(*it), fileID, in_FileOpen.pFlags, out_pFileDesc);
 
 		if (eResult == AK_Success) // Found the ID in the lut.
 		{
@@ -483,15 +810,24 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::_LoadFilePackage(
 		return eRes;
 	}
 
-	// Register to language change notifications if it wasn't already done
-	if ( !m_bRegisteredToLangChg )
+	// Register to language change notifications if it wasn't already done.
+	// Packages can be loaded from several threads: claim the registration with m_lock, but do not hold it
+	// while calling the stream manager, which holds its own lock when it notifies OnLanguageChange().
+	bool bRegister;
+	{
+		AkAutoLock<CAkLock> lock(m_lock);
+		bRegister = !m_bRegisteredToLangChg;
+		m_bRegisteredToLangChg = true;
+	}
+	if ( bRegister
+		&& AK::StreamMgr::AddLanguageChangeObserver( LanguageChangeHandler, this ) != AK_Success )
 	{
-		if ( AK::StreamMgr::AddLanguageChangeObserver( LanguageChangeHandler, this ) != AK_Success )
 		{
-			out_pPackage->Release();
-			return AK_Fail;
+			AkAutoLock<CAkLock> lock(m_lock);
+			m_bRegisteredToLangChg = false;
 		}
-		m_bRegisteredToLangChg = true;
+		out_pPackage->Release();
+		return AK_Fail;
 	}
 
 	// Use the current language path (if defined) to set the language ID, 
@@ -513,6 +849,7 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::UnloadFilePackage(
 		{
 			CAkFilePackage * pPackage = (*it);
 			it = m_packages.Erase( it );
+			PublishSnapshot();
 
 			// Destroy package.
 			pPackage->Release();
@@ -527,6 +864,43 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::UnloadFilePackage(
 	return AK_IDNotFound;
 }
 
+// Unload a file package, and get called back once it is destroyed.
+template <class T_LLIOHOOK, class T_PACKAGE>
+AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::UnloadFilePackageAsync( 
+	AkUInt32				in_uPackageID,		// Package ID.
+	AkFilePackageCallback	in_pCallback,		// Called when the package is destroyed.
+	void*					in_pCookie			// Passed to in_pCallback.
+	)
+{
+	CAkFilePackage * pPackage = NULL;
+	{
+		AkAutoLock<CAkLock> lock(m_lock);
+		ListFilePackages::IteratorEx it = m_packages.BeginEx();
+		while ( it != m_packages.End() )
+		{
+			if ( (*it)->ID() == in_uPackageID )
+			{
+				pPackage = (*it);
+				m_packages.Erase( it );
+				pPackage->SetDestroyedCallback( in_pCallback, in_pCookie );
+				PublishSnapshot();
+				break;
+			}
+			++it;
+		}
+	}
+
+	if ( !pPackage )
+	{
+		AK::Monitor::PostString("Invalid package id", AK::Monitor::ErrorLevel_Error);
+		return AK_IDNotFound;
+	}
+
+	// Open files keep the package alive: it is destroyed when they are closed.
+	pPackage->Release();
+	return AK_Success;
+}
+
 // Unload all file packages.
 template <class T_LLIOHOOK, class T_PACKAGE>
 AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::UnloadAllFilePackages()
@@ -541,6 +915,7 @@ AKRESULT CAkFilePackageLowLevelIO<T_LLIOHOOK,T_PACKAGE>::UnloadAllFilePackages()
 		// Destroy package.
 		pPackage->Release();
 	}
+	PublishSnapshot();
 
 	return AK_Success;
 }
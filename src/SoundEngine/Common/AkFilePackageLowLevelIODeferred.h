@@ -28,6 +28,10 @@ written agreement between you and Audiokinetic Inc.
 #pragma once
 
 #include "../Common/AkFilePackageLowLevelIO.h"
+#include "../Common/AkMappedPackage.h"
 #include "AkDefaultIOHookDeferred.h"
 
 typedef CAkFilePackageLowLevelIO<CAkDefaultIOHookDeferred> CAkFilePackageLowLevelIODeferred;
+
+// Same, with packages mapped in memory.
+typedef CAkFilePackageLowLevelIO<CAkDefaultIOHookDeferred, CAkMappedPackage> CAkFilePackageLowLevelIODeferredMapped;
@@ -0,0 +1,71 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkFilePackageSnapshot.cpp
+//
+// Immutable view of the loaded file packages.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "AkFilePackageSnapshot.h"
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+
+CAkFilePackageSnapshot * CAkFilePackageSnapshot::Create(
+	const ListFilePackages &	in_packages		// Loaded packages, from highest to lowest priority.
+	)
+{
+	AkUInt32 uNumPackages = in_packages.Length();
+	AkUInt32 uMemSize = sizeof( CAkFilePackageSnapshot ) + ( uNumPackages > 0 ? uNumPackages - 1 : 0 ) * sizeof( CAkFilePackage * );
+	void * pMem = AkAlloc( AkMemID_FilePackage, uMemSize );
+	if ( !pMem )
+		return NULL;
+
+	CAkFilePackageSnapshot * pSnapshot = AkPlacementNew( pMem ) CAkFilePackageSnapshot();
+	if ( pSnapshot->m_index.Build( in_packages ) != AK_Success )
+	{
+		pSnapshot->Destroy();
+		return NULL;
+	}
+
+	// Keep the packages alive as long as the index points to them.
+	AkUInt32 uPackage = 0;
+	for ( ListFilePackages::Iterator it = in_packages.Begin(); it != in_packages.End(); ++it )
+	{
+		(*it)->AddRef();
+		pSnapshot->m_pPackages[ uPackage++ ] = *it;
+	}
+	pSnapshot->m_uNumPackages = uPackage;
+
+	return pSnapshot;
+}
+
+CAkFilePackageSnapshot::CAkFilePackageSnapshot()
+	: m_iRefCount( 1 )
+	, m_uNumPackages( 0 )
+{
+}
+
+CAkFilePackageSnapshot::~CAkFilePackageSnapshot()
+{
+	// Unloaded packages are destroyed here if no file descriptor references them.
+	for ( AkUInt32 i = 0; i < m_uNumPackages; ++i )
+		m_pPackages[i]->Release();
+}
+
+void CAkFilePackageSnapshot::Destroy()
+{
+	this->~CAkFilePackageSnapshot();
+	AkFree( AkMemID_FilePackage, this );
+}
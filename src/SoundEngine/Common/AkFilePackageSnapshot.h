@@ -0,0 +1,69 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkFilePackageSnapshot.h
+//
+// Immutable view of the loaded file packages, published by
+// CAkFilePackageLowLevelIO so that file look-ups do not take its lock.
+//
+// A snapshot holds a reference to each package it indexes, so the packages
+// outlive it even if they are unloaded in the meantime. Load, unload and
+// language changes publish a new snapshot; the previous one is destroyed when
+// the last look-up that uses it releases it.
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef _AK_FILE_PACKAGE_SNAPSHOT_H_
+#define _AK_FILE_PACKAGE_SNAPSHOT_H_
+
+#include "AkFilePackageIndex.h"
+
+//-----------------------------------------------------------------------------
+// Name: class CAkFilePackageSnapshot.
+// Desc: Reference-counted list of packages, with the index of their files.
+//-----------------------------------------------------------------------------
+class CAkFilePackageSnapshot
+{
+public:
+	// Snapshot factory. Returns a snapshot with one reference, or NULL if out of memory.
+	static CAkFilePackageSnapshot * Create(
+		const ListFilePackages &	in_packages		// Loaded packages, from highest to lowest priority.
+		);
+
+	inline void AddRef()
+	{
+		AkAtomicInc32( &m_iRefCount );
+	}
+	inline void Release()
+	{
+		if ( AkAtomicDec32( &m_iRefCount ) == 0 )
+			Destroy();
+	}
+
+	inline const CAkFilePackageIndex & Index() const { return m_index; }
+
+private:
+	CAkFilePackageSnapshot();
+	~CAkFilePackageSnapshot();
+
+	void Destroy();
+
+	AkAtomic32				m_iRefCount;
+	CAkFilePackageIndex		m_index;
+	AkUInt32				m_uNumPackages;
+	CAkFilePackage *		m_pPackages[1];		// m_uNumPackages items, allocated with the snapshot.
+};
+
+#endif //_AK_FILE_PACKAGE_SNAPSHOT_H_
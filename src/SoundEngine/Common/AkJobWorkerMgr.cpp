@@ -14,8 +14,12 @@ written agreement between you and Audiokinetic Inc.
 
 //#include "stdafx.h"
 #include "AkJobWorkerMgr.h"
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
 #include <AK/Tools/Common/AkFifoQueue.h>
 #include <AK/Tools/Common/AkInstrument.h>
+#include <AK/Tools/Common/AkAtomic.h>
+
+#include <new>
 
 #define AK_JOBMGR_DEBUGMSG(...) // AKPLATFORM::OutputDebugMsgV(__VA_ARGS__)
 
@@ -30,34 +34,434 @@ namespace AK
 namespace JobWorkerMgr
 {
 	typedef AkFifoQueue<AkJobType, AkJobType_Generic, ArrayPoolLEngineDefault> JobTypeQueue;
+
+	// Idle workers spin for work through gaps between requests up to this long, and park through longer ones
+	static const AkUInt32 k_uMaxSpinUSec = 50;
+
+	// Each worker has its own queue of requested job types and its own semaphore, so a request wakes exactly the
+	// workers it is handed to. Workers that run out of requests steal from the others before going to sleep.
 	struct WorkerState
 	{
 		AkThread workerThread;
 		AkUInt32 uExecutionTimeUSec;
 		AkUInt32 uWorkerIndex;
 		volatile bool bKeepThreadAlive;
+		AkSemaphore semaphore;
+		JobTypeQueue jobTypeQueue;
+
+		// When the semaphore was released to wake the worker, for the wake latency
+		AkAtomic64 releaseTick;
+
+		// Requests in the queue, counted by whoever enqueues or dequeues
+		AkAtomic32 queueDepth;
+
+		// Statistics, only written by the worker. Times are in performance counter ticks.
+		AkAtomic64 busyTicks;
+		AkAtomic64 spinTicks;
+		AkAtomic64 parkedTicks;
+		AkAtomic64 trimTicks;
+		AkAtomic64 trims;
+		AkAtomic64 taskTicks;
+		AkAtomic64 jobs[AK_NUM_JOB_TYPES];
+		AkAtomic64 tasks;
+		AkAtomic64 spinHits;
+		AkAtomic64 parks;
+		AkAtomic64 wakes;
+		AkAtomic64 wakeLatencyTicks;
+		AkAtomic64 maxWakeLatencyTicks;
+
+		// Audio jobs run since the last trim, only used by the worker
+		AkUInt32 uJobsSinceTrim;
+
+		// When the worker last went to sleep, and whether it has trimmed since it last ran a job or a task. For
+		// TrimPolicy_AfterIdle, where RequestJobWorker wakes workers asleep for too long to trim.
+		AkAtomic64 parkTick;
+		AkAtomic32 bTrimmedWhileIdle;
+
+		// Set when the worker was woken to trim rather than for a request
+		AkAtomic32 bTrimRequested;
+
+		// The most recent jobs, tasks, trims and parks, in a ring only written by the worker
+		struct TraceTicks
+		{
+			AkInt64 startTick;
+			AkInt64 endTick;
+			AkUInt32 uKind;
+		};
+		TraceTicks trace[k_uTraceCapacity];
+		AkAtomic32 traceWrite;
 	};
 	WorkerState* g_arWorkerThreadStates = nullptr;
-	AkSemaphore g_semaphore;
 	AkJobWorkerFunc g_fnJobWorker = nullptr;
 	InitSettings g_settings;
-	JobTypeQueue g_jobTypeQueue;
 	bool g_bIsInitialized = false;
 
+	// Bit i is set while worker i is going to sleep, or asleep, and nobody has handed it a request yet
+	AkAtomic64 g_idleWorkers = 0;
+
+	// Where requests go round-robin when no worker is idle
+	AkAtomic32 g_uNextBusyWorker = 0;
+
+	// Request statistics. The queue depth of all workers together is sampled at each request.
+	AkInt64 g_initTick = 0;
+	AkAtomic64 g_requests = 0;
+	AkAtomic64 g_enqueueRetries = 0;
+	AkAtomic64 g_queueDepthTotal = 0;
+	AkAtomic32 g_maxQueueDepth = 0;
+
+	// Runs the game's tasks on the workers between audio jobs. Workers only call it while g_bHasTaskRunner is set,
+	// and count themselves in g_uTaskRunnerUsers while they do, so it can be replaced once that drops to zero.
+	TaskRunner g_taskRunner;
+	AkAtomic32 g_bHasTaskRunner = 0;
+	AkAtomic32 g_uTaskRunnerUsers = 0;
+
+	// Workers spinning for work, which pick up requests queued on busy workers without being woken
+	AkAtomic32 g_uSpinningWorkers = 0;
+
+	// Last time RequestJobWorker looked for workers to trim, for TrimPolicy_AfterIdle. In performance counter ticks.
+	AkAtomic64 g_lastIdleTrimCheckTick = 0;
+
+	// Moving average of the time between requests, and the spin budget derived from it. In performance counter ticks.
+	AkAtomic64 g_lastRequestTick = 0;
+	AkAtomic64 g_meanRequestIntervalTicks = 0;
+	AkAtomic64 g_spinBudgetTicks = 0;
+
+	static AkInt64 USecToTicks(AkUInt32 in_uUSec)
+	{
+		return (AkInt64)(AK::g_fFreqRatio * in_uUSec / 1000.0f);
+	}
+
+	static AkUInt64 TicksToUSec(AkInt64 in_ticks)
+	{
+		return AK::g_fFreqRatio > 0.0f ? (AkUInt64)(in_ticks * 1000.0 / AK::g_fFreqRatio) : 0;
+	}
+
+	// Spinning through a gap costs the CPU time of the gap, parking costs a wakeup, so spin through the gaps that
+	// are usually short enough, twice the mean to catch most of them, and park right away when they're long
+	static void UpdateSpinBudget()
+	{
+		AkInt64 now = 0;
+		AKPLATFORM::PerformanceCounter(&now);
+		const AkInt64 last = AkAtomicExchange64(&g_lastRequestTick, now);
+		if (last == 0)
+			return;
+
+		// Racing updates only lose a sample
+		AkInt64 mean = AkAtomicLoad64(&g_meanRequestIntervalTicks);
+		mean += (now - last - mean) / 8;
+		AkAtomicStore64(&g_meanRequestIntervalTicks, mean);
+
+		const AkInt64 maxSpin = USecToTicks(k_uMaxSpinUSec);
+		AkAtomicStore64(&g_spinBudgetTicks, mean <= maxSpin ? (mean * 2 < maxSpin ? mean * 2 : maxSpin) : 0);
+	}
+
+	static void AddTrace(WorkerState& in_workerState, AkInt64 in_startTick, AkInt64 in_endTick, AkUInt32 in_uKind)
+	{
+		const AkInt32 write = AkAtomicLoad32(&in_workerState.traceWrite);
+		WorkerState::TraceTicks& event = in_workerState.trace[(AkUInt32)write % k_uTraceCapacity];
+		event.startTick = in_startTick;
+		event.endTick = in_endTick;
+		event.uKind = in_uKind;
+		AkAtomicStore32(&in_workerState.traceWrite, write + 1);
+	}
+
+	static bool Enqueue(WorkerState& in_workerState, AkJobType in_jobType)
+	{
+		if (!in_workerState.jobTypeQueue.Enqueue(in_jobType))
+		{
+			AkAtomicInc64(&g_enqueueRetries);
+			return false;
+		}
+		AkAtomicInc32(&in_workerState.queueDepth);
+		return true;
+	}
+
+	static void SampleQueueDepth()
+	{
+		AkInt32 depth = 0;
+		for (AkUInt32 i = 0; i < g_settings.uNumWorkerThreads; ++i)
+		{
+			depth += AkAtomicLoad32(&g_arWorkerThreadStates[i].queueDepth);
+		}
+
+		AkAtomicInc64(&g_requests);
+		AkAtomicAdd64(&g_queueDepthTotal, depth);
+		if (depth > AkAtomicLoad32(&g_maxQueueDepth))
+			AkAtomicStore32(&g_maxQueueDepth, depth);
+	}
+
+	static void ReleaseWorker(WorkerState& in_workerState)
+	{
+		AkInt64 now = 0;
+		AKPLATFORM::PerformanceCounter(&now);
+		AkAtomicStore64(&in_workerState.releaseTick, now);
+		AKPLATFORM::AkReleaseSemaphore(in_workerState.semaphore, 1);
+	}
+
+	// Claims an idle worker, the one with the lowest index. Requests pack onto the low workers, so their caches stay
+	// warm while the high ones stay asleep. Returns false when no worker is idle.
+	static bool ClaimIdleWorker(AkUInt32& out_uWorkerIndex)
+	{
+		for (;;)
+		{
+			AkInt64 idleWorkers = AkAtomicLoad64(&g_idleWorkers);
+			if (idleWorkers == 0)
+				return false;
+
+			AkUInt32 uWorkerIndex = 0;
+			while ((idleWorkers & (1LL << uWorkerIndex)) == 0)
+				uWorkerIndex++;
+
+			if (AkAtomicCas64(&g_idleWorkers, idleWorkers & ~(1LL << uWorkerIndex), idleWorkers))
+			{
+				out_uWorkerIndex = uWorkerIndex;
+				return true;
+			}
+		}
+	}
+
+	// Clears the worker's own idle bit. Returns false if someone claimed it first, and so will signal its semaphore.
+	static bool ClearIdle(AkUInt32 in_uWorkerIndex)
+	{
+		for (;;)
+		{
+			AkInt64 idleWorkers = AkAtomicLoad64(&g_idleWorkers);
+			if ((idleWorkers & (1LL << in_uWorkerIndex)) == 0)
+				return false;
+
+			if (AkAtomicCas64(&g_idleWorkers, idleWorkers & ~(1LL << in_uWorkerIndex), idleWorkers))
+				return true;
+		}
+	}
+
+	static void SetIdle(AkUInt32 in_uWorkerIndex)
+	{
+		for (;;)
+		{
+			AkInt64 idleWorkers = AkAtomicLoad64(&g_idleWorkers);
+			if (AkAtomicCas64(&g_idleWorkers, idleWorkers | (1LL << in_uWorkerIndex), idleWorkers))
+				return;
+		}
+	}
+
+	// Dequeues from the worker's own queue, or else steals from the next workers over
+	static bool DequeueOrSteal(const WorkerState& in_workerState, AkJobType& out_jobType)
+	{
+		const AkUInt32 uNumWorkerThreads = g_settings.uNumWorkerThreads;
+		for (AkUInt32 i = 0; i < uNumWorkerThreads; ++i)
+		{
+			WorkerState& victim = g_arWorkerThreadStates[(in_workerState.uWorkerIndex + i) % uNumWorkerThreads];
+			if (victim.jobTypeQueue.Dequeue(out_jobType))
+			{
+				AkAtomicDec32(&victim.queueDepth);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Spins for work for the spin budget. Returns false when the budget runs out without any.
+	static bool SpinForWork(WorkerState& in_workerState, AkJobType& out_jobType)
+	{
+		const AkInt64 budget = AkAtomicLoad64(&g_spinBudgetTicks);
+		if (budget <= 0)
+			return false;
+
+		AkAtomicInc32(&g_uSpinningWorkers);
+
+		AkInt64 start = 0;
+		AKPLATFORM::PerformanceCounter(&start);
+		AkInt64 now = start;
+		bool bFound = false;
+		while (!bFound && now - start < budget)
+		{
+			AkSpinHint();
+			bFound = DequeueOrSteal(in_workerState, out_jobType);
+			AKPLATFORM::PerformanceCounter(&now);
+		}
+
+		AkAtomicDec32(&g_uSpinningWorkers);
+
+		AkAtomicAdd64(&in_workerState.spinTicks, now - start);
+		if (bFound)
+			AkAtomicInc64(&in_workerState.spinHits);
+		return bFound;
+	}
+
+	// Runs one game task, if there is one. Returns false when there is none.
+	static bool RunTask(WorkerState& in_workerState)
+	{
+		bool bRan = false;
+		AkAtomicInc32(&g_uTaskRunnerUsers);
+		if (AkAtomicLoad32(&g_bHasTaskRunner))
+		{
+			AkInt64 start = 0;
+			AKPLATFORM::PerformanceCounter(&start);
+			bRan = g_taskRunner.fnRunTask(g_taskRunner.pCookie);
+			if (bRan)
+			{
+				AkInt64 now = 0;
+				AKPLATFORM::PerformanceCounter(&now);
+				AkAtomicAdd64(&in_workerState.taskTicks, now - start);
+				AkAtomicInc64(&in_workerState.tasks);
+				AddTrace(in_workerState, start, now, TraceKind_Task);
+			}
+		}
+		AkAtomicDec32(&g_uTaskRunnerUsers);
+		return bRan;
+	}
+
+	static bool HasTask()
+	{
+		bool bHasTask = false;
+		AkAtomicInc32(&g_uTaskRunnerUsers);
+		if (AkAtomicLoad32(&g_bHasTaskRunner))
+			bHasTask = g_taskRunner.fnHasTask(g_taskRunner.pCookie);
+		AkAtomicDec32(&g_uTaskRunnerUsers);
+		return bHasTask;
+	}
+
+	// Hands the worker's thread-local memory back. The memory manager doesn't say how much its thread caches hold, so
+	// only the trims and their time are counted.
+	static void Trim(WorkerState& in_workerState)
+	{
+		AkInt64 start = 0;
+		AKPLATFORM::PerformanceCounter(&start);
+		AK::MemoryMgr::TrimForThread();
+		AkInt64 now = 0;
+		AKPLATFORM::PerformanceCounter(&now);
+
+		AkAtomicAdd64(&in_workerState.trimTicks, now - start);
+		AkAtomicInc64(&in_workerState.trims);
+		AddTrace(in_workerState, start, now, TraceKind_Trim);
+		in_workerState.uJobsSinceTrim = 0;
+		AkAtomicStore32(&in_workerState.bTrimmedWhileIdle, 1);
+	}
+
+	static bool TrimBeforePark()
+	{
+		switch (g_settings.eTrimPolicy)
+		{
+		case TrimPolicy_OnPark:
+			return true;
+		case TrimPolicy_AboveHighWater:
+		{
+			AK::MemoryMgr::GlobalStats stats;
+			AK::MemoryMgr::GetGlobalStats(stats);
+			return stats.uReserved > stats.uUsed && stats.uReserved - stats.uUsed > g_settings.uTrimHighWaterBytes;
+		}
+		default:
+			return false;
+		}
+	}
+
+	// Sleeps until a request is handed to the worker, or it is woken to trim. The semaphore parks the thread in the
+	// kernel, a futex on Linux, rather than yield looping. Returns false when woken to trim.
+	static bool Park(WorkerState& in_workerState)
+	{
+		AKPLATFORM::AkWaitForSemaphore(in_workerState.semaphore);
+		return AkAtomicExchange32(&in_workerState.bTrimRequested, 0) == 0;
+	}
+
+	// For TrimPolicy_AfterIdle, wakes the workers that have slept for uTrimIdleTimeoutMs without trimming, so they trim
+	// and go back to sleep. Short gaps between audio frames keep the memory warm, long ones give it back. Checks at
+	// most every quarter of the timeout.
+	static void TrimIdleWorkers()
+	{
+		AkInt64 now = 0;
+		AKPLATFORM::PerformanceCounter(&now);
+		const AkInt64 timeout = USecToTicks(g_settings.uTrimIdleTimeoutMs * 1000);
+		const AkInt64 lastCheck = AkAtomicLoad64(&g_lastIdleTrimCheckTick);
+		if (now - lastCheck < timeout / 4 || !AkAtomicCas64(&g_lastIdleTrimCheckTick, now, lastCheck))
+			return;
+
+		for (AkUInt32 i = 0; i < g_settings.uNumWorkerThreads; ++i)
+		{
+			WorkerState& workerState = g_arWorkerThreadStates[i];
+			if (AkAtomicLoad32(&workerState.bTrimmedWhileIdle) || now - AkAtomicLoad64(&workerState.parkTick) < timeout)
+				continue;
+
+			// Claiming the worker keeps requests from waking it at the same time
+			if (!ClearIdle(i))
+				continue;
+
+			AkAtomicStore32(&workerState.bTrimRequested, 1);
+			AKPLATFORM::AkReleaseSemaphore(workerState.semaphore, 1);
+		}
+	}
+
 	// Example function that should be provided by game runtime to signal execution of a job.
-	// This signals to one of the worker threads that a job is available for execution, and should be woken up
+	// This hands each requested worker to an idle worker thread and wakes only that thread. With no idle thread
+	// left, the rest queue up on busy threads, which pick them up, or have them stolen, when they finish.
 	void AKSOUNDENGINE_CALL RequestJobWorker(AkJobWorkerFunc in_fnJobWorker, AkJobType in_jobType, AkUInt32 in_uNumWorkers, void* in_pClientData)
 	{
 		g_fnJobWorker = in_fnJobWorker;
+		UpdateSpinBudget();
+		SampleQueueDepth();
+		if (g_settings.eTrimPolicy == TrimPolicy_AfterIdle)
+			TrimIdleWorkers();
+
+		const AkUInt32 uNumWorkerThreads = g_settings.uNumWorkerThreads;
 		for (int i = 0; i < (int)in_uNumWorkers; i++)
 		{
-			while (!g_jobTypeQueue.Enqueue(in_jobType))
+			AkUInt32 uWorkerIndex = 0;
+			if (ClaimIdleWorker(uWorkerIndex))
 			{
-				// if the job could not be enqueued, then yield the thread so that someone else can clear up the queue, and try again
+				// Hand the request to the claimed worker and wake it
+				WorkerState& workerState = g_arWorkerThreadStates[uWorkerIndex];
+				while (!Enqueue(workerState, in_jobType))
+				{
+					AkThreadYield();
+				}
+				ReleaseWorker(workerState);
+				continue;
+			}
+
+			uWorkerIndex = (AkUInt32)AkAtomicInc32(&g_uNextBusyWorker) % uNumWorkerThreads;
+			while (!Enqueue(g_arWorkerThreadStates[uWorkerIndex], in_jobType))
+			{
+				// if the job could not be enqueued, then yield the thread so that someone else can clear up the queue, and try the next one
 				AkThreadYield();
+				uWorkerIndex = (uWorkerIndex + 1) % uNumWorkerThreads;
+			}
+
+			// Every worker may have gone to sleep before seeing the request, so wake one to steal it, unless one is
+			// spinning. A spinning worker checks the queues once more after it stops.
+			if (AkAtomicLoad32(&g_uSpinningWorkers) == 0 && ClaimIdleWorker(uWorkerIndex))
+			{
+				ReleaseWorker(g_arWorkerThreadStates[uWorkerIndex]);
 			}
 		}
-		AKPLATFORM::AkReleaseSemaphore(g_semaphore, in_uNumWorkers);
+	}
+
+	void SetTaskRunner(const TaskRunner* in_pTaskRunner)
+	{
+		AkAtomicStore32(&g_bHasTaskRunner, 0);
+		while (AkAtomicLoad32(&g_uTaskRunnerUsers) != 0)
+		{
+			AkSpinHint();
+		}
+
+		if (in_pTaskRunner)
+		{
+			g_taskRunner = *in_pTaskRunner;
+			AkAtomicStore32(&g_bHasTaskRunner, 1);
+		}
+	}
+
+	// Wakes idle workers only. Busy workers pick up tasks once they run out of audio jobs.
+	void RequestTaskWorkers(AkUInt32 in_uNumWorkers)
+	{
+		if (!g_bIsInitialized)
+			return;
+
+		for (AkUInt32 i = 0; i < in_uNumWorkers; ++i)
+		{
+			AkUInt32 uWorkerIndex = 0;
+			if (!ClaimIdleWorker(uWorkerIndex))
+				return;
+			ReleaseWorker(g_arWorkerThreadStates[uWorkerIndex]);
+		}
 	}
 
 	AK_DECLARE_THREAD_ROUTINE(JobWorkerThread)
@@ -67,51 +471,97 @@ namespace JobWorkerMgr
 		AK_INSTRUMENT_THREAD_START("AK::JobWorkerMgr::Thread");
 		AK::MemoryMgr::InitForThread();
 
-		// Sleep until signaled the first time
-		AK_JOBMGR_DEBUGMSG("Worker #%d going to sleep\n", workerState.uWorkerIndex);
-		AKPLATFORM::AkWaitForSemaphore(g_semaphore);
-		AK_JOBMGR_DEBUGMSG("Worker #%d Waking up for work\n", workerState.uWorkerIndex);
-
-		if (g_fnJobWorker != nullptr)
+		while (workerState.bKeepThreadAlive)
 		{
-			while (workerState.bKeepThreadAlive)
+			AkJobType jobType;
+			if (!DequeueOrSteal(workerState, jobType))
 			{
-				AkJobType jobType;
+				// Game tasks run one at a time, and only while no audio job is waiting, so an audio job requested
+				// meanwhile waits for the end of the current task at most
+				if (RunTask(workerState))
 				{
-					AkInt64 endSpinTime = 0;
-					while (!g_jobTypeQueue.Dequeue(jobType))
+					AkAtomicStore32(&workerState.bTrimmedWhileIdle, 0);
+					continue;
+				}
+
+				if (!SpinForWork(workerState, jobType))
+				{
+					// Announce going to sleep, then look once more, so a request made in between isn't missed. The idle
+					// time starts first, so TrimIdleWorkers never sees the previous one.
+					AkInt64 idleStart = 0;
+					AKPLATFORM::PerformanceCounter(&idleStart);
+					AkAtomicStore64(&workerState.parkTick, idleStart);
+					SetIdle(workerState.uWorkerIndex);
+					const bool bHasJob = DequeueOrSteal(workerState, jobType);
+					if (!bHasJob && !HasTask())
 					{
-						// if the dequeue failed, just try again in a light spin. There may be multiple enqueues happening,
-						// and we were woken up by a later enqueue, and another enqueue is not yet done its writing.
-						if (endSpinTime == 0)
+						if (TrimBeforePark())
+							Trim(workerState);
+
+						AkInt64 parkStart = 0;
+						AKPLATFORM::PerformanceCounter(&parkStart);
+						AK_JOBMGR_DEBUGMSG("Worker #%d going to sleep\n", workerState.uWorkerIndex);
+						AkAtomicInc64(&workerState.parks);
+						const bool bRequested = Park(workerState);
+						AK_JOBMGR_DEBUGMSG("Worker #%d Waking up for work\n", workerState.uWorkerIndex);
+
+						AkInt64 now = 0;
+						AKPLATFORM::PerformanceCounter(&now);
+						AkAtomicAdd64(&workerState.parkedTicks, now - parkStart);
+						AddTrace(workerState, parkStart, now, TraceKind_Park);
+
+						if (!bRequested)
 						{
-							AKPLATFORM::PerformanceCounter(&endSpinTime);
-							endSpinTime += AkInt64(AK::g_fFreqRatio * 0.01); // only spin for about 10us
+							Trim(workerState);
+							continue;
 						}
 
-						// wait a bit or then yield to another thread
-						AkInt64 currentTime = 0;
-						AKPLATFORM::PerformanceCounter(&currentTime);
-						if (currentTime < endSpinTime)
-						{
-							AkSpinHint();
-						}
-						else
-						{
-							AkThreadYield();
-						}
+						const AkInt64 latency = now - AkAtomicLoad64(&workerState.releaseTick);
+						AkAtomicInc64(&workerState.wakes);
+						AkAtomicAdd64(&workerState.wakeLatencyTicks, latency);
+						if (latency > AkAtomicLoad64(&workerState.maxWakeLatencyTicks))
+							AkAtomicStore64(&workerState.maxWakeLatencyTicks, latency);
+						continue;
+					}
+
+					if (!ClearIdle(workerState.uWorkerIndex))
+					{
+						// Claimed in the meantime, consume the signal that comes with it, and trim if that's what it
+						// was for
+						if (!Park(workerState))
+							Trim(workerState);
 					}
+
+					// A game task came in, run it on the next pass
+					if (!bHasJob)
+						continue;
 				}
+			}
 
+			if (g_fnJobWorker != nullptr)
+			{
+				AkInt64 start = 0;
+				AKPLATFORM::PerformanceCounter(&start);
 				g_fnJobWorker(jobType, workerState.uExecutionTimeUSec);
+				AkInt64 now = 0;
+				AKPLATFORM::PerformanceCounter(&now);
 
-				// Going back to sleep, so release any thread-local memory
-				AK::MemoryMgr::TrimForThread();
+				AkAtomicAdd64(&workerState.busyTicks, now - start);
+				AkAtomicInc64(&workerState.jobs[jobType]);
+				AkAtomicStore32(&workerState.bTrimmedWhileIdle, 0);
+				AddTrace(workerState, start, now, (AkUInt32)jobType);
 
-				// Go back to sleep until signaled for new work
-				AK_JOBMGR_DEBUGMSG("Worker #%d going to sleep\n", workerState.uWorkerIndex);
-				AKPLATFORM::AkWaitForSemaphore(g_semaphore);
-				AK_JOBMGR_DEBUGMSG("Worker #%d Waking up for work\n", workerState.uWorkerIndex);
+				if (g_settings.eTrimPolicy == TrimPolicy_AfterJobs && ++workerState.uJobsSinceTrim >= g_settings.uTrimAfterJobs)
+				{
+					Trim(workerState);
+				}
+
+				// The worker returns when its time slice is used up, so give the core to other threads before
+				// taking more work
+				if (workerState.uExecutionTimeUSec > 0 && now - start >= USecToTicks(workerState.uExecutionTimeUSec))
+				{
+					AkThreadYield();
+				}
 			}
 		}
 
@@ -123,6 +573,10 @@ namespace JobWorkerMgr
 		: uExecutionTimeUSec(0)
 		, uNumWorkerThreads(AK_JOBWORKERMGR_DEFAULT_NUM_THREADS)
 		, arThreadWorkerProperties(nullptr)
+		, eTrimPolicy(TrimPolicy_OnPark)
+		, uTrimAfterJobs(64)
+		, uTrimIdleTimeoutMs(100)
+		, uTrimHighWaterBytes(1024 * 1024)
 	{
 	}
 
@@ -152,20 +606,19 @@ namespace JobWorkerMgr
 	// Initialize all of the worker threads and bookkeeping variables
 	AKRESULT InitWorkers(const InitSettings& in_implInitSettings)
 	{
-		if (in_implInitSettings.uNumWorkerThreads == 0)
+		if (in_implInitSettings.uNumWorkerThreads == 0 || in_implInitSettings.uNumWorkerThreads > k_uMaxWorkerThreads)
+			return AK_InvalidParameter;
+		if (in_implInitSettings.eTrimPolicy == TrimPolicy_AfterJobs && in_implInitSettings.uTrimAfterJobs == 0)
 			return AK_InvalidParameter;
 
 		AKRESULT ret = AK_Success;
 
-		// Entries in the queue must be a power of 2
+		// Entries in the queue must be a power of 2. Any one worker may be handed every request.
 		AkUInt32 uNumEntries = 2;
 		while (uNumEntries < in_implInitSettings.uNumWorkerThreads * AK_NUM_JOB_TYPES)
 		{
 			uNumEntries <<= 1;
 		}
-		ret = g_jobTypeQueue.Init(uNumEntries);
-		if (ret != AK_Success)
-			return ret;
 
 		AkUInt32 uNumWorkerThreads = in_implInitSettings.uNumWorkerThreads;
 		g_arWorkerThreadStates = (WorkerState*)AK::MemoryMgr::Malloc(AkMemID_Processing, uNumWorkerThreads * sizeof(WorkerState));
@@ -174,24 +627,44 @@ namespace JobWorkerMgr
 			return AK_InsufficientMemory;
 		}
 		AKPLATFORM::AkMemSet(g_arWorkerThreadStates, 0, uNumWorkerThreads * sizeof(WorkerState));
-
 		g_settings = in_implInitSettings;
-
-		ret = AKPLATFORM::AkCreateSemaphore(g_semaphore, 0);
-		if (ret != AK_Success)
+		g_settings.arThreadWorkerProperties = nullptr;
+		AkAtomicStore64(&g_idleWorkers, 0);
+		AkAtomicStore32(&g_uNextBusyWorker, 0);
+		AkAtomicStore32(&g_uSpinningWorkers, 0);
+		AkAtomicStore64(&g_lastRequestTick, 0);
+		AkAtomicStore64(&g_meanRequestIntervalTicks, 0);
+		AkAtomicStore64(&g_spinBudgetTicks, 0);
+		AkAtomicStore64(&g_lastIdleTrimCheckTick, 0);
+		AkAtomicStore64(&g_requests, 0);
+		AkAtomicStore64(&g_enqueueRetries, 0);
+		AkAtomicStore64(&g_queueDepthTotal, 0);
+		AkAtomicStore32(&g_maxQueueDepth, 0);
+		AKPLATFORM::PerformanceCounter(&g_initTick);
+
+		// Queues and semaphores first, the workers steal from each other as soon as they start
+		for (AkUInt32 workerIdx = 0; workerIdx < uNumWorkerThreads; ++workerIdx)
 		{
-			return ret;
+			WorkerState* pWorkerState = ::new (&g_arWorkerThreadStates[workerIdx]) WorkerState();
+			pWorkerState->uExecutionTimeUSec = in_implInitSettings.uExecutionTimeUSec;
+			pWorkerState->bKeepThreadAlive = true;
+			pWorkerState->uWorkerIndex = workerIdx;
+
+			ret = pWorkerState->jobTypeQueue.Init(uNumEntries);
+			if (ret != AK_Success)
+				return ret;
+
+			ret = AKPLATFORM::AkCreateSemaphore(pWorkerState->semaphore, 0);
+			if (ret != AK_Success)
+				return ret;
 		}
 
 		AkThreadProperties defaultThreadProps;
 		AKPLATFORM::AkGetDefaultHighPriorityThreadProperties(defaultThreadProps);
+
 		WorkerState* pNextWorkerState = g_arWorkerThreadStates;
 		for (AkUInt32 workerIdx = 0; workerIdx < uNumWorkerThreads; ++workerIdx)
 		{
-			pNextWorkerState->uExecutionTimeUSec = in_implInitSettings.uExecutionTimeUSec;
-			pNextWorkerState->bKeepThreadAlive = true;
-			pNextWorkerState->uWorkerIndex = workerIdx;
-
 			char threadName[32];
 			snprintf(threadName, 32, "AK::JobWorkerMgr::Thread-%d", workerIdx);
 			AKPLATFORM::AkCreateThread(
@@ -205,15 +678,83 @@ namespace JobWorkerMgr
 			{
 				return AK_Fail;
 			}
+
 			pNextWorkerState++;
 		}
+
 		g_bIsInitialized = true;
+
 		return AK_Success;
 	}
 
+	void GetStats(Stats& out_stats)
+	{
+		AKPLATFORM::AkMemSet(&out_stats, 0, sizeof(out_stats));
+		if (!g_arWorkerThreadStates)
+			return;
+
+		AkInt64 now = 0;
+		AKPLATFORM::PerformanceCounter(&now);
+
+		out_stats.uNumWorkers = g_settings.uNumWorkerThreads;
+		out_stats.uElapsedUSec = TicksToUSec(now - g_initTick);
+		out_stats.uRequests = AkAtomicLoad64(&g_requests);
+		out_stats.uEnqueueRetries = AkAtomicLoad64(&g_enqueueRetries);
+		out_stats.uQueueDepthTotal = AkAtomicLoad64(&g_queueDepthTotal);
+		out_stats.uMaxQueueDepth = AkAtomicLoad32(&g_maxQueueDepth);
+		out_stats.uSpinBudgetUSec = (AkUInt32)TicksToUSec(AkAtomicLoad64(&g_spinBudgetTicks));
+
+		for (AkUInt32 i = 0; i < g_settings.uNumWorkerThreads; ++i)
+		{
+			WorkerState& workerState = g_arWorkerThreadStates[i];
+			WorkerStats& workerStats = out_stats.workers[i];
+			workerStats.uBusyUSec = TicksToUSec(AkAtomicLoad64(&workerState.busyTicks));
+			workerStats.uSpinUSec = TicksToUSec(AkAtomicLoad64(&workerState.spinTicks));
+			workerStats.uParkedUSec = TicksToUSec(AkAtomicLoad64(&workerState.parkedTicks));
+			workerStats.uTrimUSec = TicksToUSec(AkAtomicLoad64(&workerState.trimTicks));
+			workerStats.uTrims = AkAtomicLoad64(&workerState.trims);
+			workerStats.uTaskUSec = TicksToUSec(AkAtomicLoad64(&workerState.taskTicks));
+			for (AkUInt32 type = 0; type < AK_NUM_JOB_TYPES; ++type)
+			{
+				workerStats.uJobs[type] = AkAtomicLoad64(&workerState.jobs[type]);
+			}
+			workerStats.uTasks = AkAtomicLoad64(&workerState.tasks);
+			workerStats.uSpinHits = AkAtomicLoad64(&workerState.spinHits);
+			workerStats.uParks = AkAtomicLoad64(&workerState.parks);
+			workerStats.uWakes = AkAtomicLoad64(&workerState.wakes);
+			workerStats.uWakeLatencyUSec = TicksToUSec(AkAtomicLoad64(&workerState.wakeLatencyTicks));
+			workerStats.uMaxWakeLatencyUSec = TicksToUSec(AkAtomicLoad64(&workerState.maxWakeLatencyTicks));
+			workerStats.uQueueDepth = (AkUInt32)AkAtomicLoad32(&workerState.queueDepth);
+		}
+	}
+
+	// The worker may overwrite the oldest events while they're copied, which only garbles those
+	AkUInt32 GetTrace(AkUInt32 in_uWorkerIndex, TraceEvent* out_events, AkUInt32 in_uMaxEvents)
+	{
+		if (!g_arWorkerThreadStates || in_uWorkerIndex >= g_settings.uNumWorkerThreads)
+			return 0;
+
+		WorkerState& workerState = g_arWorkerThreadStates[in_uWorkerIndex];
+		const AkUInt32 uWrite = (AkUInt32)AkAtomicLoad32(&workerState.traceWrite);
+		AkUInt32 uCount = uWrite < k_uTraceCapacity ? uWrite : k_uTraceCapacity;
+		uCount = uCount < in_uMaxEvents ? uCount : in_uMaxEvents;
+
+		for (AkUInt32 i = 0; i < uCount; ++i)
+		{
+			const WorkerState::TraceTicks& event = workerState.trace[(uWrite - uCount + i) % k_uTraceCapacity];
+			out_events[i].uStartUSec = TicksToUSec(event.startTick - g_initTick);
+			out_events[i].uDurationUSec = TicksToUSec(event.endTick - event.startTick);
+			out_events[i].uKind = event.uKind;
+		}
+
+		return uCount;
+	}
+
 	// Terminate all of the worker threads and clean things up
 	void TermWorkers()
 	{
+		SetTaskRunner(nullptr);
+
 		if (g_arWorkerThreadStates)
 		{
 			// Mark all of the threads as inactive
@@ -223,7 +764,10 @@ namespace JobWorkerMgr
 			}
 
 			// signal all of the them to wake-up to process said inactivity
-			AKPLATFORM::AkReleaseSemaphore(g_semaphore, g_settings.uNumWorkerThreads);
+			for (AkUInt32 i = 0; i < g_settings.uNumWorkerThreads; ++i)
+			{
+				ReleaseWorker(g_arWorkerThreadStates[i]);
+			}
 
 			// and then wait for them to gracefully close
 			for (AkUInt32 i = 0; i < g_settings.uNumWorkerThreads; ++i)
@@ -232,12 +776,19 @@ namespace JobWorkerMgr
 				AKPLATFORM::AkCloseThread(&g_arWorkerThreadStates[i].workerThread);
 			}
 
-			AKPLATFORM::AkDestroySemaphore(g_semaphore);
-			AKPLATFORM::AkClearSemaphore(g_semaphore);
+			for (AkUInt32 i = 0; i < g_settings.uNumWorkerThreads; ++i)
+			{
+				WorkerState& workerState = g_arWorkerThreadStates[i];
+				AKPLATFORM::AkDestroySemaphore(workerState.semaphore);
+				AKPLATFORM::AkClearSemaphore(workerState.semaphore);
+				workerState.jobTypeQueue.Term();
+				workerState.~WorkerState();
+			}
+
 			AK::MemoryMgr::Free(AkMemID_Processing, g_arWorkerThreadStates);
+			g_arWorkerThreadStates = nullptr;
 		}
 
-		g_jobTypeQueue.Term();
 		g_bIsInitialized = false;
 	}
 
@@ -21,6 +21,16 @@ namespace AK
 {
 	namespace JobWorkerMgr
 	{
+		// When workers hand their thread-local memory back with AK::MemoryMgr::TrimForThread
+		enum TrimPolicy
+		{
+			TrimPolicy_OnPark,          // Every time the worker goes to sleep
+			TrimPolicy_AfterJobs,       // After every uTrimAfterJobs jobs
+			TrimPolicy_AfterIdle,       // Once the worker has slept for uTrimIdleTimeoutMs, noticed by the next job request
+			TrimPolicy_AboveHighWater,  // When going to sleep while the memory manager holds more than uTrimHighWaterBytes reserved but unused
+			TrimPolicy_Never
+		};
+
 		struct InitSettings
 		{
 			InitSettings();
@@ -30,6 +40,10 @@ namespace AK
 			AkUInt32 uExecutionTimeUSec; // Maximum amount of time allotted for one execution of a worker, in microseconds. Defaults to 0 (no timeout).
 			AkUInt32 uNumWorkerThreads;  // How many threads to allocate for processing jobs.
 			AkThreadProperties* arThreadWorkerProperties; // Array of thread settings, should have uNumWorkerThreads elements. If null, will take default thread settings
+			TrimPolicy eTrimPolicy;      // Defaults to TrimPolicy_OnPark.
+			AkUInt32 uTrimAfterJobs;
+			AkUInt32 uTrimIdleTimeoutMs;
+			AkUInt64 uTrimHighWaterBytes;
 		};
 		void GetDefaultInitSettings(InitSettings& out_initSettings);
 
@@ -41,6 +55,75 @@ namespace AK
 
 		// Terminate all of the worker threads and clean things up
 		void TermWorkers();
+
+		// Runs the game's own tasks on the workers, whenever they have no audio job to run
+		struct TaskRunner
+		{
+			bool (*fnRunTask)(void* in_pCookie); // Runs one task, returns false if there was none
+			bool (*fnHasTask)(void* in_pCookie); // Whether a task is ready to run, checked before a worker goes to sleep. Wake workers with RequestTaskWorkers when blocked tasks become ready.
+			void* pCookie;
+		};
+
+		// Sets the task runner, or removes it with nullptr. Returns once no worker is still calling the previous one.
+		void SetTaskRunner(const TaskRunner* in_pTaskRunner);
+
+		// Wakes up to in_uNumWorkers sleeping workers to run tasks. Call after queueing tasks.
+		void RequestTaskWorkers(AkUInt32 in_uNumWorkers);
+
+		// Workers are tracked in 64 bit masks
+		static const AkUInt32 k_uMaxWorkerThreads = 64;
+
+		// Trace events kept per worker
+		static const AkUInt32 k_uTraceCapacity = 1024;
+
+		// Counters of one worker since InitWorkers
+		struct WorkerStats
+		{
+			AkUInt64 uBusyUSec;           // Running jobs
+			AkUInt64 uSpinUSec;           // Spinning for work, which is the CPU used while idle
+			AkUInt64 uParkedUSec;         // Asleep
+			AkUInt64 uTrimUSec;           // In AK::MemoryMgr::TrimForThread
+			AkUInt64 uTrims;              // Thread-local memory handed back, which the memory manager doesn't measure
+			AkUInt64 uTaskUSec;           // Running game tasks
+			AkUInt64 uJobs[AK_NUM_JOB_TYPES]; // Jobs run, by AkJobType
+			AkUInt64 uTasks;              // Game tasks run
+			AkUInt64 uSpinHits;           // Spins that found work before the budget ran out
+			AkUInt64 uParks;              // Times the worker went to sleep
+			AkUInt64 uWakes;              // Times a request woke the worker
+			AkUInt64 uWakeLatencyUSec;    // Total time from waking the worker to it running
+			AkUInt64 uMaxWakeLatencyUSec;
+			AkUInt32 uQueueDepth;         // Requests waiting in its queue now
+		};
+
+		struct Stats
+		{
+			AkUInt32 uNumWorkers;
+			AkUInt64 uElapsedUSec;        // Since InitWorkers
+			AkUInt64 uRequests;           // Calls to RequestJobWorker
+			AkUInt64 uEnqueueRetries;     // Times a request found a worker queue full
+			AkUInt64 uQueueDepthTotal;    // Requests waiting in all queues, summed over the samples taken at each request
+			AkUInt32 uMaxQueueDepth;
+			AkUInt32 uSpinBudgetUSec;     // Current spin budget, from the recent time between requests
+			WorkerStats workers[k_uMaxWorkerThreads];
+		};
+
+		// Snapshot of the counters. Can be called from any thread while the workers run.
+		void GetStats(Stats& out_stats);
+
+		// Trace event kinds past the job types
+		static const AkUInt32 TraceKind_Trim = AK_NUM_JOB_TYPES;
+		static const AkUInt32 TraceKind_Park = AK_NUM_JOB_TYPES + 1;
+		static const AkUInt32 TraceKind_Task = AK_NUM_JOB_TYPES + 2;
+
+		struct TraceEvent
+		{
+			AkUInt64 uStartUSec;          // Since InitWorkers
+			AkUInt64 uDurationUSec;
+			AkUInt32 uKind;               // An AkJobType for jobs, or one of the TraceKind values
+		};
+
+		// Copies the worker's most recent trace events, oldest first. Returns how many were copied.
+		AkUInt32 GetTrace(AkUInt32 in_uWorkerIndex, TraceEvent* out_events, AkUInt32 in_uMaxEvents);
 	}
 }
 
@@ -0,0 +1,206 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkMappedPackage.h
+//
+// A file package that maps the whole package file in memory, to be used
+// as the T_PACKAGE argument of CAkFilePackageLowLevelIO.
+//
+// Reads of packaged files are completed by copying from the mapping,
+// without a call into the low-level I/O hook, and banks can be loaded
+// from the mapping directly (see CAkFilePackageLowLevelIO::GetFileView()).
+// Processes mapping the same package share its pages in the page cache.
+//
+// The header is still read through the stream manager, and the package
+// keeps its file handle: if the file cannot be mapped, the package works
+// like a CAkDiskPackage.
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef _AK_MAPPED_PACKAGE_H_
+#define _AK_MAPPED_PACKAGE_H_
+
+#include "AkFilePackageLowLevelIO.h"
+
+#if defined(AK_WIN)
+#include <windows.h>
+#else
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Name: CAkMappedPackage
+// Desc: Extends CAkDiskPackage with a read-only mapping of the package file.
+//-----------------------------------------------------------------------------
+class CAkMappedPackage : public CAkDiskPackage
+{
+public:
+	// Files up to this size are asked to stay resident when opened. They are usually short sounds that are
+	// played again and again. Larger files are streamed front to back.
+	static const AkUInt32 k_uResidentFileSize = 256 * 1024;
+
+	// Factory for mapped package. Same as CAkDiskPackage::Create(), then maps the package file.
+	static CAkMappedPackage * Create(
+		AkFilePackageReader & in_reader,		// File package reader.
+		const AkOSChar*		in_pszPackageName,	// Name of the file package (for memory monitoring).
+		AkUInt32 			in_uHeaderSize,		// File package header size, including the size of the header chunk AKPK_HEADER_CHUNK_DEF_SIZE.
+		AkUInt32 &			out_uReservedHeaderSize, // Size reserved for header, taking mem align into account.
+		AkUInt8 *&			out_pHeaderBuffer	// Returned address of memory for header.
+		)
+	{
+		CAkMappedPackage * pPackage = CAkFilePackage::Create<CAkMappedPackage>(
+			in_pszPackageName,
+			in_uHeaderSize,
+			in_reader.GetBlockSize(),
+			out_uReservedHeaderSize,
+			out_pHeaderBuffer );
+		if ( pPackage )
+		{
+			pPackage->m_reader = in_reader;				// Copy reader.
+			AkFileDesc* pFileDesc = in_reader.GetFileDesc();
+			pPackage->m_hFile = pFileDesc->hFile;	// Cache handle.
+			pPackage->Map( in_reader.GetSize() );
+		}
+		return pPackage;
+	}
+
+	CAkMappedPackage(AkUInt32 in_uPackageID, AkUInt32 in_uHeaderSize, void * in_pToRelease)
+		: CAkDiskPackage(in_uPackageID, in_uHeaderSize, in_pToRelease)
+		, m_pData( NULL )
+		, m_uSize( 0 )
+#if defined(AK_WIN)
+		, m_hMapping( NULL )
+#endif
+	{ }
+
+	// Override Destroy(): Unmap before closing the file.
+	virtual void Destroy()
+	{
+		Unmap();
+		CAkDiskPackage::Destroy();
+	}
+
+	inline bool IsMapped() const { return m_pData != NULL; }
+
+	// Completes a read of a packaged file with a copy from the mapping, and calls its callback.
+	// Returns false if the package isn't mapped: the read must go to the low-level I/O hook.
+	bool ReadMapped( AkAsyncIOTransferInfo & io_transferInfo )
+	{
+		if ( !m_pData )
+			return false;
+
+		AKRESULT eResult = AK_Fail;
+		if ( io_transferInfo.uFilePosition + io_transferInfo.uRequestedSize <= m_uSize )
+		{
+			AKPLATFORM::AkMemCpy( io_transferInfo.pBuffer, m_pData + io_transferInfo.uFilePosition, io_transferInfo.uRequestedSize );
+			eResult = AK_Success;
+		}
+
+		io_transferInfo.pCallback( &io_transferInfo, eResult );
+		return true;
+	}
+
+	// Returns the address of a region of the package file in the mapping, or NULL if it isn't mapped.
+	const AkUInt8 * GetView( AkUInt64 in_uOffset, AkUInt64 in_uSize ) const
+	{
+		if ( !m_pData || in_uOffset + in_uSize > m_uSize )
+			return NULL;
+		return m_pData + in_uOffset;
+	}
+
+	// Tells the OS how the region of a file that is being opened will be read.
+	void AdviseOpen(
+		AkUInt64
+#if !defined(AK_WIN)
+		in_uOffset
+#endif
+		, AkUInt64
+#if !defined(AK_WIN)
+		in_uSize
+#endif
+		)
+	{
+#if !defined(AK_WIN)
+		if ( !m_pData || in_uOffset >= m_uSize )
+			return;
+
+		// madvise() wants the address on a page boundary.
+		const AkUInt64 uPageSize = (AkUInt64)sysconf( _SC_PAGESIZE );
+		const AkUInt64 uStart = in_uOffset - in_uOffset % uPageSize;
+		const AkUInt64 uEnd = AkMin( in_uOffset + in_uSize, m_uSize );
+
+		::madvise( (void*)( m_pData + uStart ), (size_t)( uEnd - uStart ), in_uSize <= k_uResidentFileSize ? MADV_WILLNEED : MADV_SEQUENTIAL );
+#endif
+	}
+
+protected:
+
+	void Map( AkUInt64 in_uSize )
+	{
+		if ( in_uSize == 0 || (AkUInt64)(size_t)in_uSize != in_uSize )
+			return;
+
+#if defined(AK_WIN)
+		m_hMapping = ::CreateFileMappingW( m_hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+		if ( !m_hMapping )
+			return;
+
+		void * pData = ::MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( !pData )
+		{
+			::CloseHandle( m_hMapping );
+			m_hMapping = NULL;
+			return;
+		}
+#else
+		void * pData = ::mmap( NULL, (size_t)in_uSize, PROT_READ, MAP_SHARED, fileno( m_hFile ), 0 );
+		if ( pData == MAP_FAILED )
+			return;
+
+		// Reads jump from file to file: only read ahead in the files that are open (see AdviseOpen()).
+		::madvise( pData, (size_t)in_uSize, MADV_RANDOM );
+#endif
+
+		m_pData = (const AkUInt8*)pData;
+		m_uSize = in_uSize;
+	}
+
+	void Unmap()
+	{
+		if ( !m_pData )
+			return;
+
+#if defined(AK_WIN)
+		::UnmapViewOfFile( m_pData );
+		::CloseHandle( m_hMapping );
+		m_hMapping = NULL;
+#else
+		::munmap( (void*)m_pData, (size_t)m_uSize );
+#endif
+
+		m_pData = NULL;
+		m_uSize = 0;
+	}
+
+	const AkUInt8 *		m_pData;	// The whole package file, NULL if not mapped.
+	AkUInt64			m_uSize;
+#if defined(AK_WIN)
+	HANDLE				m_hMapping;
+#endif
+};
+
+#endif //_AK_MAPPED_PACKAGE_H_
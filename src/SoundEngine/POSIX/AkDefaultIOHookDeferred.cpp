@@ -0,0 +1,725 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkDefaultIOHookDeferred.cpp
+//
+// Default deferred low level IO hook (AK::StreamMgr::IAkLowLevelIOHook)
+// and file system (AK::StreamMgr::IAkFileLocationResolver) implementation
+// on POSIX.
+//
+// AK::StreamMgr::IAkFileLocationResolver:
+// Resolves file location using simple path concatenation logic.
+// It can be used as a
+// standalone Low-Level IO system, or as part of a multi device system.
+// In the latter case, you should manage multiple devices by implementing
+// AK::StreamMgr::IAkFileLocationResolver elsewhere (you may take a look
+// at class CAkDefaultLowLevelIODispatcher).
+//
+// AK::StreamMgr::IAkLowLevelIOHook:
+// Transfers go to an io_uring on Linux, one io_uring_enter() per batch,
+// and complete on a completion thread. Without io_uring they run on a
+// pool of threads with pread() and pwrite(). Either way the AkAIOCallback
+// is called from one of these threads.
+//
+// Init() creates a streaming device (by calling AK::StreamMgr::CreateDevice()).
+// If there was no AK::StreamMgr::IAkFileLocationResolver previously registered
+// to the Stream Manager, this object registers itself as the File Location Resolver.
+//
+//////////////////////////////////////////////////////////////////////
+
+// #include "stdafx.h"
+#include "AkDefaultIOHookDeferred.h"
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include "AkFileHelpers.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(AK_IOHOOK_IO_URING)
+#include <sys/mman.h>
+#endif
+
+// Device info.
+#define POSIX_DEFERRED_DEVICE_NAME		("POSIX Deferred")	// Default deferred device name.
+
+// Completions that aren't transfers. Transfers carry the address of their CAkDefaultIOHookDeferred::Transfer.
+static const AkUInt64 k_uWakeUserData = 0;
+static const AkUInt64 k_uCancelUserData = 1;
+
+// Reads or writes until done, the end of the file or an error. Returns the bytes transferred, or -errno.
+static AkInt64 TransferBlocking(int in_iFd, bool in_bWrite, char* in_pBuffer, AkUInt64 in_uPosition, AkUInt32 in_uSize)
+{
+	AkUInt32 uDone = 0;
+	while (uDone < in_uSize)
+	{
+		ssize_t iTransferred = in_bWrite
+			? ::pwrite(in_iFd, in_pBuffer + uDone, in_uSize - uDone, (off_t)(in_uPosition + uDone))
+			: ::pread(in_iFd, in_pBuffer + uDone, in_uSize - uDone, (off_t)(in_uPosition + uDone));
+
+		if (iTransferred < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return -(AkInt64)errno;
+		}
+
+		if (iTransferred == 0)
+			break; // End of file
+
+		uDone += (AkUInt32)iTransferred;
+	}
+
+	return uDone;
+}
+
+CAkDefaultIOHookDeferred::CAkDefaultIOHookDeferred()
+: m_deviceID( AK_INVALID_DEVICE_ID )
+, m_bUseRing( false )
+, m_bStopThreads( false )
+, m_pQueueFirst( nullptr )
+, m_pQueueLast( nullptr )
+, m_bPoolStarted( false )
+, m_uNumPoolThreads( 0 )
+{
+#if defined(AK_IOHOOK_IO_URING)
+	memset(&m_ring, 0, sizeof(m_ring));
+	m_ring.iFd = -1;
+	AKPLATFORM::AkClearThread(&m_completionThread);
+#endif
+	for (AkUInt32 i = 0; i < k_uNumPoolThreads; ++i)
+		AKPLATFORM::AkClearThread(&m_poolThreads[i]);
+}
+
+CAkDefaultIOHookDeferred::~CAkDefaultIOHookDeferred()
+{
+}
+
+// Initialization/termination. Init() registers this object as the one and
+// only File Location Resolver if none were registered before. Then
+// it creates a streaming device.
+AKRESULT CAkDefaultIOHookDeferred::Init(
+	const AkDeviceSettings &	in_deviceSettings,		// Device settings.
+	bool						in_bAllowIoUring		// False to always use the pread() thread pool.
+	)
+{
+	// A slot is released after its callback, which may already have queued the next transfer.
+	AKRESULT poolResult = m_transferPool.Init(in_deviceSettings.uMaxConcurrentIO * 2);
+	if (poolResult != AK_Success)
+		return poolResult;
+
+	AKRESULT eResult = StartThreads(in_deviceSettings.uMaxConcurrentIO, in_bAllowIoUring);
+	if (eResult != AK_Success)
+	{
+		StopThreads();
+		m_transferPool.Term();
+		return eResult;
+	}
+
+	// If the Stream Manager's File Location Resolver was not set yet, set this object as the
+	// File Location Resolver (this I/O hook is also able to resolve file location).
+	if ( !AK::StreamMgr::GetFileLocationResolver() )
+		AK::StreamMgr::SetFileLocationResolver( this );
+
+	// Create a device in the Stream Manager, specifying this as the hook.
+	return AK::StreamMgr::CreateDevice( in_deviceSettings, this, m_deviceID);
+}
+
+void CAkDefaultIOHookDeferred::Term()
+{
+	CAkMultipleFileLocation::Term();
+
+	if ( AK::StreamMgr::GetFileLocationResolver() == this )
+		AK::StreamMgr::SetFileLocationResolver( NULL );
+
+	// The device waits for the transfers in flight, so the threads have nothing left to complete.
+	AK::StreamMgr::DestroyDevice( m_deviceID );
+	StopThreads();
+	m_transferPool.Term();
+}
+
+AKRESULT CAkDefaultIOHookDeferred::StartThreads(AkUInt32 in_uMaxConcurrentIO, bool in_bAllowIoUring)
+{
+	m_bStopThreads = false;
+
+	AkThreadProperties threadProperties;
+	AKPLATFORM::AkGetDefaultThreadProperties(threadProperties);
+
+#if defined(AK_IOHOOK_IO_URING)
+	m_bUseRing = in_bAllowIoUring && InitRing(in_uMaxConcurrentIO);
+	if (m_bUseRing)
+	{
+		AKPLATFORM::AkCreateThread(
+			CompletionThread,
+			this,
+			threadProperties,
+			&m_completionThread,
+			"AK::IOHookDeferred::Completion");
+
+		return AKPLATFORM::AkIsValidThread(&m_completionThread) ? AK_Success : AK_Fail;
+	}
+#else
+	(void)in_uMaxConcurrentIO;
+	(void)in_bAllowIoUring;
+#endif
+
+	if (AKPLATFORM::AkCreateSemaphore(m_queueSemaphore, 0) != AK_Success)
+		return AK_Fail;
+	m_bPoolStarted = true;
+
+	for (AkUInt32 i = 0; i < k_uNumPoolThreads; ++i)
+	{
+		char threadName[32];
+		snprintf(threadName, 32, "AK::IOHookDeferred::Pool-%u", i);
+		AKPLATFORM::AkCreateThread(
+			PoolThread,
+			this,
+			threadProperties,
+			&m_poolThreads[i],
+			threadName);
+
+		if (!AKPLATFORM::AkIsValidThread(&m_poolThreads[i]))
+			return AK_Fail;
+
+		++m_uNumPoolThreads;
+	}
+
+	return AK_Success;
+}
+
+void CAkDefaultIOHookDeferred::StopThreads()
+{
+	m_bStopThreads = true;
+
+#if defined(AK_IOHOOK_IO_URING)
+	if (AKPLATFORM::AkIsValidThread(&m_completionThread))
+	{
+		// Wake the completion thread up with a completion of its own
+		{
+			AkAutoLock<CAkLock> lock(m_lock);
+			io_uring_sqe* pSqe = GetRingSqe();
+			AKASSERT(pSqe);
+			if (pSqe)
+			{
+				pSqe->opcode = IORING_OP_NOP;
+				pSqe->user_data = k_uWakeUserData;
+				SubmitRing(1);
+			}
+		}
+
+		AKPLATFORM::AkWaitForSingleThread(&m_completionThread);
+		AKPLATFORM::AkCloseThread(&m_completionThread);
+		AKPLATFORM::AkClearThread(&m_completionThread);
+	}
+
+	TermRing();
+#endif
+
+	if (m_bPoolStarted)
+	{
+		// Each thread leaves when it wakes up to an empty queue
+		if (m_uNumPoolThreads > 0)
+			AKPLATFORM::AkReleaseSemaphore(m_queueSemaphore, m_uNumPoolThreads);
+
+		for (AkUInt32 i = 0; i < m_uNumPoolThreads; ++i)
+		{
+			AKPLATFORM::AkWaitForSingleThread(&m_poolThreads[i]);
+			AKPLATFORM::AkCloseThread(&m_poolThreads[i]);
+			AKPLATFORM::AkClearThread(&m_poolThreads[i]);
+		}
+
+		AKPLATFORM::AkDestroySemaphore(m_queueSemaphore);
+		m_uNumPoolThreads = 0;
+		m_bPoolStarted = false;
+	}
+
+	m_bUseRing = false;
+}
+
+#if defined(AK_IOHOOK_IO_URING)
+
+bool CAkDefaultIOHookDeferred::InitRing(AkUInt32 in_uMaxConcurrentIO)
+{
+	// Room for a cancel next to every transfer, and for the wake-up at Term()
+	AkUInt32 uNumEntries = 1;
+	while (uNumEntries < in_uMaxConcurrentIO * 2 + 1)
+		uNumEntries <<= 1;
+
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	int iFd = (int)syscall(__NR_io_uring_setup, uNumEntries, &params);
+	if (iFd < 0)
+		return false; // ENOSYS before Linux 5.1, EPERM where it's disabled
+
+	m_ring.iFd = iFd;
+
+	// IORING_OP_READ and IORING_OP_WRITE came in 5.6, the first feature flag from a later kernel is IORING_FEAT_FAST_POLL
+	if ((params.features & IORING_FEAT_FAST_POLL) == 0)
+	{
+		TermRing();
+		return false;
+	}
+
+	m_ring.uNumEntries = params.sq_entries;
+	m_ring.uSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_ring.uCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	m_ring.uSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+	const bool bSingleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (bSingleMmap)
+	{
+		if (m_ring.uCqRingSize > m_ring.uSqRingSize)
+			m_ring.uSqRingSize = m_ring.uCqRingSize;
+		m_ring.uCqRingSize = m_ring.uSqRingSize;
+	}
+
+	void* pSqRing = mmap(nullptr, m_ring.uSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iFd, IORING_OFF_SQ_RING);
+	if (pSqRing == MAP_FAILED)
+	{
+		TermRing();
+		return false;
+	}
+	m_ring.pSqRing = pSqRing;
+
+	void* pCqRing = bSingleMmap ? pSqRing : mmap(nullptr, m_ring.uCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iFd, IORING_OFF_CQ_RING);
+	if (pCqRing == MAP_FAILED)
+	{
+		TermRing();
+		return false;
+	}
+	m_ring.pCqRing = pCqRing;
+
+	void* pSqes = mmap(nullptr, m_ring.uSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iFd, IORING_OFF_SQES);
+	if (pSqes == MAP_FAILED)
+	{
+		TermRing();
+		return false;
+	}
+	m_ring.pSqes = (io_uring_sqe*)pSqes;
+
+	char* pSq = (char*)pSqRing;
+	m_ring.puSqHead = (unsigned*)(pSq + params.sq_off.head);
+	m_ring.puSqTail = (unsigned*)(pSq + params.sq_off.tail);
+	m_ring.puSqMask = (unsigned*)(pSq + params.sq_off.ring_mask);
+	m_ring.puSqArray = (unsigned*)(pSq + params.sq_off.array);
+	m_ring.uSqLocalTail = *m_ring.puSqTail;
+
+	char* pCq = (char*)pCqRing;
+	m_ring.puCqHead = (unsigned*)(pCq + params.cq_off.head);
+	m_ring.puCqTail = (unsigned*)(pCq + params.cq_off.tail);
+	m_ring.puCqMask = (unsigned*)(pCq + params.cq_off.ring_mask);
+	m_ring.pCqes = (io_uring_cqe*)(pCq + params.cq_off.cqes);
+
+	return true;
+}
+
+void CAkDefaultIOHookDeferred::TermRing()
+{
+	if (m_ring.pSqes)
+		munmap(m_ring.pSqes, m_ring.uSqesSize);
+	if (m_ring.pCqRing && m_ring.pCqRing != m_ring.pSqRing)
+		munmap(m_ring.pCqRing, m_ring.uCqRingSize);
+	if (m_ring.pSqRing)
+		munmap(m_ring.pSqRing, m_ring.uSqRingSize);
+	if (m_ring.iFd >= 0)
+		close(m_ring.iFd);
+
+	memset(&m_ring, 0, sizeof(m_ring));
+	m_ring.iFd = -1;
+}
+
+io_uring_sqe* CAkDefaultIOHookDeferred::GetRingSqe()
+{
+	const unsigned uHead = __atomic_load_n(m_ring.puSqHead, __ATOMIC_ACQUIRE);
+	if (m_ring.uSqLocalTail - uHead >= m_ring.uNumEntries)
+		return nullptr;
+
+	const unsigned uIndex = m_ring.uSqLocalTail & *m_ring.puSqMask;
+	m_ring.puSqArray[uIndex] = uIndex;
+	++m_ring.uSqLocalTail;
+
+	io_uring_sqe* pSqe = &m_ring.pSqes[uIndex];
+	memset(pSqe, 0, sizeof(*pSqe));
+	return pSqe;
+}
+
+void CAkDefaultIOHookDeferred::SubmitRing(AkUInt32 in_uNumSqes)
+{
+	__atomic_store_n(m_ring.puSqTail, m_ring.uSqLocalTail, __ATOMIC_RELEASE);
+
+	// Without SQPOLL the kernel takes the submissions during the call, so they're all gone when it returns
+	while (in_uNumSqes > 0)
+	{
+		int iSubmitted = (int)syscall(__NR_io_uring_enter, m_ring.iFd, in_uNumSqes, 0, 0, nullptr, 0);
+		if (iSubmitted < 0)
+		{
+			// Out of kernel resources for now, or the completion ring is full until the completion thread catches up
+			if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+			{
+				AkThreadYield();
+				continue;
+			}
+
+			AKASSERT( !"io_uring_enter failed" );
+			return;
+		}
+
+		in_uNumSqes -= (AkUInt32)iSubmitted;
+	}
+}
+
+AK_DECLARE_THREAD_ROUTINE(CAkDefaultIOHookDeferred::CompletionThread)
+{
+	CAkDefaultIOHookDeferred& ioHook = *AK_GET_THREAD_ROUTINE_PARAMETER_PTR(CAkDefaultIOHookDeferred);
+	IoRing& ring = ioHook.m_ring;
+
+	AK::MemoryMgr::InitForThread();
+
+	for (;;)
+	{
+		unsigned uHead = *ring.puCqHead;
+		const unsigned uTail = __atomic_load_n(ring.puCqTail, __ATOMIC_ACQUIRE);
+		if (uHead == uTail)
+		{
+			if (ioHook.m_bStopThreads)
+				break;
+
+			// Sleep until the next completion
+			syscall(__NR_io_uring_enter, ring.iFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+			continue;
+		}
+
+		for (; uHead != uTail; ++uHead)
+		{
+			const io_uring_cqe& cqe = ring.pCqes[uHead & *ring.puCqMask];
+			const AkUInt64 uUserData = cqe.user_data;
+			const AkInt64 iResult = cqe.res;
+
+			// Hand the entry back before the callback, which may queue more transfers
+			__atomic_store_n(ring.puCqHead, uHead + 1, __ATOMIC_RELEASE);
+
+			if (uUserData != k_uWakeUserData && uUserData != k_uCancelUserData)
+				ioHook.FinishTransfer((Transfer*)(AkUIntPtr)uUserData, iResult);
+		}
+	}
+
+	AK::MemoryMgr::TermForThread();
+	AkExitThread(AK_RETURN_THREAD_OK);
+}
+
+#endif
+
+AK_DECLARE_THREAD_ROUTINE(CAkDefaultIOHookDeferred::PoolThread)
+{
+	CAkDefaultIOHookDeferred& ioHook = *AK_GET_THREAD_ROUTINE_PARAMETER_PTR(CAkDefaultIOHookDeferred);
+
+	AK::MemoryMgr::InitForThread();
+
+	for (;;)
+	{
+		AKPLATFORM::AkWaitForSemaphore(ioHook.m_queueSemaphore);
+
+		Transfer* pTransfer;
+		{
+			AkAutoLock<CAkLock> lock(ioHook.m_lock);
+			pTransfer = ioHook.m_pQueueFirst;
+			if (pTransfer)
+			{
+				ioHook.m_pQueueFirst = pTransfer->pNextItem;
+				if (!ioHook.m_pQueueFirst)
+					ioHook.m_pQueueLast = nullptr;
+			}
+		}
+
+		// Only StopThreads() wakes a thread without queueing a transfer
+		if (!pTransfer)
+			break;
+
+		ioHook.FinishTransfer(pTransfer, 0);
+	}
+
+	AK::MemoryMgr::TermForThread();
+	AkExitThread(AK_RETURN_THREAD_OK);
+}
+
+CAkDefaultIOHookDeferred::Transfer* CAkDefaultIOHookDeferred::QueueTransfer(
+	AkFileDesc & in_fileDesc,
+	AkAsyncIOTransferInfo & in_info,
+	bool in_bWrite
+	)
+{
+	Transfer* pTransfer = m_transferPool.Allocate();
+	AKASSERT( pTransfer || !"Too many concurrent transfers in the Low-Level IO" );
+	if (!pTransfer)
+		return nullptr;
+
+	pTransfer->pInfo = &in_info;
+	pTransfer->iFd = fileno(in_fileDesc.hFile);
+	pTransfer->bWrite = in_bWrite;
+	pTransfer->pNextItem = nullptr;
+
+#if defined(AK_IOHOOK_IO_URING)
+	if (m_bUseRing)
+	{
+		io_uring_sqe* pSqe = GetRingSqe();
+		AKASSERT( pSqe || !"Too many concurrent transfers in the Low-Level IO" );
+		if (!pSqe)
+		{
+			m_transferPool.Deallocate(pTransfer);
+			return nullptr;
+		}
+
+		pSqe->opcode = in_bWrite ? IORING_OP_WRITE : IORING_OP_READ;
+		pSqe->fd = pTransfer->iFd;
+		pSqe->addr = (AkUInt64)(AkUIntPtr)in_info.pBuffer;
+		pSqe->len = in_info.uRequestedSize;
+		pSqe->off = in_info.uFilePosition;
+		pSqe->user_data = (AkUInt64)(AkUIntPtr)pTransfer;
+		return pTransfer;
+	}
+#endif
+
+	if (m_pQueueLast)
+		m_pQueueLast->pNextItem = pTransfer;
+	else
+		m_pQueueFirst = pTransfer;
+	m_pQueueLast = pTransfer;
+
+	return pTransfer;
+}
+
+void CAkDefaultIOHookDeferred::Submit(AkUInt32 in_uNumTransfers, BatchIoTransferItem* in_pTransferItems, bool in_bWrite)
+{
+	AkUInt32 uNumQueued = 0;
+	{
+		AkAutoLock<CAkLock> lock(m_lock);
+		for (AkUInt32 i = 0; i < in_uNumTransfers; ++i)
+		{
+			AkFileDesc& fileDesc = *in_pTransferItems[i].pFileDesc;
+			AkAsyncIOTransferInfo& info = *in_pTransferItems[i].pTransferInfo;
+			AKASSERT( fileDesc.hFile
+					&& info.uRequestedSize > 0
+					&& info.uBufferSize >= info.uRequestedSize );
+
+			info.pUserData = QueueTransfer(fileDesc, info, in_bWrite);
+			if (info.pUserData)
+				++uNumQueued;
+		}
+
+#if defined(AK_IOHOOK_IO_URING)
+		// The whole batch in one system call
+		if (m_bUseRing && uNumQueued > 0)
+			SubmitRing(uNumQueued);
+#endif
+	}
+
+	if (!m_bUseRing && uNumQueued > 0)
+		AKPLATFORM::AkReleaseSemaphore(m_queueSemaphore, uNumQueued);
+
+	// No completion will come for the transfers that found no slot, complete them now.
+	if (uNumQueued < in_uNumTransfers)
+	{
+		for (AkUInt32 i = 0; i < in_uNumTransfers; ++i)
+		{
+			AkAsyncIOTransferInfo& info = *in_pTransferItems[i].pTransferInfo;
+			if (!info.pUserData)
+				info.pCallback(&info, AK_InsufficientMemory);
+		}
+	}
+}
+
+void CAkDefaultIOHookDeferred::FinishTransfer(Transfer* in_pTransfer, AkInt64 in_iResult)
+{
+	AkAsyncIOTransferInfo* pInfo = in_pTransfer->pInfo;
+
+	// io_uring may stop short, the pool threads do the whole transfer here
+	AkInt64 iResult = in_iResult;
+	if (iResult >= 0 && (AkUInt64)iResult < pInfo->uRequestedSize)
+	{
+		AkInt64 iRest = TransferBlocking(
+			in_pTransfer->iFd,
+			in_pTransfer->bWrite,
+			(char*)pInfo->pBuffer + iResult,
+			pInfo->uFilePosition + iResult,
+			pInfo->uRequestedSize - (AkUInt32)iResult);
+		iResult = iRest < 0 ? iRest : iResult + iRest;
+	}
+
+	AKRESULT eResult = AK_Success;
+	if (iResult < 0)
+		eResult = (iResult == -EACCES || iResult == -EPERM) ? AK_FilePermissionError : AK_Fail;
+	else if ((AkUInt64)iResult < pInfo->uRequestedSize)
+		eResult = AK_Fail; // The file ended before the transfer did
+
+	pInfo->pCallback(pInfo, eResult);
+
+	// Released after the callback, before which the transfer may still be cancelled (see BatchCancel())
+	AkAutoLock<CAkLock> lock(m_lock);
+	m_transferPool.Deallocate(in_pTransfer);
+}
+
+//This should always be overridden by the final child class to create the correct type, a descendent of AkFileDesc.
+AkFileDesc* CAkDefaultIOHookDeferred::CreateDescriptor(const AkFileDesc* in_pCopy)
+{
+	if (!in_pCopy)
+		return AkNew(AkMemID_Streaming, AkFileDescType());
+
+	return AkNew(AkMemID_Streaming, AkFileDescType(*(AkFileDescType*)in_pCopy));
+}
+
+//
+// IAkFileLocationAware implementation.
+//-----------------------------------------------------------------------------
+
+AKRESULT CAkDefaultIOHookDeferred::OutputSearchedPaths(
+	AKRESULT /*in_result*/,
+	const AkFileOpenData& in_FileOpen,
+	AkOSChar* out_searchedPath,
+	AkInt32 in_pathSize
+)
+{
+	return CAkMultipleFileLocation::OutputSearchedPaths(in_FileOpen, out_searchedPath, in_pathSize);
+}
+
+//
+// IAkLowLevelIOHook implementation.
+//-----------------------------------------------------------------------------
+
+AKRESULT CAkDefaultIOHookDeferred::Open(const AkFileOpenData& in_FileOpen, AkFileDesc*& out_pFileDesc)
+{
+	out_pFileDesc = CreateDescriptor();
+	if (!out_pFileDesc)
+		return AK_InsufficientMemory;
+
+	AKRESULT eResult = CAkMultipleFileLocation::Open(in_FileOpen, true, *out_pFileDesc);
+	if (eResult == AK_Success)
+	{
+		out_pFileDesc->deviceID = m_deviceID;
+	}
+	else
+	{
+		AkDelete(AkMemID_Streaming, out_pFileDesc);
+		out_pFileDesc = nullptr;
+	}
+
+	return eResult;
+}
+
+// Close a file.
+AKRESULT CAkDefaultIOHookDeferred::Close(
+    AkFileDesc * in_pFileDesc      // File descriptor.
+    )
+{
+	if (in_pFileDesc)
+	{
+		CAkFileHelpers::CloseFile(*in_pFileDesc);
+		AkDelete(AkMemID_Streaming, in_pFileDesc);
+	}
+	return AK_Success;
+}
+
+// Returns the block size for the file or its storage device.
+AkUInt32 CAkDefaultIOHookDeferred::GetBlockSize(
+    AkFileDesc &  /*in_fileDesc*/     // File descriptor.
+    )
+{
+	return 1;
+}
+
+// Returns a description for the streaming device above this low-level hook.
+void CAkDefaultIOHookDeferred::GetDeviceDesc(
+    AkDeviceDesc &
+#ifndef AK_OPTIMIZED
+	out_deviceDesc      // Description of associated low-level I/O device.
+#endif
+    )
+{
+#ifndef AK_OPTIMIZED
+	AKASSERT( m_deviceID != AK_INVALID_DEVICE_ID || !"Low-Level device was not initialized" );
+
+	// Deferred scheduler.
+	out_deviceDesc.deviceID       = m_deviceID;
+	out_deviceDesc.bCanRead       = true;
+	out_deviceDesc.bCanWrite      = true;
+	AK_CHAR_TO_UTF16( out_deviceDesc.szDeviceName, POSIX_DEFERRED_DEVICE_NAME, AK_MONITOR_DEVICENAME_MAXLENGTH );
+	out_deviceDesc.uStringSize   = (AkUInt32)AKPLATFORM::AkUtf16StrLen( out_deviceDesc.szDeviceName ) + 1;
+#endif
+}
+
+// Returns custom profiling data: 1 if file opens are asynchronous, 0 otherwise.
+AkUInt32 CAkDefaultIOHookDeferred::GetDeviceData()
+{
+	return 1;
+}
+
+void CAkDefaultIOHookDeferred::BatchOpen(AkUInt32 in_uNumFiles, AkAsyncFileOpenData** in_ppItems)
+{
+	for (int i = 0; i < (int)in_uNumFiles; i++)
+	{
+		AkAsyncFileOpenData* pItem = in_ppItems[i];
+		AKRESULT eResult = Open(*pItem, pItem->pFileDesc);
+		pItem->pCallback(pItem, eResult);
+	}
+}
+
+void CAkDefaultIOHookDeferred::BatchRead(AkUInt32 in_uNumTransfers, BatchIoTransferItem* in_pTransferItems)
+{
+	Submit(in_uNumTransfers, in_pTransferItems, false);
+}
+
+void CAkDefaultIOHookDeferred::BatchWrite(AkUInt32 in_uNumTransfers, BatchIoTransferItem* in_pTransferItems)
+{
+	Submit(in_uNumTransfers, in_pTransferItems, true);
+}
+
+// Cancels each transfer still in the ring. io_bCancelAllTransfersForThisFile is left as is: the other
+// transfers of the file complete normally and are flushed by the streaming device. Transfers on the pool
+// threads aren't interrupted either.
+void CAkDefaultIOHookDeferred::BatchCancel(
+	AkUInt32						in_uNumTransfers,
+	BatchIoTransferItem* in_pTransferItems,
+	bool** /*io_ppbCancelAllTransfersForThisFile*/
+)
+{
+#if defined(AK_IOHOOK_IO_URING)
+	if (!m_bUseRing)
+		return;
+
+	// The slot of a transfer is only released after its callback, so it can't have been reused by another
+	// transfer until the cancel has gone through.
+	AkAutoLock<CAkLock> lock(m_lock);
+	AkUInt32 uNumSqes = 0;
+	for (AkUInt32 i = 0; i < in_uNumTransfers; ++i)
+	{
+		Transfer* pTransfer = (Transfer*)in_pTransferItems[i].pTransferInfo->pUserData;
+		io_uring_sqe* pSqe = pTransfer ? GetRingSqe() : nullptr;
+		if (!pSqe)
+			continue;
+
+		pSqe->opcode = IORING_OP_ASYNC_CANCEL;
+		pSqe->addr = (AkUInt64)(AkUIntPtr)pTransfer;
+		pSqe->user_data = k_uCancelUserData;
+		++uNumSqes;
+	}
+
+	if (uNumSqes > 0)
+		SubmitRing(uNumSqes);
+#else
+	(void)in_uNumTransfers;
+	(void)in_pTransferItems;
+#endif
+}
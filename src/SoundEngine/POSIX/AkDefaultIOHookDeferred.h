@@ -0,0 +1,239 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkDefaultIOHookDeferred.h
+//
+// Default deferred low level IO hook (AK::StreamMgr::IAkLowLevelIOHook)
+// and file system (AK::StreamMgr::IAkFileLocationResolver) implementation
+// on POSIX.
+//
+// AK::StreamMgr::IAkFileLocationResolver:
+// Resolves file location using simple path concatenation logic.
+// It can be used as a standalone
+// Low-Level IO system, or as part of a multi device system.
+// In the latter case, you should manage multiple devices by implementing
+// AK::StreamMgr::IAkFileLocationResolver elsewhere (you may take a look
+// at class CAkDefaultLowLevelIODispatcher).
+//
+// AK::StreamMgr::IAkLowLevelIOHook:
+// On Linux, each BatchRead() or BatchWrite() is queued to an io_uring and
+// submitted with a single io_uring_enter() call. A completion thread reaps
+// the completions and calls the AkAIOCallback of each transfer.
+// Where io_uring is unavailable (older kernels, seccomp filters, other
+// POSIX platforms), transfers are queued to a small pool of threads that
+// run them with pread() and pwrite() and then call the AkAIOCallback.
+//
+// Init() creates a streaming device (by calling AK::StreamMgr::CreateDevice()).
+// If there was no AK::StreamMgr::IAkFileLocationResolver previously registered
+// to the Stream Manager, this object registers itself as the File Location Resolver.
+//
+// See the Win32 version of this file for initialization examples, they
+// are the same on all platforms.
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef _AK_DEFAULT_IO_HOOK_DEFERRED_H_
+#define _AK_DEFAULT_IO_HOOK_DEFERRED_H_
+
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include "../Common/AkMultipleFileLocation.h"
+#include <AK/Tools/Common/AkAssert.h>
+#include <AK/Tools/Common/AkLock.h>
+#include <AK/Tools/Common/AkObject.h>
+#include <AK/Tools/Common/AkObjectPool.h>
+
+#include <stddef.h>
+
+// io_uring needs a kernel header recent enough for IORING_FEAT_FAST_POLL (Linux 5.7) and
+// IORING_OP_READ, and a libc that knows the syscall numbers. Otherwise the pool threads run the transfers.
+#if defined(AK_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(IORING_FEAT_FAST_POLL) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define AK_IOHOOK_IO_URING
+#endif
+#endif
+#endif
+
+//-----------------------------------------------------------------------------
+// Name: class CAkDefaultIOHookDeferred.
+// Desc: Implements IAkLowLevelIOHook low-level I/O hook, and
+//		 IAkFileLocationResolver. Can be used as a standalone Low-Level I/O
+//		 system, or as part of a system with multiple devices.
+//		 File location is resolved using simple path concatenation logic.
+//-----------------------------------------------------------------------------
+class CAkDefaultIOHookDeferred : public AK::StreamMgr::IAkFileLocationResolver
+								,public AK::StreamMgr::IAkLowLevelIOHook
+								,public CAkMultipleFileLocation
+{
+public:
+
+	typedef AkFileDesc AkFileDescType;
+
+	CAkDefaultIOHookDeferred();
+	virtual ~CAkDefaultIOHookDeferred();
+
+	// Initialization/termination. Init() registers this object as the one and
+	// only File Location Resolver if none were registered before. Then
+	// it creates a streaming device.
+	AKRESULT Init(
+		const AkDeviceSettings &	in_deviceSettings,	// Device settings.
+		bool						in_bAllowIoUring = true	// False to always use the pread() thread pool.
+		);
+	void Term();
+
+	// Whether transfers go through io_uring, rather than the pread() thread pool. Valid after Init().
+	bool UsesIoUring() const { return m_bUseRing; }
+
+	// Allow creation of specialized AkFileDesc class for derivatives of this class.
+	// Default implementation allocates a AkFileDesc with AkNew, which should be freed in Close().
+	virtual AkFileDesc* CreateDescriptor(const AkFileDesc* in_pCopy = nullptr);
+
+	//
+	// IAkFileLocationAware interface.
+	//-----------------------------------------------------------------------------
+
+	virtual AKRESULT OutputSearchedPaths(
+		AKRESULT in_result,						///< Result of the open call
+		const AkFileOpenData& in_FileOpen,		///< File name or file ID (only one should be valid!), open flags, open mode
+		AkOSChar* out_searchedPath,				///< String containing all searched paths
+		AkInt32 in_pathSize						///< The maximum size of the string
+	);
+
+	//
+	// IAkLowLevelIOHook interface.
+	//-----------------------------------------------------------------------------
+
+	// Cleans up a file.
+	virtual AKRESULT Close(
+        AkFileDesc *			in_pFileDesc		// File descriptor.
+        ) override;
+
+	// Returns the block size for the file or its storage device.
+	virtual AkUInt32 GetBlockSize(
+        AkFileDesc &  			in_fileDesc			// File descriptor.
+        ) override;
+
+	// Returns a description for the streaming device above this low-level hook.
+    virtual void GetDeviceDesc(
+        AkDeviceDesc &  		out_deviceDesc      // Description of associated low-level I/O device.
+        ) override;
+
+	// Returns custom profiling data: 1 if file opens are asynchronous, 0 otherwise.
+	virtual AkUInt32 GetDeviceData() override;
+
+	virtual void BatchOpen(AkUInt32 in_uNumFiles, AkAsyncFileOpenData** in_ppItems) override;
+
+	virtual void BatchRead(AkUInt32 in_uNumTransfers, BatchIoTransferItem* in_pTransferItems) override;
+
+	virtual void BatchWrite(AkUInt32 in_uNumTransfers, BatchIoTransferItem* in_pTransferItems) override;
+
+	virtual void BatchCancel(AkUInt32 in_uNumTransfers, BatchIoTransferItem* in_pTransferItems, bool** io_ppbCancelAllTransfersForThisFile) override;
+
+protected:
+
+	// Threads running transfers when io_uring is unavailable.
+	static const AkUInt32 k_uNumPoolThreads = 4;
+
+	// Bookkeeping of a transfer in flight. AkAsyncIOTransferInfo::pUserData points to it.
+	struct Transfer
+	{
+		AkAsyncIOTransferInfo* pInfo;
+		int iFd;
+		bool bWrite;
+		Transfer* pNextItem;	// In the queue of the pool threads
+	};
+
+	using TransferPool = AK::ObjectPool<Transfer, AK::ObjectPoolDefaultAllocator<AkMemID_Streaming>>;
+
+	AKRESULT StartThreads(AkUInt32 in_uMaxConcurrentIO, bool in_bAllowIoUring);
+	void StopThreads();
+
+	// Queues one transfer to the ring or to the pool threads. Call with m_lock held. Returns nullptr if out of slots.
+	Transfer* QueueTransfer(AkFileDesc& in_fileDesc, AkAsyncIOTransferInfo& in_info, bool in_bWrite);
+	void Submit(AkUInt32 in_uNumTransfers, BatchIoTransferItem* in_pTransferItems, bool in_bWrite);
+
+	// Completes what's left of a transfer past the in_iResult bytes done, or its -errno, then calls back and releases it.
+	void FinishTransfer(Transfer* in_pTransfer, AkInt64 in_iResult);
+
+	static AK_DECLARE_THREAD_ROUTINE(PoolThread);
+
+#if defined(AK_IOHOOK_IO_URING)
+	// The rings shared with the kernel, set up without liburing.
+	struct IoRing
+	{
+		int iFd;
+		AkUInt32 uNumEntries;
+		AkUInt32 uSqLocalTail;	// Past the last queued submission, published by SubmitRing()
+
+		unsigned* puSqHead;
+		unsigned* puSqTail;
+		unsigned* puSqMask;
+		unsigned* puSqArray;
+		io_uring_sqe* pSqes;
+
+		unsigned* puCqHead;
+		unsigned* puCqTail;
+		unsigned* puCqMask;
+		io_uring_cqe* pCqes;
+
+		void* pSqRing;
+		size_t uSqRingSize;
+		void* pCqRing;		// Same as pSqRing with IORING_FEAT_SINGLE_MMAP
+		size_t uCqRingSize;
+		size_t uSqesSize;
+	};
+
+	bool InitRing(AkUInt32 in_uMaxConcurrentIO);
+	void TermRing();
+
+	// Submissions are queued with GetRingSqe() and handed to the kernel together by SubmitRing(). Call both with m_lock held.
+	io_uring_sqe* GetRingSqe();
+	void SubmitRing(AkUInt32 in_uNumSqes);
+
+	static AK_DECLARE_THREAD_ROUTINE(CompletionThread);
+
+	IoRing				m_ring;
+	AkThread			m_completionThread;
+#endif
+
+	AkDeviceID			m_deviceID;
+	bool				m_bUseRing;
+	volatile bool		m_bStopThreads;
+
+	// Guards the transfer slots, the ring submissions and the queue of the pool threads.
+	// Transfers complete on other threads than the ones submitting or cancelling them.
+	CAkLock				m_lock;
+	TransferPool		m_transferPool;
+
+	// Queue of the pool threads, first in first out. The semaphore counts its items.
+	Transfer*			m_pQueueFirst;
+	Transfer*			m_pQueueLast;
+	AkSemaphore			m_queueSemaphore;
+	bool				m_bPoolStarted;
+	AkThread			m_poolThreads[k_uNumPoolThreads];
+	AkUInt32			m_uNumPoolThreads;
+
+	// Open a file (synchronous)
+	// This is a helper for subclasses.
+	// Note: In this implementation, Open is ALWAYS synchronous, so subclasses can rely on the return code to know the result of the operation.
+	virtual AKRESULT Open(
+		const AkFileOpenData& in_FileOpen,		///< File open information (name, flags, etc)
+		AkFileDesc*& out_pFileDesc              ///< File descriptor produced
+	);
+};
+
+#endif //_AK_DEFAULT_IO_HOOK_DEFERRED_H_
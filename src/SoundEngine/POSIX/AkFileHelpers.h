@@ -0,0 +1,283 @@
+/*******************************************************************************
+The content of this file includes portions of the AUDIOKINETIC Wwise Technology
+released in source code form as part of the SDK installer package.
+
+Commercial License Usage
+
+Licensees holding valid commercial licenses to the AUDIOKINETIC Wwise Technology
+may use this file in accordance with the end user license agreement provided
+with the software or, alternatively, in accordance with the terms contained in a
+written agreement between you and Audiokinetic Inc.
+
+  Copyright (c) 2023 Audiokinetic Inc.
+*******************************************************************************/
+//////////////////////////////////////////////////////////////////////
+//
+// AkFileHelpers.h
+//
+// Platform-specific helpers for files.
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef _AK_FILE_HELPERS_H_
+#define _AK_FILE_HELPERS_H_
+
+#include "../Common/AkFileHelpersBase.h"
+
+#include <AK/Tools/Common/AkAssert.h>
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+class CAkFileHelpers : public CAkFileHelpersBase
+{
+public:
+	// Wrapper for open() and fdopen(). Transfers go through fileno() of the handle, so the stdio buffer is never used.
+	static AKRESULT OpenFile(
+        const AkOSChar* in_pszFilename,     // File name.
+        AkOpenMode      in_eOpenMode,       // Open mode.
+        bool            /*in_bOverlappedIO*/, // Unused: any descriptor can be read asynchronously.
+        AkFileHandle &  out_hFile           // Returned file identifier/handle.
+        )
+	{
+		// Check parameters.
+		if ( !in_pszFilename )
+		{
+			AKASSERT( !"NULL file name" );
+			return AK_InvalidParameter;
+		}
+
+		// Open mode
+		int iFlags;
+		const char* szMode;
+		switch ( in_eOpenMode )
+		{
+			case AK_OpenModeRead:
+					iFlags = O_RDONLY;
+					szMode = "rb";
+				break;
+			case AK_OpenModeWrite:
+					iFlags = O_WRONLY | O_CREAT;
+					szMode = "wb";
+				break;
+			case AK_OpenModeWriteOvrwr:
+					iFlags = O_WRONLY | O_CREAT | O_TRUNC;
+					szMode = "wb";
+				break;
+			case AK_OpenModeReadWrite:
+					iFlags = O_RDWR | O_CREAT;
+					szMode = "r+b";
+				break;
+			default:
+					AKASSERT( !"Invalid open mode" );
+					out_hFile = NULL;
+					return AK_InvalidParameter;
+				break;
+		}
+
+		int iFd = ::open( in_pszFilename, iFlags | O_CLOEXEC, 0644 );
+		if ( iFd < 0 )
+		{
+			out_hFile = NULL;
+			return ErrorToResult( errno );
+		}
+
+		// fdopen() doesn't truncate, whatever the mode.
+		out_hFile = ::fdopen( iFd, szMode );
+		if ( !out_hFile )
+		{
+			int iError = errno;
+			::close( iFd );
+			return ErrorToResult( iError );
+		}
+
+		return AK_Success;
+	}
+
+	//Open file and fill AkFileDesc
+	static AKRESULT Open(
+		const AkOSChar* in_pszFileName,     // File name.
+		AkOpenMode      in_eOpenMode,       // Open mode.
+		bool			in_bOverlapped,		// Overlapped IO
+		AkFileDesc &    out_fileDesc		// File descriptor
+		)
+	{
+		AKRESULT eResult = OpenFile(
+			in_pszFileName,
+			in_eOpenMode,
+			in_bOverlapped,
+			out_fileDesc.hFile );
+
+		if (eResult == AK_Success)
+		{
+			struct stat fileStat;
+			out_fileDesc.iFileSize = ::fstat( fileno( out_fileDesc.hFile ), &fileStat ) == 0 ? fileStat.st_size : 0;
+		}
+		return eResult;
+	}
+
+	// Wrapper for system file handle closing.
+	static AKRESULT CloseFile( const AkFileDesc& in_FileDesc )
+	{
+		if ( ::fclose( in_FileDesc.hFile ) == 0 )
+			return AK_Success;
+
+		AKASSERT( !"Failed to close file handle" );
+		return AK_Fail;
+	}
+
+	//
+	// Simple platform-independent API to open and read files using AkFileHandles,
+	// with blocking calls and minimal constraints.
+	// ---------------------------------------------------------------------------
+
+	// Open file to use with ReadBlocking().
+	static AKRESULT OpenBlocking(
+        const AkOSChar* in_pszFilename,     // File name.
+        AkFileHandle &  out_hFile           // Returned file handle.
+		)
+	{
+		return OpenFile(
+			in_pszFilename,
+			AK_OpenModeRead,
+			false,
+			out_hFile );
+	}
+
+	// Required block size for reads (used by ReadBlocking() below).
+	static const AkUInt32 s_uRequiredBlockSize = 1;
+
+	// Simple blocking read method.
+	static AKRESULT ReadBlocking(
+        AkFileHandle &	in_hFile,			// Returned file identifier/handle.
+		void *			in_pBuffer,			// Buffer. Must be aligned on CAkFileHelpers::s_uRequiredBlockSize boundary.
+		AkUInt32		in_uPosition,		// Position from which to start reading.
+		AkUInt32		in_uSizeToRead,		// Size to read. Must be a multiple of CAkFileHelpers::s_uRequiredBlockSize.
+		AkUInt32 &		out_uSizeRead		// Returned size read.
+		)
+	{
+		AKASSERT( in_uSizeToRead % s_uRequiredBlockSize == 0
+			&& in_uPosition % s_uRequiredBlockSize == 0 );
+
+		out_uSizeRead = 0;
+		while ( out_uSizeRead < in_uSizeToRead )
+		{
+			ssize_t iRead = ::pread( fileno( in_hFile ), (char*)in_pBuffer + out_uSizeRead, in_uSizeToRead - out_uSizeRead, (off_t)in_uPosition + out_uSizeRead );
+			if ( iRead < 0 && errno == EINTR )
+				continue;
+			if ( iRead < 0 )
+				return AK_Fail;
+			if ( iRead == 0 )
+				break; // End of file
+			out_uSizeRead += (AkUInt32)iRead;
+		}
+		return AK_Success;
+	}
+
+	static AKRESULT ReadBlocking(
+		AkFileDesc& in_fileDesc,		// Returned file identifier/handle.
+		void*		in_pBuffer,			// Buffer. Must be aligned on CAkFileHelpers::s_uRequiredBlockSize boundary.
+		AkUInt32	in_uPosition,		// Position from which to start reading.
+		AkUInt32	in_uSizeToRead,		// Size to read. Must be a multiple of CAkFileHelpers::s_uRequiredBlockSize.
+		AkUInt32&	out_uSizeRead		// Returned size read.
+		)
+	{
+		return ReadBlocking(in_fileDesc.hFile, in_pBuffer, in_uPosition, in_uSizeToRead, out_uSizeRead);
+	}
+
+	/// Returns AK_Success if the directory is valid, AK_Fail if not.
+	/// For validation purposes only.
+	/// Some platforms may return AK_NotImplemented, in this case you cannot rely on it.
+	static AKRESULT CheckDirectoryExists( const AkOSChar* in_pszBasePath )
+	{
+		struct stat fileStat;
+		if ( ::stat( in_pszBasePath, &fileStat ) != 0 )
+			return AK_PathNotFound;  //something is wrong with your path!
+
+		if ( S_ISDIR( fileStat.st_mode ) )
+			return AK_Success;   // this is a directory!
+
+		return AK_PathNotFound;    // this is not a directory!
+	}
+
+	static AKRESULT WriteBlocking(
+		AkFileHandle &	in_hFile,			// Returned file identifier/handle.
+		void *			in_pData,			// Buffer. Must be aligned on CAkFileHelpers::s_uRequiredBlockSize boundary.
+		AkUInt64		in_uPosition,		// Position from which to start writing.
+		AkUInt32		in_uSizeToWrite)
+	{
+		AKASSERT( in_pData && in_hFile );
+
+		AkUInt32 uSizeTransferred = 0;
+		while ( uSizeTransferred < in_uSizeToWrite )
+		{
+			ssize_t iWritten = ::pwrite( fileno( in_hFile ), (const char*)in_pData + uSizeTransferred, in_uSizeToWrite - uSizeTransferred, (off_t)( in_uPosition + uSizeTransferred ) );
+			if ( iWritten < 0 && errno == EINTR )
+				continue;
+			if ( iWritten <= 0 )
+				return AK_Fail;
+			uSizeTransferred += (AkUInt32)iWritten;
+		}
+
+		return AK_Success;
+	}
+
+	static AKRESULT CreateEmptyDirectory(const AkOSChar* in_pszDirectoryPath)
+	{
+		if ( ::mkdir( in_pszDirectoryPath, 0755 ) != 0 && errno != EEXIST )
+			return AK_Fail;
+
+		return AK_Success;
+	}
+
+	static AKRESULT RemoveEmptyDirectory(const AkOSChar* in_pszDirectoryPath)
+	{
+		if ( ::rmdir( in_pszDirectoryPath ) != 0 )
+			return AK_Fail;
+
+		return AK_Success;
+	}
+
+	static AKRESULT GetDefaultWritablePath(AkOSChar* out_pszPath, AkUInt32 /*in_pathMaxSize*/)
+	{
+		if (out_pszPath == nullptr)
+			return AK_InsufficientMemory;
+
+		// No strict writable path enforcement (return "")
+		out_pszPath[0] = '\0';
+		return AK_Success;
+	}
+
+	static void NormalizeDirectorySeparators(AkOSChar* io_path)
+	{
+		// Paths written for Windows use backslashes, which POSIX takes as part of the name.
+		AkOSChar* c = io_path;
+		while (*c != '\0')
+		{
+			if (*c == '\\')
+			{
+				*c = '/';
+			}
+			c++;
+		}
+	}
+
+private:
+	static AKRESULT ErrorToResult( int in_iError )
+	{
+		if ( ENOENT == in_iError || ENOTDIR == in_iError )
+			return AK_FileNotFound;
+
+		if ( EACCES == in_iError || EPERM == in_iError || EROFS == in_iError )
+			return AK_FilePermissionError;
+
+		return AK_UnknownFileError;
+	}
+};
+
+#endif //_AK_FILE_HELPERS_H_
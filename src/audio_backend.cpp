@@ -0,0 +1,206 @@
+#include "audio_backend.h"
+
+#pragma warning(push, 0)
+#include "memory.h"
+
+#include <engine/log.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#pragma warning(pop)
+
+namespace wwise {
+
+using namespace foundation;
+
+namespace {
+
+// The null backend renders nothing, but its sample clock runs as if it rendered frames of this format.
+constexpr uint32_t NULL_SAMPLE_RATE = 48000;
+constexpr uint32_t NULL_FRAME_LENGTH = 1024;
+
+struct NullBackend {
+    BackendCallbacks callbacks;
+    std::atomic<AkPlayingID> next_playing_id;
+    std::atomic<uint64_t> sample_clock;
+    int64_t start_us;
+};
+
+void *null_init(Allocator &allocator, const BackendCallbacks &callbacks, const BackendSettings &) {
+    NullBackend *backend = MAKE_NEW(allocator, NullBackend);
+    backend->callbacks = callbacks;
+    backend->next_playing_id.store(0, std::memory_order_relaxed);
+    backend->sample_clock.store(0, std::memory_order_relaxed);
+    backend->start_us = steady_clock_us();
+    return backend;
+}
+
+void null_term(Allocator &allocator, void *instance) {
+    MAKE_DELETE(allocator, NullBackend, static_cast<NullBackend *>(instance));
+}
+
+AKRESULT null_load_bank(void *, AkBankID) {
+    return AK_Success;
+}
+
+// Asynchronous operations complete right away.
+AKRESULT null_load_bank_async(void *instance, AkBankID bank_id, void *cookie) {
+    static_cast<NullBackend *>(instance)->callbacks.bank_loaded(bank_id, AK_Success, cookie);
+    return AK_Success;
+}
+
+AKRESULT null_unload_bank_async(void *instance, AkBankID bank_id, void *cookie) {
+    static_cast<NullBackend *>(instance)->callbacks.bank_unloaded(bank_id, AK_Success, cookie);
+    return AK_Success;
+}
+
+uint64_t null_bank_memory_used(void *) {
+    return 0;
+}
+
+AKRESULT null_register_game_object(void *, AkGameObjectID, const char *) {
+    return AK_Success;
+}
+
+AKRESULT null_unregister_game_object(void *, AkGameObjectID) {
+    return AK_Success;
+}
+
+AKRESULT null_set_default_listener(void *, AkGameObjectID) {
+    return AK_Success;
+}
+
+uint32_t null_playing_count(void *, AkGameObjectID) {
+    return 0;
+}
+
+AkPlayingID null_post_event(void *instance, AkUniqueID, AkGameObjectID, uint32_t, void *) {
+    AkPlayingID id = static_cast<NullBackend *>(instance)->next_playing_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    return id == AK_INVALID_PLAYING_ID ? 1 : id;
+}
+
+AKRESULT null_stop_event(void *, AkUniqueID, AkGameObjectID, AkTimeMs) {
+    return AK_Success;
+}
+
+AKRESULT null_seek_event(void *, AkUniqueID, AkGameObjectID, AkTimeMs) {
+    return AK_Success;
+}
+
+AKRESULT null_set_position(void *, AkGameObjectID, const AkVector &, const AkVector &, const AkVector &) {
+    return AK_Success;
+}
+
+AKRESULT null_set_game_parameter(void *, AkRtpcID, AkRtpcValue, AkGameObjectID) {
+    return AK_Success;
+}
+
+// Renders the frames a device would have consumed since the last call, none if it's called again within a frame.
+void null_render(void *instance) {
+    NullBackend *backend = static_cast<NullBackend *>(instance);
+    const uint64_t due = real_time_sample_clock(backend->start_us, NULL_SAMPLE_RATE, NULL_FRAME_LENGTH);
+    uint64_t clock = backend->sample_clock.load(std::memory_order_relaxed);
+    while (due > clock && !backend->sample_clock.compare_exchange_weak(clock, due, std::memory_order_relaxed)) {
+    }
+}
+
+void null_audio_format(void *, uint32_t &sample_rate, uint32_t &frame_length) {
+    sample_rate = NULL_SAMPLE_RATE;
+    frame_length = NULL_FRAME_LENGTH;
+}
+
+uint64_t null_sample_clock(void *instance) {
+    return static_cast<NullBackend *>(instance)->sample_clock.load(std::memory_order_relaxed);
+}
+
+bool null_job_stats(void *, JobStats &) {
+    return false;
+}
+
+bool null_write_job_trace(void *, const char *) {
+    return false;
+}
+
+uint32_t null_set_task_runner(void *, const TaskRunner *) {
+    return 0;
+}
+
+void null_request_task_workers(void *, uint32_t) {}
+
+} // namespace
+
+const Backend NULL_BACKEND = {
+    "null",
+    true,
+    null_init,
+    null_term,
+    null_load_bank,
+    null_load_bank_async,
+    null_unload_bank_async,
+    null_bank_memory_used,
+    null_register_game_object,
+    null_unregister_game_object,
+    null_set_default_listener,
+    null_playing_count,
+    null_post_event,
+    null_stop_event,
+    null_seek_event,
+    null_set_position,
+    null_set_game_parameter,
+    null_render,
+    null_audio_format,
+    null_sample_clock,
+    null_job_stats,
+    null_write_job_trace,
+    null_set_task_runner,
+    null_request_task_workers,
+};
+
+int64_t steady_clock_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t real_time_sample_clock(int64_t start_us, uint32_t sample_rate, uint32_t frame_length) {
+    const uint64_t elapsed_us = (uint64_t)(steady_clock_us() - start_us);
+    const uint64_t samples = elapsed_us * sample_rate / 1000000;
+    return samples - samples % frame_length;
+}
+
+const Backend *find_backend(const char *name) {
+    const Backend *backends[] = {
+#if defined(PLOP_WWISE)
+        &WWISE_BACKEND,
+#endif
+        &MIXER_BACKEND,
+        &NULL_BACKEND,
+    };
+
+    for (const Backend *backend : backends) {
+        if (strcmp(backend->name, name) == 0) {
+            return backend;
+        }
+    }
+
+    return nullptr;
+}
+
+const Backend &default_backend() {
+    const char *name = getenv("PLOP_AUDIO_BACKEND");
+    if (name && *name) {
+        const Backend *backend = find_backend(name);
+        if (!backend) {
+            log_fatal("Unknown audio backend %s", name);
+        }
+        return *backend;
+    }
+
+#if defined(PLOP_WWISE)
+    return WWISE_BACKEND;
+#else
+    return MIXER_BACKEND;
+#endif
+}
+
+} // namespace wwise
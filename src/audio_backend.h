@@ -0,0 +1,223 @@
+#pragma once
+
+#pragma warning(push, 0)
+#include <memory_types.h>
+#include <stdint.h>
+#include <AK/SoundEngine/Common/AkTypes.h>
+#pragma warning(pop)
+
+namespace wwise {
+
+/**
+ * @brief Callbacks from the backend into wwise.cpp, called from any thread.
+ */
+struct BackendCallbacks {
+    // Result of an asynchronous bank load or unload, with the cookie it was requested with.
+    void (*bank_loaded)(AkBankID bank_id, AKRESULT result, void *cookie);
+    void (*bank_unloaded)(AkBankID bank_id, AKRESULT result, void *cookie);
+
+    // The first sound of an event posted with the cookie started playing, at the sample clock time.
+    void (*event_started)(void *cookie, uint64_t start_sample);
+
+    // Sound engine monitor output.
+    void (*monitor)(int32_t error_code, bool error, const AkOSChar *text, AkPlayingID playing_id, AkGameObjectID game_object_id);
+};
+
+// When job workers hand their thread-local memory back to the sound engine's memory manager.
+enum class TrimPolicy {
+    // Every time a worker goes to sleep.
+    OnPark,
+
+    // After every trim_after_jobs jobs.
+    AfterJobs,
+
+    // Once a worker has slept for trim_idle_ms, so short gaps between audio frames keep the memory warm. The sound
+    // engine's next job request notices.
+    AfterIdle,
+
+    // When a worker goes to sleep while the memory manager holds more than trim_high_water_kb reserved but unused.
+    AboveHighWater,
+
+    Never,
+};
+
+// How the backend uses the processors.
+struct BackendSettings {
+    // Sound engine job worker threads, 0 for one per core that isn't reserved.
+    uint32_t job_workers = 0;
+
+    // Physical cores kept free of job workers, for the main thread and then the sound engine's audio thread.
+    uint32_t reserved_cores = 2;
+
+    // Whether to pin the main thread, the audio thread and the job workers to their cores. The main thread is the one
+    // starting the sound engine.
+    bool pin_threads = true;
+
+    // Whether each render renders one audio frame on the calling thread, as fast as it's called, instead of handing it
+    // to the audio thread at the audio device's pace. For benchmarks timing the sound engine's work per frame.
+    bool offline_render = false;
+
+    TrimPolicy trim_policy = TrimPolicy::OnPark;
+    uint32_t trim_after_jobs = 64;
+    uint32_t trim_idle_ms = 100;
+    uint32_t trim_high_water_kb = 1024;
+
+    // Directory of the generated SoundBanks for the platform, relative to the working directory.
+#if defined(_WIN32)
+    const char *bank_path = "plop_wwise/GeneratedSoundBanks/Windows";
+#elif defined(__APPLE__)
+    const char *bank_path = "plop_wwise/GeneratedSoundBanks/Mac";
+#else
+    const char *bank_path = "plop_wwise/GeneratedSoundBanks/Linux";
+#endif
+};
+
+// Sound engine job types, which are AkJobType.
+constexpr uint32_t JOB_TYPE_COUNT = 3;
+
+constexpr uint32_t MAX_JOB_WORKER_STATS = 64;
+
+// What one job worker thread did since the sound engine started. Times are in microseconds.
+struct JobWorkerStats {
+    uint64_t busy_us;
+    uint64_t spin_us;
+    uint64_t parked_us;
+    uint64_t trim_us;
+    uint64_t trims;
+
+    uint64_t task_us;
+    uint64_t jobs[JOB_TYPE_COUNT];
+    uint64_t tasks;
+    uint64_t spin_hits;
+    uint64_t parks;
+    uint64_t wakes;
+    uint64_t wake_latency_us;
+    uint64_t max_wake_latency_us;
+    uint32_t queue_depth;
+};
+
+struct JobStats {
+    uint32_t worker_count;
+    uint64_t elapsed_us;
+    uint64_t requests;
+    uint64_t enqueue_retries;
+
+    // Requests waiting in all worker queues, sampled at each request.
+    uint64_t queue_depth_total;
+    uint32_t max_queue_depth;
+
+    uint32_t spin_budget_us;
+    JobWorkerStats workers[MAX_JOB_WORKER_STATS];
+};
+
+// Runs game tasks on the sound engine's job workers, between their own jobs. Called from the workers.
+struct TaskRunner {
+    // Runs one task. Returns false if there was none.
+    bool (*run_task)(void *cookie);
+
+    // Whether a task is ready to run, checked before a worker goes to sleep. Tasks still waiting on a dependency don't
+    // count, the runner wakes workers with request_task_workers once they're ready.
+    bool (*has_task)(void *cookie);
+
+    void *cookie;
+};
+
+/**
+ * @brief The sound engine operations behind the wwise:: functions.
+ *
+ * wwise.cpp keeps the bank references, pose staging, game parameter cache, command queues and game object pool,
+ * and only talks to the sound engine through this table. Every function but init takes the instance returned by
+ * init, and may be called from the game thread and the render thread at the same time.
+ */
+struct Backend {
+    const char *name;
+
+    // Whether post_event starts the event at the frame offset. Otherwise it starts at the next audio frame.
+    bool sample_accurate;
+
+    // Starts the sound engine. Returns the backend instance, or nullptr on failure.
+    void *(*init)(foundation::Allocator &allocator, const BackendCallbacks &callbacks, const BackendSettings &settings);
+    void (*term)(foundation::Allocator &allocator, void *instance);
+
+    // Banks are loaded by ID: the backend doesn't hash or look up their names.
+    AKRESULT (*load_bank)(void *instance, AkBankID bank_id);
+
+    // Results are reported through BackendCallbacks::bank_loaded and bank_unloaded with the cookie.
+    AKRESULT (*load_bank_async)(void *instance, AkBankID bank_id, void *cookie);
+    AKRESULT (*unload_bank_async)(void *instance, AkBankID bank_id, void *cookie);
+
+    // Memory held by the loaded banks and their media. Only bank loads and unloads change it, and the backend runs
+    // them one at a time, so the change across an operation belongs to its bank.
+    uint64_t (*bank_memory_used)(void *instance);
+
+    AKRESULT (*register_game_object)(void *instance, AkGameObjectID game_object_id, const char *name);
+    AKRESULT (*unregister_game_object)(void *instance, AkGameObjectID game_object_id);
+    AKRESULT (*set_default_listener)(void *instance, AkGameObjectID game_object_id);
+
+    // Number of events playing on the game object.
+    uint32_t (*playing_count)(void *instance, AkGameObjectID game_object_id);
+
+    // Starts the event frame_offset samples from the start of the next audio frame, which can be frames ahead. Reports
+    // BackendCallbacks::event_started with the start cookie, unless it's nullptr.
+    AkPlayingID (*post_event)(void *instance, AkUniqueID event_id, AkGameObjectID game_object_id, uint32_t frame_offset, void *start_cookie);
+    AKRESULT (*stop_event)(void *instance, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs fade);
+    AKRESULT (*seek_event)(void *instance, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs position);
+
+    AKRESULT (*set_position)(void *instance, AkGameObjectID game_object_id, const AkVector &position, const AkVector &front, const AkVector &top);
+    AKRESULT (*set_game_parameter)(void *instance, AkRtpcID parameter_id, AkRtpcValue value, AkGameObjectID game_object_id);
+
+    // Hands everything since the last call to the audio thread.
+    void (*render)(void *instance);
+
+    // Sample rate and audio frame length in samples, or 0 if unknown.
+    void (*audio_format)(void *instance, uint32_t &sample_rate, uint32_t &frame_length);
+
+    // Samples rendered so far, which is where the next audio frame starts. It advances at the sample rate in real
+    // time, a frame at a time, however often render is called.
+    uint64_t (*sample_clock)(void *instance);
+
+    // Snapshot of the job worker counters. Returns false if the backend has no job workers.
+    bool (*job_stats)(void *instance, JobStats &stats);
+
+    // Writes the recent jobs of each worker as a Chrome trace event file. Returns false if the backend has no job
+    // workers or the file couldn't be written.
+    bool (*write_job_trace)(void *instance, const char *path);
+
+    // Sets the runner of game tasks on the job workers, or removes it with nullptr, returning once no worker is still
+    // in the previous one. Returns the number of job workers, 0 if the backend has none and tasks can't run on it.
+    uint32_t (*set_task_runner)(void *instance, const TaskRunner *runner);
+
+    // Wakes up to count sleeping job workers to run tasks.
+    void (*request_task_workers)(void *instance, uint32_t count);
+};
+
+#if defined(PLOP_WWISE)
+// AK::SoundEngine.
+extern const Backend WWISE_BACKEND;
+#endif
+
+// Does nothing. Together with the call counts in Wwise it measures the overhead of the wwise:: layer itself.
+extern const Backend NULL_BACKEND;
+
+// Plays the original media of the events from plop_wwise/Originals, mixed in software.
+extern const Backend MIXER_BACKEND;
+
+// Finds a backend by name, or nullptr if it isn't built in.
+const Backend *find_backend(const char *name);
+
+// The backend named by the PLOP_AUDIO_BACKEND environment variable, or else Wwise if it's built in, or else the
+// software mixer.
+const Backend &default_backend();
+
+// For backends without an audio device: the steady clock in microseconds, and the samples an audio device started at
+// start_us would have consumed by now, in whole frames.
+int64_t steady_clock_us();
+uint64_t real_time_sample_clock(int64_t start_us, uint32_t sample_rate, uint32_t frame_length);
+
+// Called by the software mixer backend with each mixed audio frame, as interleaved stereo.
+typedef void (*MixerOutput)(const float *samples, uint32_t frames, void *cookie);
+
+// Sets the output of a software mixer backend instance. Without an output the frames are only mixed.
+void set_mixer_output(void *instance, MixerOutput output, void *cookie);
+
+} // namespace wwise
@@ -0,0 +1,268 @@
+#include "cpu_topology.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#if defined(_WIN32)
+#pragma warning(push, 0)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#pragma warning(pop)
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace plop {
+
+namespace cpu_topology {
+
+namespace {
+
+void add_mask(uint64_t *masks, uint32_t &count, uint64_t mask) {
+    if (mask == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (masks[i] == mask) {
+            return;
+        }
+    }
+
+    if (count < MAX_LOGICAL_PROCESSORS) {
+        masks[count++] = mask;
+    }
+}
+
+// Sorts by lowest processor, so core 0 holds processor 0.
+void sort_masks(uint64_t *masks, uint32_t count) {
+    for (uint32_t i = 1; i < count; ++i) {
+        uint64_t mask = masks[i];
+        uint64_t lowest = mask & (~mask + 1);
+        uint32_t j = i;
+        while (j > 0 && (masks[j - 1] & (~masks[j - 1] + 1)) > lowest) {
+            masks[j] = masks[j - 1];
+            --j;
+        }
+        masks[j] = mask;
+    }
+}
+
+void detect_fallback(CpuTopology &topology) {
+    uint32_t count = std::thread::hardware_concurrency();
+    count = count == 0 ? 1 : count > MAX_LOGICAL_PROCESSORS ? MAX_LOGICAL_PROCESSORS : count;
+
+    topology.logical_count = count;
+    topology.core_count = count;
+    topology.cache_domain_count = 1;
+    topology.cache_domain_mask[0] = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        topology.core_mask[i] = 1ull << i;
+        topology.cache_domain_mask[0] |= 1ull << i;
+    }
+}
+
+#if defined(_WIN32)
+
+// Only processor group 0, which is all of them below 64 logical processors.
+bool detect_platform(CpuTopology &topology) {
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || length == 0) {
+        return false;
+    }
+
+    char *buffer = (char *)malloc(length);
+    if (!buffer || !GetLogicalProcessorInformationEx(RelationAll, (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer, &length)) {
+        free(buffer);
+        return false;
+    }
+
+    // Cores and caches are cut down to the process affinity mask.
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    const uint64_t allowed = GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) ? (uint64_t)process_mask : ~0ull;
+
+    // Cache domains are the caches of the highest level.
+    BYTE cache_level = 0;
+    for (DWORD offset = 0; offset < length;) {
+        const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *info = (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)(buffer + offset);
+        if (info->Relationship == RelationCache && info->Cache.Level > cache_level) {
+            cache_level = info->Cache.Level;
+        }
+        offset += info->Size;
+    }
+
+    for (DWORD offset = 0; offset < length;) {
+        const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *info = (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *)(buffer + offset);
+        if (info->Relationship == RelationProcessorCore && info->Processor.GroupMask[0].Group == 0) {
+            add_mask(topology.core_mask, topology.core_count, (uint64_t)info->Processor.GroupMask[0].Mask & allowed);
+        } else if (info->Relationship == RelationCache && info->Cache.Level == cache_level && info->Cache.GroupMask.Group == 0) {
+            add_mask(topology.cache_domain_mask, topology.cache_domain_count, (uint64_t)info->Cache.GroupMask.Mask & allowed);
+        }
+        offset += info->Size;
+    }
+
+    free(buffer);
+    return topology.core_count > 0;
+}
+
+#else
+
+// Parses a sysfs cpu list like 0-3,8-11 into a mask.
+bool read_cpu_list(const char *path, uint64_t &mask) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[256];
+    bool ok = fgets(line, sizeof(line), file) != nullptr;
+    fclose(file);
+    if (!ok) {
+        return false;
+    }
+
+    mask = 0;
+    for (char *p = line; *p && *p != '\n';) {
+        char *end = nullptr;
+        unsigned long first = strtoul(p, &end, 10);
+        if (end == p) {
+            return false;
+        }
+
+        unsigned long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtoul(p + 1, &end, 10);
+            p = end;
+        }
+
+        for (unsigned long i = first; i <= last && i < MAX_LOGICAL_PROCESSORS; ++i) {
+            mask |= 1ull << i;
+        }
+
+        if (*p == ',') {
+            ++p;
+        }
+    }
+
+    return mask != 0;
+}
+
+// The processors the process may run on, which a taskset or a container's cpuset restricts.
+uint64_t allowed_cpus() {
+    uint64_t mask = ~0ull;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        mask = 0;
+        for (uint32_t cpu = 0; cpu < MAX_LOGICAL_PROCESSORS; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                mask |= 1ull << cpu;
+            }
+        }
+    }
+#endif
+    return mask;
+}
+
+// Only the online processors the process may run on, so workers are neither planned nor pinned outside of them.
+bool detect_platform(CpuTopology &topology) {
+    uint64_t online = 0;
+    if (!read_cpu_list("/sys/devices/system/cpu/online", online)) {
+        return false;
+    }
+    online &= allowed_cpus();
+
+    for (uint32_t cpu = 0; cpu < MAX_LOGICAL_PROCESSORS; ++cpu) {
+        if ((online & (1ull << cpu)) == 0) {
+            continue;
+        }
+
+        char path[128];
+        uint64_t mask = 0;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", cpu);
+        add_mask(topology.core_mask, topology.core_count, read_cpu_list(path, mask) ? mask & online : 1ull << cpu);
+
+        // index3 is the L3 where there is one, otherwise the cpu is its own domain until the fallback below.
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index3/shared_cpu_list", cpu);
+        if (read_cpu_list(path, mask)) {
+            add_mask(topology.cache_domain_mask, topology.cache_domain_count, mask & online);
+        }
+    }
+
+    return topology.core_count > 0;
+}
+
+#endif
+
+} // namespace
+
+void detect(CpuTopology &topology) {
+    memset(&topology, 0, sizeof(topology));
+
+    if (!detect_platform(topology)) {
+        memset(&topology, 0, sizeof(topology));
+        detect_fallback(topology);
+        return;
+    }
+
+    sort_masks(topology.core_mask, topology.core_count);
+    sort_masks(topology.cache_domain_mask, topology.cache_domain_count);
+
+    uint64_t all = 0;
+    for (uint32_t i = 0; i < topology.core_count; ++i) {
+        all |= topology.core_mask[i];
+    }
+
+    // Without cache information all cores share one domain.
+    if (topology.cache_domain_count == 0) {
+        topology.cache_domain_mask[0] = all;
+        topology.cache_domain_count = 1;
+    }
+
+    topology.logical_count = 0;
+    for (uint64_t m = all; m; m &= m - 1) {
+        ++topology.logical_count;
+    }
+}
+
+uint32_t cache_domain(const CpuTopology &topology, uint32_t core) {
+    for (uint32_t i = 0; i < topology.cache_domain_count; ++i) {
+        if (topology.cache_domain_mask[i] & topology.core_mask[core]) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+bool pin_current_thread(uint64_t mask) {
+    if (mask == 0) {
+        return false;
+    }
+
+#if defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (uint32_t cpu = 0; cpu < MAX_LOGICAL_PROCESSORS; ++cpu) {
+        if (mask & (1ull << cpu)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace cpu_topology
+
+} // namespace plop
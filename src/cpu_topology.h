@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace plop {
+
+// Processors past this many are ignored, so masks fit in 64 bits.
+constexpr uint32_t MAX_LOGICAL_PROCESSORS = 64;
+
+/**
+ * @brief The processors the game runs on, grouped into physical cores and last level cache domains.
+ *
+ * Each core and cache domain is an affinity mask of its logical processors. SMT
+ * siblings share a core, and cores share a cache domain. Cores are in processor
+ * order, so core 0 holds logical processor 0.
+ */
+struct CpuTopology {
+    uint32_t logical_count;
+    uint32_t core_count;
+    uint32_t cache_domain_count;
+
+    uint64_t core_mask[MAX_LOGICAL_PROCESSORS];
+    uint64_t cache_domain_mask[MAX_LOGICAL_PROCESSORS];
+};
+
+namespace cpu_topology {
+
+// Detects the topology of the processors the process may run on. Where it's unknown every logical processor is its own core, all in one cache domain.
+void detect(CpuTopology &topology);
+
+// The cache domain the core is in.
+uint32_t cache_domain(const CpuTopology &topology, uint32_t core);
+
+// Restricts the calling thread to the processors in the mask. Returns false where the platform can't, or for an empty
+// mask. On Linux threads it starts afterwards inherit the mask.
+bool pin_current_thread(uint64_t mask);
+
+} // namespace cpu_topology
+
+} // namespace plop
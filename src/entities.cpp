@@ -0,0 +1,180 @@
+#include "entities.h"
+
+#include <array.h>
+#include <queue.h>
+
+#include <engine/log.h>
+
+#include <assert.h>
+
+namespace plop {
+
+using namespace foundation;
+
+namespace {
+
+constexpr uint32_t INVALID_DENSE_INDEX = 0xffffffffu;
+
+inline uint32_t handle_index(Entity e) {
+    return e.id & ENTITY_INDEX_MASK;
+}
+
+inline uint32_t handle_generation(Entity e) {
+    return (e.id >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK;
+}
+
+inline Entity make_handle(uint32_t index, uint32_t generation) {
+    return Entity{(generation << ENTITY_INDEX_BITS) | index};
+}
+
+} // namespace
+
+Entities::Entities(Allocator &allocator)
+: allocator(allocator)
+, generation(allocator)
+, dense_index(allocator)
+, free_indices(allocator)
+, entity(allocator)
+, position_x(allocator)
+, position_y(allocator)
+, position_z(allocator)
+, velocity_x(allocator)
+, velocity_y(allocator)
+, velocity_z(allocator)
+, rotation(allocator) {
+    // Reserve index 0 for NULL_ENTITY. Its dense index stays invalid so it is never alive.
+    array::push_back(generation, (uint16_t)0);
+    array::push_back(dense_index, INVALID_DENSE_INDEX);
+}
+
+namespace entities {
+
+Entity create(Entities &entities) {
+    uint32_t idx = 0;
+
+    if (queue::size(entities.free_indices) > ENTITY_MINIMUM_FREE_INDICES) {
+        idx = entities.free_indices[0];
+        queue::pop_front(entities.free_indices);
+    } else {
+        idx = array::size(entities.generation);
+        if (idx > ENTITY_INDEX_MASK) {
+            log_fatal("Out of entity indices");
+        }
+
+        array::push_back(entities.generation, (uint16_t)0);
+        array::push_back(entities.dense_index, INVALID_DENSE_INDEX);
+    }
+
+    Entity e = make_handle(idx, entities.generation[idx]);
+
+    entities.dense_index[idx] = array::size(entities.entity);
+    array::push_back(entities.entity, e);
+    array::push_back(entities.position_x, 0.0f);
+    array::push_back(entities.position_y, 0.0f);
+    array::push_back(entities.position_z, 0.0f);
+    array::push_back(entities.velocity_x, 0.0f);
+    array::push_back(entities.velocity_y, 0.0f);
+    array::push_back(entities.velocity_z, 0.0f);
+    array::push_back(entities.rotation, 0.0f);
+
+    return e;
+}
+
+void destroy(Entities &entities, Entity e) {
+    if (!alive(entities, e)) {
+        return;
+    }
+
+    uint32_t idx = handle_index(e);
+    uint32_t dense = entities.dense_index[idx];
+    uint32_t last = array::size(entities.entity) - 1;
+
+    // The last entity is swapped into the hole, so it needs its sparse slot pointed at its new dense index.
+    if (dense != last) {
+        Entity moved = entities.entity[last];
+        entities.dense_index[handle_index(moved)] = dense;
+    }
+
+    swap_pop(entities.entity, dense);
+    swap_pop(entities.position_x, dense);
+    swap_pop(entities.position_y, dense);
+    swap_pop(entities.position_z, dense);
+    swap_pop(entities.velocity_x, dense);
+    swap_pop(entities.velocity_y, dense);
+    swap_pop(entities.velocity_z, dense);
+    swap_pop(entities.rotation, dense);
+
+    entities.dense_index[idx] = INVALID_DENSE_INDEX;
+    entities.generation[idx] = (uint16_t)((entities.generation[idx] + 1) & ENTITY_GENERATION_MASK);
+    queue::push_back(entities.free_indices, idx);
+}
+
+bool alive(const Entities &entities, Entity e) {
+    uint32_t idx = handle_index(e);
+    if (idx >= array::size(entities.generation)) {
+        return false;
+    }
+
+    return entities.generation[idx] == handle_generation(e) && entities.dense_index[idx] != INVALID_DENSE_INDEX;
+}
+
+uint32_t index(const Entities &entities, Entity e) {
+    assert(alive(entities, e));
+    return entities.dense_index[handle_index(e)];
+}
+
+uint32_t count(const Entities &entities) {
+    return array::size(entities.entity);
+}
+
+void reserve(Entities &entities, uint32_t capacity) {
+    // The sparse arrays have the reserved null index in front.
+    array::reserve(entities.generation, capacity + 1);
+    array::reserve(entities.dense_index, capacity + 1);
+    array::reserve(entities.entity, capacity);
+    array::reserve(entities.position_x, capacity);
+    array::reserve(entities.position_y, capacity);
+    array::reserve(entities.position_z, capacity);
+    array::reserve(entities.velocity_x, capacity);
+    array::reserve(entities.velocity_y, capacity);
+    array::reserve(entities.velocity_z, capacity);
+    array::reserve(entities.rotation, capacity);
+}
+
+glm::vec3 position(const Entities &entities, Entity e) {
+    uint32_t i = index(entities, e);
+    return glm::vec3{entities.position_x[i], entities.position_y[i], entities.position_z[i]};
+}
+
+void set_position(Entities &entities, Entity e, glm::vec3 position) {
+    uint32_t i = index(entities, e);
+    entities.position_x[i] = position.x;
+    entities.position_y[i] = position.y;
+    entities.position_z[i] = position.z;
+}
+
+void set_velocity(Entities &entities, Entity e, glm::vec3 velocity) {
+    uint32_t i = index(entities, e);
+    entities.velocity_x[i] = velocity.x;
+    entities.velocity_y[i] = velocity.y;
+    entities.velocity_z[i] = velocity.z;
+}
+
+void integrate(Entities &entities, float dt) {
+    const uint32_t n = count(entities);
+
+    // One flat loop per axis over restrict pointers, which the compiler vectorizes.
+    auto integrate_axis = [n, dt](float *__restrict p, const float *__restrict v) {
+        for (uint32_t i = 0; i < n; ++i) {
+            p[i] += v[i] * dt;
+        }
+    };
+
+    integrate_axis(array::begin(entities.position_x), array::begin(entities.velocity_x));
+    integrate_axis(array::begin(entities.position_y), array::begin(entities.velocity_y));
+    integrate_axis(array::begin(entities.position_z), array::begin(entities.velocity_z));
+}
+
+} // namespace entities
+
+} // namespace plop
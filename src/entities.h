@@ -0,0 +1,105 @@
+#pragma once
+
+#include "collection_types.h"
+#include "memory_types.h"
+#include "util.h"
+
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+namespace plop {
+
+/**
+ * @brief A generational handle to an entity.
+ *
+ * The low ENTITY_INDEX_BITS index into the entity slots, the high bits are a
+ * generation counter which is bumped when the slot is freed. A handle to a
+ * destroyed entity is therefore never confused with a later occupant of the
+ * same slot.
+ *
+ * Index 0 is reserved and never handed out, so a value-initialized handle is
+ * NULL_ENTITY.
+ */
+struct Entity {
+    uint32_t id = 0;
+};
+
+constexpr uint32_t ENTITY_INDEX_BITS = 22;
+constexpr uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+constexpr uint32_t ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+
+// Freed slots are only reused once this many are queued, so that generations wrap slowly.
+constexpr uint32_t ENTITY_MINIMUM_FREE_INDICES = 1024;
+
+// A handle that never refers to a live entity. Equal to Entity{}.
+constexpr Entity NULL_ENTITY = {0};
+
+inline bool operator==(Entity a, Entity b) {
+    return a.id == b.id;
+}
+
+inline bool operator!=(Entity a, Entity b) {
+    return a.id != b.id;
+}
+
+/**
+ * @brief Structure-of-arrays entity and component storage.
+ *
+ * Components are stored densely, one array per component and axis, so that
+ * update loops walk contiguous memory. All dense arrays have the same size and
+ * the entity at dense index i owns element i of every component array.
+ * Removal swaps the last entity into the hole, so dense order is not stable.
+ */
+struct Entities {
+    Entities(foundation::Allocator &allocator);
+    DELETE_COPY_AND_MOVE(Entities)
+
+    foundation::Allocator &allocator;
+
+    // Sparse, indexed by the handle index.
+    foundation::Array<uint16_t> generation;
+    foundation::Array<uint32_t> dense_index;
+    foundation::Queue<uint32_t> free_indices;
+
+    // Dense, indexed by the dense index.
+    foundation::Array<Entity> entity;
+    foundation::Array<float> position_x;
+    foundation::Array<float> position_y;
+    foundation::Array<float> position_z;
+    foundation::Array<float> velocity_x;
+    foundation::Array<float> velocity_y;
+    foundation::Array<float> velocity_z;
+    foundation::Array<float> rotation;
+};
+
+namespace entities {
+
+// Creates an entity at the origin with zero velocity.
+Entity create(Entities &entities);
+
+// Destroys an entity in O(1). Destroying a dead entity is a no-op.
+void destroy(Entities &entities, Entity e);
+
+// Whether the handle refers to a live entity.
+bool alive(const Entities &entities, Entity e);
+
+// Returns the dense index of a live entity, valid until the next create or destroy.
+uint32_t index(const Entities &entities, Entity e);
+
+// The number of live entities, which is the size of every dense array.
+uint32_t count(const Entities &entities);
+
+// Reserves room for the number of entities in all arrays.
+void reserve(Entities &entities, uint32_t capacity);
+
+glm::vec3 position(const Entities &entities, Entity e);
+void set_position(Entities &entities, Entity e, glm::vec3 position);
+void set_velocity(Entities &entities, Entity e, glm::vec3 velocity);
+
+// Moves every entity by its velocity.
+void integrate(Entities &entities, float dt);
+
+} // namespace entities
+
+} // namespace plop
@@ -1,9 +1,13 @@
 #include "game.h"
 #include "wwise.h"
+#include "audio_backend.h"
 #include "palette.h"
 
 #include <assert.h>
+#include <chrono>
 #include <functional>
+#include <inttypes.h>
+#include <string.h>
 #include <time.h>
 
 #include <engine/action_binds.h>
@@ -22,25 +26,112 @@
 #include <string_stream.h>
 #include <temp_allocator.h>
 
+#include <imgui.h>
+
 #include "rnd.h"
  
 namespace plop {
 
 using namespace foundation;
 
+// Banks loaded while initializing, in load order.
+const AkBankID INITIAL_BANKS[] = {
+    AK::BANKS::MIX_MASTER,
+    AK::BANKS::DEBUG_SOUNDS,
+    AK::BANKS::PLAYER,
+};
+
+const uint32_t INITIAL_BANK_COUNT = sizeof(INITIAL_BANKS) / sizeof(INITIAL_BANKS[0]);
+
 glm::vec3 right_handed_screen_to_left_handed_world(const Game &game, const glm::vec3 v) {
     return glm::vec3 { v.x, game.canvas->height - v.y, v.z };
 }
 
+ini_t *load_config(const char *config_path) {
+    TempAllocator1024 ta;
+    string_stream::Buffer buffer(ta);
+
+    if (!engine::file::read(buffer, config_path)) {
+        log_fatal("Could not open config file %s", config_path);
+    }
+
+    ini_t *config = ini_load(string_stream::c_str(buffer), nullptr);
+
+    if (!config) {
+        log_fatal("Could not parse config file %s", config_path);
+    }
+
+    return config;
+}
+
+// Read before the rest of the config, since the sound engine starts with Wwise.
+wwise::BackendSettings read_backend_settings(ini_t *config) {
+    auto read_int = [config](const char *property, int min, int max) -> int {
+        const char *s = engine::config::read_property(config, "wwise", property);
+        if (!s) {
+            log_fatal("Invalid config file, missing [wwise] %s", property);
+        }
+
+        int i = atoi(s);
+        if (i < min || i > max) {
+            log_fatal("Invalid [wwise] %s %d", property, i);
+        }
+
+        return i;
+    };
+
+    wwise::BackendSettings settings;
+    settings.job_workers = static_cast<uint32_t>(read_int("job_workers", 0, 64));
+    settings.reserved_cores = static_cast<uint32_t>(read_int("job_worker_reserved_cores", 0, 64));
+    settings.pin_threads = read_int("job_worker_affinity", 0, 1) != 0;
+
+    const char *trim = engine::config::read_property(config, "wwise", "job_worker_trim");
+    if (!trim) {
+        log_fatal("Invalid config file, missing [wwise] job_worker_trim");
+    }
+
+    if (strcmp(trim, "park") == 0) {
+        settings.trim_policy = wwise::TrimPolicy::OnPark;
+    } else if (strcmp(trim, "jobs") == 0) {
+        settings.trim_policy = wwise::TrimPolicy::AfterJobs;
+    } else if (strcmp(trim, "idle") == 0) {
+        settings.trim_policy = wwise::TrimPolicy::AfterIdle;
+    } else if (strcmp(trim, "high_water") == 0) {
+        settings.trim_policy = wwise::TrimPolicy::AboveHighWater;
+    } else if (strcmp(trim, "never") == 0) {
+        settings.trim_policy = wwise::TrimPolicy::Never;
+    } else {
+        log_fatal("Invalid [wwise] job_worker_trim %s, expected park, jobs, idle, high_water or never", trim);
+    }
+
+    settings.trim_after_jobs = static_cast<uint32_t>(read_int("job_worker_trim_jobs", 1, 1000000));
+    settings.trim_idle_ms = static_cast<uint32_t>(read_int("job_worker_trim_idle_ms", 0, 60000));
+    settings.trim_high_water_kb = static_cast<uint32_t>(read_int("job_worker_trim_high_water_kb", 0, 1024 * 1024));
+
+    // Optional, the platform's directory by default. The config outlives the sound engine's initialization.
+    if (const char *bank_path = engine::config::read_property(config, "wwise", "bank_path")) {
+        settings.bank_path = bank_path;
+    }
+
+    return settings;
+}
+
 Game::Game(Allocator &allocator, const char *config_path)
 : allocator(allocator)
-, config(nullptr)
+, config(load_config(config_path))
 , app_state(AppState::None)
 , action_binds(nullptr)
 , canvas(nullptr)
 , sprites(nullptr)
 , palette(allocator)
-, wwise(allocator) {
+, wwise(allocator, read_backend_settings(config))
+, tasks(allocator, wwise)
+, notes(allocator)
+, entities(allocator)
+, spatial_hash(allocator, 128.0f)
+, player(NULL_ENTITY)
+, initializing_started()
+, first_frame(false) {
     using namespace foundation::string_stream;
 
     action_binds = MAKE_NEW(allocator, engine::ActionBinds, allocator, config_path);
@@ -53,23 +144,9 @@ Game::Game(Allocator &allocator, const char *config_path)
     
     uint32_t window_width = 0;
     uint32_t window_height = 0;
-    const char *atlas_filename = nullptr;
     
     // Config
     {
-        TempAllocator1024 ta;
-        Buffer buffer(ta);
-
-        if (!engine::file::read(buffer, config_path)) {
-            log_fatal("Could not open config file %s", config_path);
-        }
-
-        config = ini_load(string_stream::c_str(buffer), nullptr);
-
-        if (!config) {
-            log_fatal("Could not parse config file %s", config_path);
-        }
-        
         auto read_property = [](ini_t *config, const char *section, const char *property, const std::function<void(const char *)> success) {
             const char *s = engine::config::read_property(config, section, property);
             if (s) {
@@ -101,9 +178,80 @@ Game::Game(Allocator &allocator, const char *config_path)
             window_height = static_cast<uint32_t>(i);
         });
         
-        read_property(config, "game", "atlas_filename", [this, &atlas_filename](const char *property) {
-            assert(strlen(property) > 0);
-            atlas_filename = property;
+        read_property(config, "game", "atlas_filename", [](const char *property) {
+            if (strlen(property) == 0) {
+                log_fatal("Invalid [game] atlas_filename");
+            }
+        });
+
+        read_property(config, "wwise", "bank_memory_budget_mb", [this](const char *property) {
+            int i = atoi(property);
+            if (i < 0) {
+                log_fatal("Invalid [wwise] bank_memory_budget_mb %d", i);
+            }
+
+            wwise.bank_memory_budget = static_cast<uint64_t>(i) * 1024 * 1024;
+        });
+
+        // Game parameter values within the epsilon of the last one submitted aren't submitted again. 0 only drops
+        // repeated values.
+        read_property(config, "wwise", "game_parameter_epsilon", [this](const char *property) {
+            float f = (float)atof(property);
+            if (f < 0.0f) {
+                log_fatal("Invalid [wwise] game_parameter_epsilon %s", property);
+            }
+
+            wwise.game_parameter_epsilon = f;
+        });
+
+        // Game parameter values are rounded to a multiple of the quantum before they're compared. 0 doesn't round.
+        read_property(config, "wwise", "game_parameter_quantum", [this](const char *property) {
+            float f = (float)atof(property);
+            if (f < 0.0f) {
+                log_fatal("Invalid [wwise] game_parameter_quantum %s", property);
+            }
+
+            wwise.game_parameter_quantum = f;
+        });
+
+        // 0 renders audio in the game update.
+        read_property(config, "wwise", "render_thread_period_ms", [this](const char *property) {
+            int i = atoi(property);
+            if (i < 0 || i > 100) {
+                log_fatal("Invalid [wwise] render_thread_period_ms %d", i);
+            }
+
+            if (i > 0) {
+                wwise::start_render_thread(wwise, static_cast<uint32_t>(i) * 1000);
+            }
+        });
+
+        read_property(config, "music", "tempo_bpm", [this](const char *property) {
+            float f = (float)atof(property);
+            if (f <= 0.0f) {
+                log_fatal("Invalid [music] tempo_bpm %s", property);
+            }
+
+            notes.tempo_bpm = f;
+        });
+
+        read_property(config, "music", "grid_subdivisions", [this](const char *property) {
+            int i = atoi(property);
+            if (i < 1 || i > 64) {
+                log_fatal("Invalid [music] grid_subdivisions %d", i);
+            }
+
+            notes.subdivisions = static_cast<uint32_t>(i);
+        });
+
+        // Has to cover a game frame and an audio frame, or notes start late.
+        read_property(config, "music", "lookahead_ms", [this](const char *property) {
+            int i = atoi(property);
+            if (i < 0 || i > 1000) {
+                log_fatal("Invalid [music] lookahead_ms %d", i);
+            }
+
+            notes.lookahead_ms = static_cast<uint32_t>(i);
         });
     }
     
@@ -112,10 +260,8 @@ Game::Game(Allocator &allocator, const char *config_path)
         glm::vec3 position = { window_width * 0.5f, window_height * 0.5f, -100.0f };
         glm::vec3 front = { 0, 0, 1 };
         glm::vec3 top = { 0, 1, 0 };
-        wwise::set_pose(wwise.default_listener_id, position, front, top);
+        wwise::set_pose(wwise, wwise.default_listener_id, position, front, top);
     }
-    
-    engine::init_sprites(*sprites, atlas_filename);
 }
 
 Game::~Game() {
@@ -194,7 +340,7 @@ void wavy_circle_fill(engine::Canvas &canvas, const float x_center, const float
     }
 }
 
-void draw_player(engine::Canvas &canvas, const Player &player) {
+void draw_player(engine::Canvas &canvas, const glm::vec3 position) {
     //    /*\ v0
     //   /   \
     //  /  * v3
@@ -205,14 +351,14 @@ void draw_player(engine::Canvas &canvas, const Player &player) {
     math::Vector2f v2 { 0.0f, 2.0f * 64 };
     math::Vector2f v3 { 1.0f * 64, 1.8f * 64 };
 
-    v0.x += player.position.x;
-    v0.y += player.position.y;
-    v1.x += player.position.x;
-    v1.y += player.position.y;
-    v2.x += player.position.x;
-    v2.y += player.position.y;
-    v3.x += player.position.x;
-    v3.y += player.position.y;
+    v0.x += position.x;
+    v0.y += position.y;
+    v1.x += position.x;
+    v1.y += position.y;
+    v2.x += position.x;
+    v2.y += position.y;
+    v3.x += position.x;
+    v3.y += position.y;
     
     engine::canvas::triangle_fill(canvas, v0, v3, v2, engine::color::red);
     engine::canvas::triangle_fill(canvas, v0, v1, v3, engine::color::red);
@@ -239,10 +385,18 @@ void game_state_playing_update(engine::Engine &engine, Game &game, float t, floa
 
     clear(c, background);
 
-    Player player;
-    player.position.x = 64;
-    player.position.y = 64;
-    draw_player(c, player);
+    if (game.first_frame) {
+        game.first_frame = false;
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - game.initializing_started;
+        log_info("Time to first frame: %.1f ms", elapsed.count());
+    }
+
+    entities::integrate(game.entities, dt);
+    spatial_hash::build(game.spatial_hash, game.entities);
+
+    if (entities::alive(game.entities, game.player)) {
+        draw_player(c, entities::position(game.entities, game.player));
+    }
 }
 
 void update(engine::Engine &engine, void *game_object, float t, float dt) {
@@ -257,6 +411,18 @@ void update(engine::Engine &engine, void *game_object, float t, float dt) {
         transition(engine, game_object, AppState::Initializing);
         break;
     }
+    case AppState::Initializing: {
+        if (wwise::banks_ready(game->wwise, INITIAL_BANKS, INITIAL_BANK_COUNT)) {
+            for (uint32_t i = 0; i < INITIAL_BANK_COUNT; ++i) {
+                if (wwise::bank_state(game->wwise, INITIAL_BANKS[i]) != wwise::BankState::Loaded) {
+                    log_fatal("Could not load bank: %u", INITIAL_BANKS[i]);
+                }
+            }
+
+            transition(engine, game_object, AppState::Playing);
+        }
+        break;
+    }
     case AppState::Playing: {
         game_state_playing_update(engine, *game, t, dt);
         break;
@@ -270,7 +436,8 @@ void update(engine::Engine &engine, void *game_object, float t, float dt) {
     }
     }
     
-    wwise::update();
+    note_scheduler::update(game->notes, game->wwise);
+    wwise::update(game->wwise);
 }
 
 void on_input(engine::Engine &engine, void *game_object, engine::InputCommand &input_command) {
@@ -304,6 +471,9 @@ void on_input(engine::Engine &engine, void *game_object, engine::InputCommand &i
             break;
         }
         case (ActionHash::PLAY_DEBUG): {
+            if (pressed) {
+                note_scheduler::schedule(game->notes, game->wwise, event_for_degree(Degree::FIRST), game->wwise.unpositioned_game_object_id);
+            }
             break;
         }
         }
@@ -323,6 +493,59 @@ void render(engine::Engine &engine, void *game_object) {
     engine::render_canvas(engine, *game->canvas);
 }
 
+// Per worker share of the time since the sound engine started, jobs run by type, and wake latency.
+void render_job_stats(Game &game) {
+    wwise::JobStats stats;
+    if (!wwise::job_stats(game.wwise, stats)) {
+        ImGui::Text("The %s audio backend has no job workers", game.wwise.backend->name);
+        return;
+    }
+
+    const double elapsed = stats.elapsed_us > 0 ? (double)stats.elapsed_us : 1.0;
+    ImGui::Text("%u workers, %" PRIu64 " requests, %" PRIu64 " enqueue retries, spin budget %u us", stats.worker_count, stats.requests, stats.enqueue_retries, stats.spin_budget_us);
+    ImGui::Text("Queue depth mean %.2f max %u", stats.requests > 0 ? (double)stats.queue_depth_total / stats.requests : 0.0, stats.max_queue_depth);
+
+    if (ImGui::Button("Export trace")) {
+        wwise::write_job_trace(game.wwise, "audio_jobs_trace.json");
+    }
+
+    if (ImGui::BeginTable("workers", 12, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        const char *headers[] = {"Worker", "Busy", "Spin", "Parked", "Trims", "Generic", "Graph", "Spatial", "Tasks", "Wakes", "Wake us", "Depth"};
+        for (const char *header : headers) {
+            ImGui::TableSetupColumn(header);
+        }
+        ImGui::TableHeadersRow();
+
+        for (uint32_t i = 0; i < stats.worker_count; ++i) {
+            const wwise::JobWorkerStats &worker = stats.workers[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", i);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f%%", 100.0 * worker.busy_us / elapsed);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f%%", 100.0 * worker.spin_us / elapsed);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f%%", 100.0 * worker.parked_us / elapsed);
+            ImGui::TableNextColumn();
+            ImGui::Text("%" PRIu64 " (%.1f%%)", worker.trims, 100.0 * worker.trim_us / elapsed);
+            for (uint32_t type = 0; type < wwise::JOB_TYPE_COUNT; ++type) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%" PRIu64, worker.jobs[type]);
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%" PRIu64 " (%.1f%%)", worker.tasks, 100.0 * worker.task_us / elapsed);
+            ImGui::TableNextColumn();
+            ImGui::Text("%" PRIu64, worker.wakes);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f / %" PRIu64, worker.wakes > 0 ? (double)worker.wake_latency_us / worker.wakes : 0.0, worker.max_wake_latency_us);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", worker.queue_depth);
+        }
+        ImGui::EndTable();
+    }
+}
+
 void render_imgui(engine::Engine &engine, void *game_object) {
     (void)engine;
     
@@ -334,6 +557,12 @@ void render_imgui(engine::Engine &engine, void *game_object) {
     if (game->app_state != AppState::Playing) {
         return;
     }
+
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Audio jobs")) {
+        render_job_stats(*game);
+    }
+    ImGui::End();
 }
 
 bool on_shutdown(engine::Engine &engine, void *game_object) {
@@ -373,20 +602,42 @@ void transition(engine::Engine &engine, void *game_object, AppState app_state) {
     }
     case AppState::Initializing: {
         log_info("Initializing");
-        wwise::load_bank(game->wwise, "Mix_Master");
-        wwise::load_bank(game->wwise, "Debug_Sounds");
-        wwise::load_bank(game->wwise, "Player");
+        game->initializing_started = std::chrono::steady_clock::now();
+
+        // Banks load on the bank thread while the canvas and sprites are set up. The update waits for them to finish.
+        for (uint32_t i = 0; i < INITIAL_BANK_COUNT; ++i) {
+            wwise::load_bank_async(game->wwise, INITIAL_BANKS[i]);
+        }
+
         engine::init_canvas(engine, *game->canvas, game->config);
-        
-        transition(engine, game_object, AppState::Playing);
+        game->wwise.screen_height = (float)game->canvas->height;
+        engine::init_sprites(*game->sprites, engine::config::read_property(game->config, "game", "atlas_filename"));
+
+        game->player = entities::create(game->entities);
+        entities::set_position(game->entities, game->player, glm::vec3{64.0f, 64.0f, 0.0f});
         break;
     }
     case AppState::Playing: {
-        log_info("Playing");
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - game->initializing_started;
+        log_info("Playing, initialized in %.1f ms", elapsed.count());
+        game->first_frame = true;
+        note_scheduler::start(game->notes, game->wwise);
         break;
     }
     case AppState::Quitting: {
         log_info("Quitting");
+
+        wwise::AudioLatencyStats latency = wwise::audio_latency_stats(game->wwise);
+        if (latency.count > 0) {
+            log_info("Audio latency over %" PRIu64 " posts: mean %.1f ms, min %.1f ms, max %.1f ms, plus %.1f ms audio frame", latency.count, latency.mean_us / 1000.0, latency.min_us / 1000.0, latency.max_us / 1000.0, latency.audio_frame_us / 1000.0);
+        }
+
+        wwise::ScheduleStats schedule = wwise::schedule_stats(game->wwise);
+        if (schedule.count > 0) {
+            log_info("Note timing error over %" PRIu64 " notes at %u Hz: mean %u samples, min %d, max %d, %" PRIu64 " late", schedule.count, schedule.sample_rate, schedule.mean_abs, schedule.min, schedule.max, schedule.late);
+        }
+
+        log_info("Game tasks: %" PRIu64 " run on audio job workers, %" PRIu64 " on waiting threads", game->tasks.run_on_workers.load(), game->tasks.run_on_waiters.load());
         break;
     }
     case AppState::Terminate: {
@@ -3,7 +3,12 @@
 #include "collection_types.h"
 #include "memory_types.h"
 #include <glm/glm.hpp>
+#include <chrono>
 #include "wwise.h"
+#include "note_scheduler.h"
+#include "task_system.h"
+#include "entities.h"
+#include "spatial_hash.h"
 
 typedef struct ini_t ini_t;
 
@@ -57,11 +62,6 @@ enum class Degree : int {
     OCTAVE = 8,
 };
 
-struct Player {
-    glm::vec3 position = {0.0f, 0.0f, 0.0f};
-    float rot = 0.0f;
-};
-
 struct Game {
     Game(foundation::Allocator &allocator, const char *config_path);
     ~Game();
@@ -76,6 +76,15 @@ struct Game {
     
     foundation::Array<math::Color4f> palette;
     wwise::Wwise wwise;
+    TaskSystem tasks;
+    NoteScheduler notes;
+
+    Entities entities;
+    SpatialHash spatial_hash;
+    Entity player;
+
+    std::chrono::steady_clock::time_point initializing_started;
+    bool first_frame;
 };
 
 /**
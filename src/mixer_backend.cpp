@@ -0,0 +1,570 @@
+#include "audio_backend.h"
+#include "wwise_names.h"
+
+#pragma warning(push, 0)
+#include "array.h"
+#include "hash.h"
+#include "memory.h"
+
+#include <engine/file.h>
+#include <engine/log.h>
+
+#include <math.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#define PLOP_MIXER_SSE 1
+#endif
+#pragma warning(pop)
+
+namespace wwise {
+
+using namespace foundation;
+
+namespace {
+
+// The mixer doesn't resample, media at other rates is skipped.
+constexpr uint32_t MIXER_SAMPLE_RATE = 48000;
+constexpr uint32_t MIXER_FRAME_LENGTH = 1024;
+constexpr const char *MIXER_MEDIA_PATH = "plop_wwise/Originals/SFX/";
+
+// Frames mixed by one render at most. The rest of the frames due after a stall are skipped, like a device underrun.
+constexpr uint32_t MIXER_MAX_FRAMES_PER_RENDER = 8;
+
+// Decoded media of an event, as interleaved stereo in MixerBackend::sample_data.
+struct Sample {
+    AkUniqueID event_id;
+    AkBankID bank_id;
+    uint32_t offset;
+    uint32_t frames;
+};
+
+struct Voice {
+    AkPlayingID playing_id;
+    AkUniqueID event_id;
+    AkGameObjectID game_object_id;
+    uint32_t cursor;
+
+    // Samples from the start of the next rendered frame until the voice starts.
+    uint32_t delay;
+    void *start_cookie;
+};
+
+struct MixerBackend {
+    MixerBackend(Allocator &allocator)
+    : allocator(allocator)
+    , callbacks()
+    , mutex()
+    , sample_data(allocator)
+    , samples(allocator)
+    , sample_by_event(allocator)
+    , voices(allocator)
+    , positions(allocator)
+    , listener_id(AK_INVALID_GAME_OBJECT)
+    , next_playing_id(0)
+    , sample_clock(0)
+    , start_us(steady_clock_us())
+    , output(allocator)
+    , output_func(nullptr)
+    , output_cookie(nullptr) {}
+
+    Allocator &allocator;
+    BackendCallbacks callbacks;
+
+    // Guards everything below, the game thread and the render thread both call in.
+    std::mutex mutex;
+
+    Array<float> sample_data;
+    Array<Sample> samples;
+    Hash<uint32_t> sample_by_event; // Index into samples by event ID.
+
+    Array<Voice> voices;
+    Hash<AkVector> positions;
+    AkGameObjectID listener_id;
+    AkPlayingID next_playing_id;
+    uint64_t sample_clock;
+    int64_t start_us;
+
+    Array<float> output;
+    MixerOutput output_func;
+    void *output_cookie;
+};
+
+uint16_t read_u16(const char *p) {
+    return (uint16_t)((uint8_t)p[0] | ((uint8_t)p[1] << 8));
+}
+
+uint32_t read_u32(const char *p) {
+    return (uint32_t)read_u16(p) | ((uint32_t)read_u16(p + 2) << 16);
+}
+
+// Decodes a 16 or 24 bit PCM or 32 bit float, mono or stereo wav file and appends it to sample_data as stereo.
+bool decode_wav(const Array<char> &file, const char *path, Array<float> &sample_data, uint32_t &frames) {
+    const char *p = array::begin(file);
+    const char *pe = array::end(file);
+
+    if (pe - p < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0) {
+        log_error("Could not parse: %s, not a wav file", path);
+        return false;
+    }
+    p += 12;
+
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint32_t sample_rate = 0;
+    uint16_t bits = 0;
+    const char *data = nullptr;
+    uint32_t data_size = 0;
+
+    while (pe - p >= 8) {
+        uint32_t chunk_size = read_u32(p + 4);
+        const char *chunk = p + 8;
+        if ((uint64_t)chunk_size > (uint64_t)(pe - chunk)) {
+            break;
+        }
+
+        if (memcmp(p, "fmt ", 4) == 0 && chunk_size >= 16) {
+            format = read_u16(chunk);
+            channels = read_u16(chunk + 2);
+            sample_rate = read_u32(chunk + 4);
+            bits = read_u16(chunk + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE keeps the actual format in the sub format GUID.
+            if (format == 0xfffe && chunk_size >= 26) {
+                format = read_u16(chunk + 24);
+            }
+        } else if (memcmp(p, "data", 4) == 0) {
+            data = chunk;
+            data_size = chunk_size;
+        }
+
+        p = chunk + chunk_size + (chunk_size & 1);
+    }
+
+    if (!data || channels < 1 || channels > 2) {
+        log_error("Could not parse: %s, invalid file format", path);
+        return false;
+    }
+
+    if (sample_rate != MIXER_SAMPLE_RATE) {
+        log_error("Skipping %s, the sample rate %u isn't %u", path, sample_rate, MIXER_SAMPLE_RATE);
+        return false;
+    }
+
+    bool pcm16 = format == 1 && bits == 16;
+    bool pcm24 = format == 1 && bits == 24;
+    bool float32 = format == 3 && bits == 32;
+    if (!pcm16 && !pcm24 && !float32) {
+        log_error("Skipping %s, unsupported sample format %u with %u bits", path, format, bits);
+        return false;
+    }
+
+    uint32_t bytes_per_sample = bits / 8;
+    frames = data_size / (bytes_per_sample * channels);
+
+    uint32_t offset = array::size(sample_data);
+    array::resize(sample_data, offset + frames * 2);
+    float *out = array::begin(sample_data) + offset;
+
+    for (uint32_t i = 0; i < frames * channels; ++i) {
+        const char *s = data + i * bytes_per_sample;
+        float value;
+        if (pcm16) {
+            value = (float)(int16_t)read_u16(s) / 32768.0f;
+        } else if (pcm24) {
+            int32_t v = (int32_t)(((uint32_t)(uint8_t)s[0] << 8) | ((uint32_t)(uint8_t)s[1] << 16) | ((uint32_t)(uint8_t)s[2] << 24)) >> 8;
+            value = (float)v / 8388608.0f;
+        } else {
+            uint32_t v = read_u32(s);
+            memcpy(&value, &v, sizeof(value));
+        }
+
+        if (channels == 1) {
+            out[i * 2] = value;
+            out[i * 2 + 1] = value;
+        } else {
+            out[i] = value;
+        }
+    }
+
+    return true;
+}
+
+void rebuild_sample_index(MixerBackend &mixer) {
+    hash::clear(mixer.sample_by_event);
+    for (uint32_t i = 0; i < array::size(mixer.samples); ++i) {
+        hash::set(mixer.sample_by_event, (uint64_t)mixer.samples[i].event_id, i);
+    }
+}
+
+// Loads the media of the events in the bank. Media that's missing or can't be decoded is logged and skipped, the
+// events are silent.
+void load_media(MixerBackend &mixer, AkBankID bank_id) {
+    std::scoped_lock lock(mixer.mutex);
+
+    for (uint32_t i = 0; i < names::EVENT_MEDIA_COUNT; ++i) {
+        const names::EventMedia &media = names::EVENT_MEDIA[i];
+        if (!names::in_bank(media.event_id, names::Kind::Event, bank_id) || hash::has(mixer.sample_by_event, (uint64_t)media.event_id)) {
+            continue;
+        }
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s%s", MIXER_MEDIA_PATH, media.file);
+
+        Array<char> file(mixer.allocator);
+        if (!engine::file::read(file, path)) {
+            log_error("Could not read media file: %s", path);
+            continue;
+        }
+
+        Sample sample;
+        sample.event_id = media.event_id;
+        sample.bank_id = bank_id;
+        sample.offset = array::size(mixer.sample_data);
+        sample.frames = 0;
+        if (!decode_wav(file, path, mixer.sample_data, sample.frames)) {
+            continue;
+        }
+
+        array::push_back(mixer.samples, sample);
+    }
+
+    rebuild_sample_index(mixer);
+}
+
+// Drops the media of the bank and compacts the sample data. Voices playing it stop at the next render.
+void unload_media(MixerBackend &mixer, AkBankID bank_id) {
+    std::scoped_lock lock(mixer.mutex);
+
+    Array<float> sample_data(mixer.allocator);
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < array::size(mixer.samples); ++i) {
+        Sample sample = mixer.samples[i];
+        if (sample.bank_id == bank_id) {
+            continue;
+        }
+
+        uint32_t offset = array::size(sample_data);
+        array::resize(sample_data, offset + sample.frames * 2);
+        memcpy(array::begin(sample_data) + offset, array::begin(mixer.sample_data) + sample.offset, sample.frames * 2 * sizeof(float));
+        sample.offset = offset;
+        mixer.samples[kept++] = sample;
+    }
+
+    array::resize(mixer.samples, kept);
+    mixer.sample_data = sample_data;
+    rebuild_sample_index(mixer);
+}
+
+void *mixer_init(Allocator &allocator, const BackendCallbacks &callbacks, const BackendSettings &) {
+    MixerBackend *mixer = MAKE_NEW(allocator, MixerBackend, allocator);
+    mixer->callbacks = callbacks;
+    array::resize(mixer->output, MIXER_FRAME_LENGTH * 2);
+    return mixer;
+}
+
+void mixer_term(Allocator &allocator, void *instance) {
+    MAKE_DELETE(allocator, MixerBackend, static_cast<MixerBackend *>(instance));
+}
+
+AKRESULT mixer_load_bank(void *instance, AkBankID bank_id) {
+    load_media(*static_cast<MixerBackend *>(instance), bank_id);
+    return AK_Success;
+}
+
+// Asynchronous operations complete right away.
+AKRESULT mixer_load_bank_async(void *instance, AkBankID bank_id, void *cookie) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    load_media(*mixer, bank_id);
+    mixer->callbacks.bank_loaded(bank_id, AK_Success, cookie);
+    return AK_Success;
+}
+
+AKRESULT mixer_unload_bank_async(void *instance, AkBankID bank_id, void *cookie) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    unload_media(*mixer, bank_id);
+    mixer->callbacks.bank_unloaded(bank_id, AK_Success, cookie);
+    return AK_Success;
+}
+
+// The decoded media of the loaded banks.
+uint64_t mixer_bank_memory_used(void *instance) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+    return (uint64_t)array::size(mixer->sample_data) * sizeof(float);
+}
+
+AKRESULT mixer_register_game_object(void *, AkGameObjectID, const char *) {
+    return AK_Success;
+}
+
+AKRESULT mixer_unregister_game_object(void *instance, AkGameObjectID game_object_id) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+
+    for (uint32_t i = 0; i < array::size(mixer->voices);) {
+        if (mixer->voices[i].game_object_id == game_object_id) {
+            mixer->voices[i] = array::back(mixer->voices);
+            array::pop_back(mixer->voices);
+        } else {
+            ++i;
+        }
+    }
+
+    hash::remove(mixer->positions, (uint64_t)game_object_id);
+    return AK_Success;
+}
+
+AKRESULT mixer_set_default_listener(void *instance, AkGameObjectID game_object_id) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+    mixer->listener_id = game_object_id;
+    return AK_Success;
+}
+
+uint32_t mixer_playing_count(void *instance, AkGameObjectID game_object_id) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < array::size(mixer->voices); ++i) {
+        count += mixer->voices[i].game_object_id == game_object_id ? 1 : 0;
+    }
+    return count;
+}
+
+AkPlayingID mixer_post_event(void *instance, AkUniqueID event_id, AkGameObjectID game_object_id, uint32_t frame_offset, void *start_cookie) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+
+    if (!hash::has(mixer->sample_by_event, (uint64_t)event_id)) {
+        return AK_INVALID_PLAYING_ID;
+    }
+
+    if (++mixer->next_playing_id == AK_INVALID_PLAYING_ID) {
+        ++mixer->next_playing_id;
+    }
+
+    Voice voice;
+    voice.playing_id = mixer->next_playing_id;
+    voice.event_id = event_id;
+    voice.game_object_id = game_object_id;
+    voice.cursor = 0;
+    voice.delay = frame_offset;
+    voice.start_cookie = start_cookie;
+    array::push_back(mixer->voices, voice);
+
+    return voice.playing_id;
+}
+
+// Stops right away, there's no fading.
+AKRESULT mixer_stop_event(void *instance, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+
+    for (uint32_t i = 0; i < array::size(mixer->voices);) {
+        const Voice &voice = mixer->voices[i];
+        if (voice.event_id == event_id && voice.game_object_id == game_object_id) {
+            mixer->voices[i] = array::back(mixer->voices);
+            array::pop_back(mixer->voices);
+        } else {
+            ++i;
+        }
+    }
+
+    return AK_Success;
+}
+
+AKRESULT mixer_seek_event(void *instance, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs position) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+
+    uint32_t cursor = (uint32_t)((uint64_t)(position > 0 ? position : 0) * MIXER_SAMPLE_RATE / 1000);
+    for (uint32_t i = 0; i < array::size(mixer->voices); ++i) {
+        Voice &voice = mixer->voices[i];
+        if (voice.event_id == event_id && voice.game_object_id == game_object_id) {
+            voice.cursor = cursor;
+        }
+    }
+
+    return AK_Success;
+}
+
+AKRESULT mixer_set_position(void *instance, AkGameObjectID game_object_id, const AkVector &position, const AkVector &, const AkVector &) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+    hash::set(mixer->positions, (uint64_t)game_object_id, position);
+    return AK_Success;
+}
+
+// Game parameters have no effect without the authored curves.
+AKRESULT mixer_set_game_parameter(void *, AkRtpcID, AkRtpcValue, AkGameObjectID) {
+    return AK_Success;
+}
+
+// Left and right gain from the direction to the game object in the listener's x axis.
+void voice_gains(const MixerBackend &mixer, AkGameObjectID game_object_id, float &left, float &right) {
+    AkVector origin;
+    origin.X = origin.Y = origin.Z = 0.0f;
+    AkVector listener = hash::get(mixer.positions, (uint64_t)mixer.listener_id, origin);
+
+    float pan = 0.0f;
+    if (hash::has(mixer.positions, (uint64_t)game_object_id)) {
+        AkVector position = hash::get(mixer.positions, (uint64_t)game_object_id, origin);
+        float dx = position.X - listener.X;
+        float dy = position.Y - listener.Y;
+        float dz = position.Z - listener.Z;
+        float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+        pan = distance > 1.0f ? dx / distance : dx;
+    }
+
+    // Constant power pan.
+    float angle = (pan + 1.0f) * 0.25f * (float)M_PI;
+    left = cosf(angle);
+    right = sinf(angle);
+}
+
+// Mixes one audio frame and advances the sample clock, with the mutex held.
+void mix_frame(MixerBackend &mixer) {
+    float *out = array::begin(mixer.output);
+    memset(out, 0, MIXER_FRAME_LENGTH * 2 * sizeof(float));
+
+    for (uint32_t i = 0; i < array::size(mixer.voices);) {
+        Voice &voice = mixer.voices[i];
+
+        uint32_t sample_index = hash::get(mixer.sample_by_event, (uint64_t)voice.event_id, UINT32_MAX);
+        if (sample_index == UINT32_MAX || voice.cursor >= mixer.samples[sample_index].frames) {
+            mixer.voices[i] = array::back(mixer.voices);
+            array::pop_back(mixer.voices);
+            continue;
+        }
+
+        if (voice.delay >= MIXER_FRAME_LENGTH) {
+            voice.delay -= MIXER_FRAME_LENGTH;
+            ++i;
+            continue;
+        }
+
+        if (voice.start_cookie) {
+            mixer.callbacks.event_started(voice.start_cookie, mixer.sample_clock + voice.delay);
+            voice.start_cookie = nullptr;
+        }
+
+        const Sample &sample = mixer.samples[sample_index];
+        const float *in = array::begin(mixer.sample_data) + sample.offset + voice.cursor * 2;
+        float *voice_out = out + voice.delay * 2;
+        uint32_t frames = sample.frames - voice.cursor;
+        frames = frames < MIXER_FRAME_LENGTH - voice.delay ? frames : MIXER_FRAME_LENGTH - voice.delay;
+        voice.delay = 0;
+
+        float left, right;
+        voice_gains(mixer, voice.game_object_id, left, right);
+
+        uint32_t frame = 0;
+#if defined(PLOP_MIXER_SSE)
+        // Two stereo frames per iteration.
+        __m128 gain = _mm_setr_ps(left, right, left, right);
+        for (; frame + 2 <= frames; frame += 2) {
+            __m128 mixed = _mm_add_ps(_mm_loadu_ps(voice_out + frame * 2), _mm_mul_ps(_mm_loadu_ps(in + frame * 2), gain));
+            _mm_storeu_ps(voice_out + frame * 2, mixed);
+        }
+#endif
+        for (; frame < frames; ++frame) {
+            voice_out[frame * 2] += in[frame * 2] * left;
+            voice_out[frame * 2 + 1] += in[frame * 2 + 1] * right;
+        }
+
+        voice.cursor += frames;
+        ++i;
+    }
+
+    mixer.sample_clock += MIXER_FRAME_LENGTH;
+
+    if (mixer.output_func) {
+        mixer.output_func(out, MIXER_FRAME_LENGTH, mixer.output_cookie);
+    }
+}
+
+// Mixes the frames a device would have consumed since the last call, none if it's called again within a frame.
+void mixer_render(void *instance) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+
+    const uint64_t due = real_time_sample_clock(mixer->start_us, MIXER_SAMPLE_RATE, MIXER_FRAME_LENGTH);
+    uint64_t frames = due > mixer->sample_clock ? (due - mixer->sample_clock) / MIXER_FRAME_LENGTH : 0;
+    if (frames > MIXER_MAX_FRAMES_PER_RENDER) {
+        mixer->sample_clock += (frames - MIXER_MAX_FRAMES_PER_RENDER) * MIXER_FRAME_LENGTH;
+        frames = MIXER_MAX_FRAMES_PER_RENDER;
+    }
+
+    for (uint64_t i = 0; i < frames; ++i) {
+        mix_frame(*mixer);
+    }
+}
+
+void mixer_audio_format(void *, uint32_t &sample_rate, uint32_t &frame_length) {
+    sample_rate = MIXER_SAMPLE_RATE;
+    frame_length = MIXER_FRAME_LENGTH;
+}
+
+uint64_t mixer_sample_clock(void *instance) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+    return mixer->sample_clock;
+}
+
+// Everything is mixed on the render thread, there are no job workers.
+bool mixer_job_stats(void *, JobStats &) {
+    return false;
+}
+
+bool mixer_write_job_trace(void *, const char *) {
+    return false;
+}
+
+uint32_t mixer_set_task_runner(void *, const TaskRunner *) {
+    return 0;
+}
+
+void mixer_request_task_workers(void *, uint32_t) {}
+
+} // namespace
+
+const Backend MIXER_BACKEND = {
+    "mixer",
+    true,
+    mixer_init,
+    mixer_term,
+    mixer_load_bank,
+    mixer_load_bank_async,
+    mixer_unload_bank_async,
+    mixer_bank_memory_used,
+    mixer_register_game_object,
+    mixer_unregister_game_object,
+    mixer_set_default_listener,
+    mixer_playing_count,
+    mixer_post_event,
+    mixer_stop_event,
+    mixer_seek_event,
+    mixer_set_position,
+    mixer_set_game_parameter,
+    mixer_render,
+    mixer_audio_format,
+    mixer_sample_clock,
+    mixer_job_stats,
+    mixer_write_job_trace,
+    mixer_set_task_runner,
+    mixer_request_task_workers,
+};
+
+void set_mixer_output(void *instance, MixerOutput output, void *cookie) {
+    MixerBackend *mixer = static_cast<MixerBackend *>(instance);
+    std::scoped_lock lock(mixer->mutex);
+    mixer->output_func = output;
+    mixer->output_cookie = cookie;
+}
+
+} // namespace wwise
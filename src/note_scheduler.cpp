@@ -0,0 +1,110 @@
+#include "note_scheduler.h"
+#include "wwise.h"
+
+#include <array.h>
+#include <engine/log.h>
+
+#include <math.h>
+
+namespace plop {
+
+using namespace foundation;
+
+NoteScheduler::NoteScheduler(Allocator &allocator)
+: tempo_bpm(120.0f)
+, subdivisions(4)
+, lookahead_ms(40)
+, origin(0)
+, sample_rate(0)
+, pending(allocator) {}
+
+namespace note_scheduler {
+
+namespace {
+
+inline double step_samples(const NoteScheduler &scheduler) {
+    return (double)scheduler.sample_rate * 60.0 / ((double)scheduler.tempo_bpm * (double)scheduler.subdivisions);
+}
+
+inline uint64_t lookahead_samples(const NoteScheduler &scheduler) {
+    return (uint64_t)scheduler.sample_rate * scheduler.lookahead_ms / 1000;
+}
+
+} // namespace
+
+void start(NoteScheduler &scheduler, const wwise::Wwise &wwise) {
+    if (scheduler.tempo_bpm <= 0.0f || scheduler.subdivisions == 0) {
+        log_fatal("Invalid note scheduler tempo %.1f bpm with %u subdivisions", scheduler.tempo_bpm, scheduler.subdivisions);
+    }
+
+    scheduler.sample_rate = wwise::sample_rate(wwise);
+    scheduler.origin = wwise::sample_clock(wwise) + lookahead_samples(scheduler);
+    array::clear(scheduler.pending);
+
+    if (scheduler.sample_rate == 0) {
+        log_error("The audio backend has no sample clock, notes play when scheduled");
+    }
+}
+
+uint64_t step_time(const NoteScheduler &scheduler, uint64_t step) {
+    // From the origin each time, so rounding doesn't accumulate.
+    return scheduler.origin + (uint64_t)llround((double)step * step_samples(scheduler));
+}
+
+uint64_t schedule(NoteScheduler &scheduler, wwise::Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id) {
+    const uint64_t clock = wwise::sample_clock(wwise);
+    if (scheduler.sample_rate == 0) {
+        wwise::queue_post_event(wwise, event_id, game_object_id, wwise::Lane::Priority);
+        return clock;
+    }
+
+    const uint64_t earliest = clock + lookahead_samples(scheduler);
+    uint64_t step = 0;
+    if (earliest > scheduler.origin) {
+        step = (uint64_t)ceil((double)(earliest - scheduler.origin) / step_samples(scheduler));
+    }
+
+    schedule_at_step(scheduler, step, event_id, game_object_id);
+    return step_time(scheduler, step);
+}
+
+void schedule_at_step(NoteScheduler &scheduler, uint64_t step, AkUniqueID event_id, AkGameObjectID game_object_id) {
+    ScheduledNote note;
+    note.sample_time = step_time(scheduler, step);
+    note.event_id = event_id;
+    note.game_object_id = game_object_id;
+
+    // Pending is kept latest first, so due notes pop off the back.
+    array::push_back(scheduler.pending, note);
+    uint32_t i = array::size(scheduler.pending) - 1;
+    while (i > 0 && scheduler.pending[i - 1].sample_time < note.sample_time) {
+        scheduler.pending[i] = scheduler.pending[i - 1];
+        --i;
+    }
+    scheduler.pending[i] = note;
+}
+
+void update(NoteScheduler &scheduler, wwise::Wwise &wwise) {
+    if (array::empty(scheduler.pending)) {
+        return;
+    }
+
+    const uint64_t window_end = wwise::sample_clock(wwise) + lookahead_samples(scheduler);
+    while (array::any(scheduler.pending)) {
+        const ScheduledNote &note = array::back(scheduler.pending);
+        if (note.sample_time > window_end) {
+            break;
+        }
+
+        // A full lane is retried next frame.
+        if (!wwise::queue_post_event_at(wwise, note.event_id, note.game_object_id, note.sample_time)) {
+            break;
+        }
+
+        array::pop_back(scheduler.pending);
+    }
+}
+
+} // namespace note_scheduler
+
+} // namespace plop
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "collection_types.h"
+#include "memory_types.h"
+#include "util.h"
+
+#include <stdint.h>
+
+#pragma warning(push, 0)
+#include <AK/SoundEngine/Common/AkTypes.h>
+#pragma warning(pop)
+
+namespace wwise {
+struct Wwise;
+} // namespace wwise
+
+namespace plop {
+
+struct ScheduledNote {
+    uint64_t sample_time;
+    AkUniqueID event_id;
+    AkGameObjectID game_object_id;
+};
+
+/**
+ * @brief Schedules notes on a beat grid against the sound engine's sample clock.
+ *
+ * Notes are quantized to the next grid step at least the lookahead away, and held
+ * here until they're within the lookahead, when they're queued to start at their
+ * sample. So a note's timing doesn't depend on when in a game frame it was played,
+ * as long as the lookahead covers a game frame and an audio frame.
+ */
+struct NoteScheduler {
+    NoteScheduler(foundation::Allocator &allocator);
+    DELETE_COPY_AND_MOVE(NoteScheduler)
+
+    float tempo_bpm;
+
+    // Grid steps per beat.
+    uint32_t subdivisions;
+
+    uint32_t lookahead_ms;
+
+    // Sample clock time of the first grid step, and the sample rate the grid was laid out at.
+    uint64_t origin;
+    uint32_t sample_rate;
+
+    // Notes further ahead than the lookahead, latest first, so the next one due is popped from the back.
+    foundation::Array<ScheduledNote> pending;
+};
+
+namespace note_scheduler {
+
+// Lays out the grid from the next grid step after the lookahead, at the tempo and subdivisions of the scheduler.
+// Pending notes are dropped.
+void start(NoteScheduler &scheduler, const wwise::Wwise &wwise);
+
+// Sample clock time of a grid step.
+uint64_t step_time(const NoteScheduler &scheduler, uint64_t step);
+
+// Schedules the event at the next grid step at least the lookahead away. Returns its sample time.
+uint64_t schedule(NoteScheduler &scheduler, wwise::Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id);
+
+// Schedules the event at a grid step. It's queued by the next update, steps already within the lookahead start late.
+void schedule_at_step(NoteScheduler &scheduler, uint64_t step, AkUniqueID event_id, AkGameObjectID game_object_id);
+
+// Queues the pending notes that are within the lookahead. Called once per frame before wwise::update.
+void update(NoteScheduler &scheduler, wwise::Wwise &wwise);
+
+} // namespace note_scheduler
+
+} // namespace plop
@@ -0,0 +1,168 @@
+#include "spatial_hash.h"
+
+#include <array.h>
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+namespace plop {
+
+using namespace foundation;
+
+namespace {
+
+inline int32_t cell_coord(const SpatialHash &spatial_hash, float v) {
+    return (int32_t)floorf(v * spatial_hash.inv_cell_size);
+}
+
+inline uint64_t cell_key(int32_t cx, int32_t cy) {
+    return ((uint64_t)(uint32_t)cx << 32) | (uint64_t)(uint32_t)cy;
+}
+
+inline uint32_t cell_bucket(const SpatialHash &spatial_hash, int32_t cx, int32_t cy) {
+    return (((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u)) & spatial_hash.bucket_mask;
+}
+
+// Calls visit(sorted_index) for every item whose cell overlaps the box in the canvas plane.
+template <typename F>
+void for_each_in_cells(const SpatialHash &spatial_hash, float min_x, float min_y, float max_x, float max_y, F visit) {
+    if (array::size(spatial_hash.entity) == 0) {
+        return;
+    }
+
+    const int32_t cx0 = cell_coord(spatial_hash, min_x);
+    const int32_t cy0 = cell_coord(spatial_hash, min_y);
+    const int32_t cx1 = cell_coord(spatial_hash, max_x);
+    const int32_t cy1 = cell_coord(spatial_hash, max_y);
+
+    // A query covering more cells than there are buckets is cheaper as a linear scan.
+    const uint64_t cells = (uint64_t)(cx1 - cx0 + 1) * (uint64_t)(cy1 - cy0 + 1);
+    if (cells > spatial_hash.bucket_mask + 1) {
+        for (uint32_t i = 0; i < array::size(spatial_hash.entity); ++i) {
+            visit(i);
+        }
+        return;
+    }
+
+    for (int32_t cy = cy0; cy <= cy1; ++cy) {
+        for (int32_t cx = cx0; cx <= cx1; ++cx) {
+            const uint32_t bucket = cell_bucket(spatial_hash, cx, cy);
+            const uint64_t key = cell_key(cx, cy);
+
+            // Buckets are shared by all cells hashing to them, so skip the items of other cells.
+            for (uint32_t i = spatial_hash.bucket_start[bucket]; i < spatial_hash.bucket_start[bucket + 1]; ++i) {
+                if (spatial_hash.cell[i] == key) {
+                    visit(i);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+SpatialHash::SpatialHash(Allocator &allocator, float cell_size, uint32_t bucket_count_log2)
+: cell_size(cell_size)
+, inv_cell_size(1.0f / cell_size)
+, bucket_mask((1u << bucket_count_log2) - 1)
+, bucket_start(allocator)
+, entity(allocator)
+, cell(allocator)
+, position_x(allocator)
+, position_y(allocator)
+, position_z(allocator)
+, item_bucket(allocator) {
+    assert(cell_size > 0.0f);
+    array::resize(bucket_start, bucket_mask + 2);
+    memset(array::begin(bucket_start), 0, array::size(bucket_start) * sizeof(uint32_t));
+}
+
+namespace spatial_hash {
+
+void build(SpatialHash &spatial_hash, const Entities &entities) {
+    const uint32_t n = entities::count(entities);
+    const uint32_t bucket_count = spatial_hash.bucket_mask + 1;
+
+    array::resize(spatial_hash.item_bucket, n);
+    array::resize(spatial_hash.entity, n);
+    array::resize(spatial_hash.cell, n);
+    array::resize(spatial_hash.position_x, n);
+    array::resize(spatial_hash.position_y, n);
+    array::resize(spatial_hash.position_z, n);
+
+    uint32_t *start = array::begin(spatial_hash.bucket_start);
+    memset(start, 0, (bucket_count + 1) * sizeof(uint32_t));
+
+    // Count items per bucket, offset by one so the prefix sum below yields start indices.
+    for (uint32_t i = 0; i < n; ++i) {
+        const int32_t cx = cell_coord(spatial_hash, entities.position_x[i]);
+        const int32_t cy = cell_coord(spatial_hash, entities.position_y[i]);
+        const uint32_t bucket = cell_bucket(spatial_hash, cx, cy);
+        spatial_hash.item_bucket[i] = bucket;
+        ++start[bucket + 1];
+    }
+
+    for (uint32_t b = 0; b < bucket_count; ++b) {
+        start[b + 1] += start[b];
+    }
+
+    // Scatter, using start[b] as the write cursor, then shift the starts back into place.
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t bucket = spatial_hash.item_bucket[i];
+        const uint32_t dst = start[bucket]++;
+
+        const float x = entities.position_x[i];
+        const float y = entities.position_y[i];
+        spatial_hash.entity[dst] = entities.entity[i];
+        spatial_hash.cell[dst] = cell_key(cell_coord(spatial_hash, x), cell_coord(spatial_hash, y));
+        spatial_hash.position_x[dst] = x;
+        spatial_hash.position_y[dst] = y;
+        spatial_hash.position_z[dst] = entities.position_z[i];
+    }
+
+    for (uint32_t b = bucket_count; b > 0; --b) {
+        start[b] = start[b - 1];
+    }
+    start[0] = 0;
+}
+
+void query_radius(const SpatialHash &spatial_hash, glm::vec3 center, float radius, Array<Entity> &results) {
+    const float r2 = radius * radius;
+
+    for_each_in_cells(spatial_hash, center.x - radius, center.y - radius, center.x + radius, center.y + radius, [&](uint32_t i) {
+        const float dx = spatial_hash.position_x[i] - center.x;
+        const float dy = spatial_hash.position_y[i] - center.y;
+        const float dz = spatial_hash.position_z[i] - center.z;
+        if (dx * dx + dy * dy + dz * dz <= r2) {
+            array::push_back(results, spatial_hash.entity[i]);
+        }
+    });
+}
+
+void query_aabb(const SpatialHash &spatial_hash, glm::vec3 min, glm::vec3 max, Array<Entity> &results) {
+    for_each_in_cells(spatial_hash, min.x, min.y, max.x, max.y, [&](uint32_t i) {
+        const float x = spatial_hash.position_x[i];
+        const float y = spatial_hash.position_y[i];
+        const float z = spatial_hash.position_z[i];
+        if (x >= min.x && x <= max.x && y >= min.y && y <= max.y && z >= min.z && z <= max.z) {
+            array::push_back(results, spatial_hash.entity[i]);
+        }
+    });
+}
+
+void query_radius_batch(const SpatialHash &spatial_hash, const glm::vec3 *centers, const float *radii, uint32_t count, Array<Entity> &results, Array<uint32_t> &offsets) {
+    array::clear(results);
+    array::resize(offsets, count + 1);
+
+    for (uint32_t q = 0; q < count; ++q) {
+        offsets[q] = array::size(results);
+        query_radius(spatial_hash, centers[q], radii[q], results);
+    }
+
+    offsets[count] = array::size(results);
+}
+
+} // namespace spatial_hash
+
+} // namespace plop
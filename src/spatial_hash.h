@@ -0,0 +1,64 @@
+#pragma once
+
+#include "collection_types.h"
+#include "memory_types.h"
+#include "entities.h"
+#include "util.h"
+
+#include <glm/glm.hpp>
+#include <stdint.h>
+
+namespace plop {
+
+/**
+ * @brief A uniform grid over the canvas plane, hashed into a fixed number of buckets.
+ *
+ * Entities are bucketed by the x and y of their canvas-space position. The grid
+ * is rebuilt from an Entities store with a counting sort, so after a build all
+ * entities in a bucket are contiguous, together with a copy of their positions.
+ * Queries only visit the cells overlapping the query shape.
+ */
+struct SpatialHash {
+    SpatialHash(foundation::Allocator &allocator, float cell_size, uint32_t bucket_count_log2 = 12);
+    DELETE_COPY_AND_MOVE(SpatialHash)
+
+    float cell_size;
+    float inv_cell_size;
+    uint32_t bucket_mask;
+
+    // bucket_start[b] .. bucket_start[b + 1] is the range of sorted items in bucket b.
+    foundation::Array<uint32_t> bucket_start;
+
+    // Sorted by bucket.
+    foundation::Array<Entity> entity;
+    foundation::Array<uint64_t> cell;
+    foundation::Array<float> position_x;
+    foundation::Array<float> position_y;
+    foundation::Array<float> position_z;
+
+    // Scratch for the build, indexed by dense entity index.
+    foundation::Array<uint32_t> item_bucket;
+};
+
+namespace spatial_hash {
+
+// Rebuilds the grid from the current positions of all entities.
+void build(SpatialHash &spatial_hash, const Entities &entities);
+
+// Appends all entities within radius of center to results.
+void query_radius(const SpatialHash &spatial_hash, glm::vec3 center, float radius, foundation::Array<Entity> &results);
+
+// Appends all entities inside the axis aligned box to results.
+void query_aabb(const SpatialHash &spatial_hash, glm::vec3 min, glm::vec3 max, foundation::Array<Entity> &results);
+
+/**
+ * @brief Runs a radius query for each of count centers.
+ *
+ * The results for query i are results[offsets[i]] .. results[offsets[i + 1]],
+ * so offsets ends up with count + 1 entries. Both arrays are cleared first.
+ */
+void query_radius_batch(const SpatialHash &spatial_hash, const glm::vec3 *centers, const float *radii, uint32_t count, foundation::Array<Entity> &results, foundation::Array<uint32_t> &offsets);
+
+} // namespace spatial_hash
+
+} // namespace plop
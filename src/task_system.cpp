@@ -0,0 +1,207 @@
+#include "task_system.h"
+#include "wwise.h"
+#include "audio_backend.h"
+
+#include <array.h>
+#include <queue.h>
+#include <engine/log.h>
+
+#include <thread>
+
+namespace plop {
+
+using namespace foundation;
+
+namespace {
+
+// Tasks a parallel_for is split into at most, so the ranges fit on the stack.
+constexpr uint32_t MAX_PARALLEL_FOR_TASKS = 64;
+
+// Ready tasks queued before the queue grows.
+constexpr uint32_t INITIAL_TASK_CAPACITY = 256;
+
+struct RangeTask {
+    task_system::RangeFunction function;
+    void *data;
+    uint32_t begin;
+    uint32_t end;
+};
+
+void run_range(void *data) {
+    RangeTask *range = static_cast<RangeTask *>(data);
+    range->function(range->data, range->begin, range->end);
+}
+
+inline bool ready(const Task &task) {
+    return !task.dependency || task.dependency->pending.load(std::memory_order_acquire) == 0;
+}
+
+// Moves the blocked tasks whose dependency is done to the ready queue. Returns how many moved.
+uint32_t release_blocked(TaskSystem &system) {
+    uint32_t released = 0;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < array::size(system.blocked); ++i) {
+        const Task &task = system.blocked[i];
+        if (ready(task)) {
+            queue::push_back(system.ready, task);
+            ++released;
+        } else {
+            system.blocked[kept++] = task;
+        }
+    }
+    array::resize(system.blocked, kept);
+    system.ready_count.fetch_add(released, std::memory_order_release);
+    return released;
+}
+
+// Runs the oldest ready task. Returns false if there was none.
+bool run_one(TaskSystem &system, bool on_worker) {
+    Task task;
+    {
+        std::scoped_lock lock(system.mutex);
+        if (queue::size(system.ready) == 0) {
+            return false;
+        }
+
+        task = system.ready[0];
+        queue::pop_front(system.ready);
+        system.ready_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    task.function(task.data);
+
+    // Tasks depending on the counter become ready. The workers went to sleep while they were blocked, so wake some.
+    if (task.counter && task.counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        uint32_t released = 0;
+        {
+            std::scoped_lock lock(system.mutex);
+            if (!array::empty(system.blocked)) {
+                released = release_blocked(system);
+            }
+        }
+        if (released > 0 && system.worker_count > 0) {
+            wwise::request_task_workers(system.wwise, released < system.worker_count ? released : system.worker_count);
+        }
+    }
+
+    (on_worker ? system.run_on_workers : system.run_on_waiters).fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool worker_run_task(void *cookie) {
+    return run_one(*static_cast<TaskSystem *>(cookie), true);
+}
+
+// Blocked tasks don't count, so workers sleep until the task completing their dependency wakes them.
+bool worker_has_task(void *cookie) {
+    return static_cast<TaskSystem *>(cookie)->ready_count.load(std::memory_order_acquire) > 0;
+}
+
+} // namespace
+
+TaskSystem::TaskSystem(Allocator &allocator, wwise::Wwise &wwise)
+: wwise(wwise)
+, worker_count(0)
+, mutex()
+, ready(allocator)
+, blocked(allocator)
+, ready_count(0)
+, run_on_workers(0)
+, run_on_waiters(0) {
+    queue::reserve(ready, INITIAL_TASK_CAPACITY);
+
+    wwise::TaskRunner runner;
+    runner.run_task = worker_run_task;
+    runner.has_task = worker_has_task;
+    runner.cookie = this;
+    worker_count = wwise::set_task_runner(wwise, &runner);
+
+    if (worker_count > 0) {
+        log_info("Game tasks run on %u audio job workers", worker_count);
+    } else {
+        log_info("The audio backend has no job workers, game tasks run on the threads waiting for them");
+    }
+}
+
+TaskSystem::~TaskSystem() {
+    if (worker_count > 0) {
+        wwise::set_task_runner(wwise, nullptr);
+    }
+
+    // Nobody waited for these, but their data may still expect them to run.
+    while (run_one(*this, false)) {
+    }
+}
+
+namespace task_system {
+
+void run(TaskSystem &system, TaskFunction function, void *data, TaskCounter *counter, const TaskCounter *dependency) {
+    Task task;
+    task.function = function;
+    task.data = data;
+    task.counter = counter;
+    task.dependency = dependency;
+
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A dependency reaching zero meanwhile releases the task from blocked, since that happens under the lock.
+    {
+        std::scoped_lock lock(system.mutex);
+        if (!ready(task)) {
+            array::push_back(system.blocked, task);
+            return;
+        }
+        queue::push_back(system.ready, task);
+        system.ready_count.fetch_add(1, std::memory_order_release);
+    }
+
+    if (system.worker_count > 0) {
+        wwise::request_task_workers(system.wwise, 1);
+    }
+}
+
+void wait(TaskSystem &system, TaskCounter &counter) {
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+        // Nothing ready, the rest is running on the workers.
+        if (!run_one(system, false)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void parallel_for(TaskSystem &system, uint32_t count, uint32_t batch_size, RangeFunction function, void *data) {
+    if (count == 0) {
+        return;
+    }
+
+    batch_size = batch_size > 0 ? batch_size : 1;
+    const uint32_t min_batch_size = (count + MAX_PARALLEL_FOR_TASKS - 1) / MAX_PARALLEL_FOR_TASKS;
+    batch_size = batch_size > min_batch_size ? batch_size : min_batch_size;
+
+    RangeTask ranges[MAX_PARALLEL_FOR_TASKS];
+    const uint32_t range_count = (count + batch_size - 1) / batch_size;
+
+    // One range needs no task.
+    if (range_count == 1 || system.worker_count == 0) {
+        function(data, 0, count);
+        return;
+    }
+
+    TaskCounter counter;
+    for (uint32_t i = 0; i < range_count; ++i) {
+        RangeTask &range = ranges[i];
+        range.function = function;
+        range.data = data;
+        range.begin = i * batch_size;
+        range.end = range.begin + batch_size < count ? range.begin + batch_size : count;
+        run(system, run_range, &range, &counter);
+    }
+
+    wait(system, counter);
+}
+
+} // namespace task_system
+
+} // namespace plop
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "collection_types.h"
+#include "memory_types.h"
+#include "util.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+namespace wwise {
+struct Wwise;
+} // namespace wwise
+
+namespace plop {
+
+// Counts the tasks run with it that haven't finished yet.
+struct TaskCounter {
+    std::atomic<uint32_t> pending{0};
+};
+
+typedef void (*TaskFunction)(void *data);
+
+struct Task {
+    TaskFunction function;
+    void *data;
+
+    // Decremented when the task has finished, or nullptr.
+    TaskCounter *counter;
+
+    // The task doesn't start before this reaches zero, or nullptr.
+    const TaskCounter *dependency;
+};
+
+/**
+ * @brief Runs game tasks on the sound engine's job workers.
+ *
+ * The workers run a task whenever they have no audio job waiting, one task at a
+ * time, so audio jobs take over at the next task boundary and tasks should be
+ * short. Without job workers, or while they're busy, tasks run on the threads
+ * waiting for them, so every task finishes by the time wait returns.
+ */
+struct TaskSystem {
+    TaskSystem(foundation::Allocator &allocator, wwise::Wwise &wwise);
+    ~TaskSystem();
+    DELETE_COPY_AND_MOVE(TaskSystem)
+
+    wwise::Wwise &wwise;
+
+    // Job workers running tasks, 0 if the audio backend has none.
+    uint32_t worker_count;
+
+    std::mutex mutex;
+
+    // Tasks that can start, in the order they were queued or became ready.
+    foundation::Queue<Task> ready;
+
+    // Tasks whose dependency hasn't reached zero. They move to ready when a task's counter drops to zero.
+    foundation::Array<Task> blocked;
+
+    // Size of ready, read by the workers without the lock.
+    std::atomic<uint32_t> ready_count;
+
+    std::atomic<uint64_t> run_on_workers;
+    std::atomic<uint64_t> run_on_waiters;
+};
+
+namespace task_system {
+
+// Queues the function to run with the data. The counter, if any, counts it until it has finished.
+void run(TaskSystem &system, TaskFunction function, void *data, TaskCounter *counter, const TaskCounter *dependency = nullptr);
+
+// Runs queued tasks until the counter reaches zero.
+void wait(TaskSystem &system, TaskCounter &counter);
+
+typedef void (*RangeFunction)(void *data, uint32_t begin, uint32_t end);
+
+// Calls the function for [0, count) in ranges of batch_size, spread over the workers and this thread, and returns
+// when all are done.
+void parallel_for(TaskSystem &system, uint32_t count, uint32_t batch_size, RangeFunction function, void *data);
+
+} // namespace task_system
+
+} // namespace plop
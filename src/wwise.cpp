@@ -1,34 +1,33 @@
 #include "wwise.h"
+#include "wwise_names.h"
+#include "audio_backend.h"
 
 #include "Wwise_IDs.h"
 
 #pragma warning(push, 0)
 #include "memory.h"
-#include "temp_allocator.h"
-#include "string_stream.h"
-#include "murmur_hash.h"
 #include "hash.h"
 
 #include <engine/log.h>
 
-#include <AK/SoundEngine/Common/AkMemoryMgr.h>
-#include <AK/SoundEngine/Common/AkModule.h>
-#include <AK/SoundEngine/Common/AkSoundEngine.h>
-#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
-#include <AK/SoundEngine/Common/IAkStreamMgr.h>
-#include "SoundEngine/Common/AKJobWorkerMgr.h"
-#include "SoundEngine/Common/AkFilePackageLowLevelIODeferred.h"
-
 #include <glm/glm.hpp>
 
-#if !defined AK_OPTIMIZED
-#include <AK/Comm/AkCommunication.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <assert.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define PLOP_WWISE_SSE2 1
 #endif
 
-#include <string>
-#include <locale>
-#include <codecvt>
-#include <inttypes.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #pragma warning(pop)
 
@@ -36,280 +35,1475 @@ namespace wwise {
 
 using namespace foundation;
 
-AkGameObjectID game_object_count = 0;
+// At most this many asynchronous bank operations are in flight at once.
+constexpr uint32_t BANK_COMPLETION_CAPACITY = 64;
 
-void local_output_func(AK::Monitor::ErrorCode in_eErrorCode, const AkOSChar *in_pszError, AK::Monitor::ErrorLevel in_eErrorLevel, AkPlayingID in_playingID, AkGameObjectID in_gameObjID) {
-    using namespace foundation::string_stream;
-    
-    TempAllocator128 ta;
-    Buffer ss(ta);
+struct BankCompletions;
 
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    std::string bytes = converter.to_bytes(in_pszError);
-    const char *message = bytes.c_str();
+// An asynchronous bank operation in flight, passed to the backend as the cookie.
+struct BankRequest {
+    BankCompletions *completions;
+    uint32_t index;
 
-    printf(ss, "(%d) %s", in_eErrorCode, message);
-    
-    if (in_playingID != AK_INVALID_PLAYING_ID) {
-        printf(ss, " playing id: %d", in_playingID);
+    // Bank::sequence of the load, so that the completion of a superseded load is ignored.
+    uint32_t sequence;
+};
+
+struct BankCompletion {
+    AkBankID bank_id;
+    AKRESULT result;
+    bool unload;
+    uint32_t request;
+
+    // Backend::bank_memory_used when the operation finished.
+    uint64_t bank_memory_used;
+};
+
+// Ring of finished asynchronous bank operations. The bank thread is the only producer and the game thread the only
+// consumer. Since in flight operations are capped at the capacity it never overflows.
+struct BankCompletions {
+    std::atomic<uint32_t> write = 0;
+    std::atomic<uint32_t> read = 0;
+    BankCompletion entries[BANK_COMPLETION_CAPACITY];
+
+    // Only used by the game thread.
+    BankRequest requests[BANK_COMPLETION_CAPACITY];
+    uint32_t free_requests[BANK_COMPLETION_CAPACITY];
+    uint32_t free_request_count = 0;
+
+    // For measuring memory in the callbacks.
+    const Backend *backend = nullptr;
+    void *backend_instance = nullptr;
+};
+
+// Bounded multiple producer, single consumer queue. A cell is free for the producer claiming position p when its
+// sequence is p, and holds a value for the consumer at position p when its sequence is p + 1. The capacity is a
+// power of two up to MAX_CAPACITY, chosen at init.
+template <typename T, uint32_t MAX_CAPACITY>
+struct MpscQueue {
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        T value;
+    };
+
+    alignas(64) std::atomic<uint32_t> write;
+    alignas(64) std::atomic<uint32_t> read;
+    uint32_t mask;
+    Cell cells[MAX_CAPACITY];
+};
+
+template <typename T, uint32_t MAX_CAPACITY>
+void init_queue(MpscQueue<T, MAX_CAPACITY> &queue, uint32_t capacity) {
+    assert((capacity & (capacity - 1)) == 0 && capacity <= MAX_CAPACITY);
+    queue.write.store(0, std::memory_order_relaxed);
+    queue.read.store(0, std::memory_order_relaxed);
+    queue.mask = capacity - 1;
+    for (uint32_t i = 0; i < capacity; ++i) {
+        queue.cells[i].sequence.store(i, std::memory_order_relaxed);
     }
-    
-    if (in_gameObjID != AK_INVALID_GAME_OBJECT) {
-        printf(ss, " object id: %d", in_gameObjID);
+}
+
+// Returns false if the queue is full. Never blocks.
+template <typename T, uint32_t MAX_CAPACITY>
+bool push(MpscQueue<T, MAX_CAPACITY> &queue, const T &value) {
+    uint32_t position = queue.write.load(std::memory_order_relaxed);
+    typename MpscQueue<T, MAX_CAPACITY>::Cell *cell;
+    for (;;) {
+        cell = &queue.cells[position & queue.mask];
+        const uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const int32_t difference = (int32_t)(sequence - position);
+        if (difference == 0) {
+            if (queue.write.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The consumer hasn't freed the cell from the previous lap yet.
+            return false;
+        } else {
+            position = queue.write.load(std::memory_order_relaxed);
+        }
     }
-    
-    if (in_eErrorLevel == AK::Monitor::ErrorLevel::ErrorLevel_Error) {
-        log_error(c_str(ss));
-    } else {
-        log_info(c_str(ss));
+
+    cell->value = value;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// Only called from the consumer thread.
+template <typename T, uint32_t MAX_CAPACITY>
+bool pop(MpscQueue<T, MAX_CAPACITY> &queue, T &value) {
+    const uint32_t position = queue.read.load(std::memory_order_relaxed);
+    typename MpscQueue<T, MAX_CAPACITY>::Cell &cell = queue.cells[position & queue.mask];
+    if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
     }
+
+    value = cell.value;
+    cell.sequence.store(position + queue.mask + 1, std::memory_order_release);
+    queue.read.store(position + 1, std::memory_order_relaxed);
+    return true;
 }
 
-Wwise::Wwise(Allocator &allocator)
-: allocator(allocator)
-, low_level_io(nullptr)
-, default_listener_id(0)
-, unpositioned_game_object_id(0)
-, loaded_banks(allocator) {
-    // MemoryMgr
-    {
-        AkMemSettings mem_settings;
-        AK::MemoryMgr::GetDefaultSettings(mem_settings);
-        AKRESULT result = AK::MemoryMgr::Init(&mem_settings);
-        if (result != AK_Success) {
-            log_fatal("Could not initialize AK::MemoryMgr: %d", result);
-        }
+template <typename T, uint32_t MAX_CAPACITY>
+uint32_t depth(const MpscQueue<T, MAX_CAPACITY> &queue) {
+    return queue.write.load(std::memory_order_acquire) - queue.read.load(std::memory_order_relaxed);
+}
+
+enum class CommandType : uint8_t {
+    PostEvent,
+    StopEvent,
+    SeekEvent,
+    PostEventAt,
+};
+
+struct Command {
+    CommandType type;
+    AkUniqueID event_id;
+    AkGameObjectID game_object_id;
+
+    // Fade duration for StopEvent, position for SeekEvent.
+    AkTimeMs time;
+
+    // Steady clock time when the command was queued, in microseconds.
+    int64_t queued_at;
+
+    // Sample clock time to start PostEventAt at.
+    uint64_t sample_time;
+};
+
+constexpr uint32_t COMMAND_LANE_CAPACITY[(uint32_t)Lane::Count] = {1024, 256};
+
+struct CommandLane {
+    MpscQueue<Command, 1024> queue;
+    std::atomic<uint64_t> dropped;
+
+    // Only written by the consumer, atomic so the stats can be read from any thread.
+    std::atomic<uint64_t> executed;
+    std::atomic<uint32_t> high_water;
+};
+
+// Queued posts whose sounds haven't started yet. More than this many in flight reuses slots and loses measurements.
+constexpr uint32_t LATENCY_SLOT_COUNT = 256;
+
+// Scheduled posts waiting for their audio frame. When full, further ones are posted right away.
+constexpr uint32_t SCHEDULED_CAPACITY = 256;
+
+// Audio frames ahead that scheduled posts are handed to a sample accurate backend. A render can mix more than one
+// frame when it runs late, and posts for the later frames must be in by then.
+constexpr uint32_t SCHEDULE_AHEAD_FRAMES = 8;
+
+struct CommandQueues;
+
+struct LatencySlot {
+    CommandQueues *queues;
+
+    // 0 once measured.
+    std::atomic<int64_t> queued_at;
+
+    // Sample clock time a PostEventAt asked to start at, to compare with when it did.
+    uint64_t sample_time;
+    bool scheduled;
+};
+
+struct CommandQueues {
+    CommandLane lanes[(uint32_t)Lane::Count];
+
+    LatencySlot latency_slots[LATENCY_SLOT_COUNT];
+    uint32_t next_latency_slot;
+
+    // Only written from the sound engine callback thread.
+    std::atomic<uint64_t> latency_count;
+    std::atomic<uint64_t> latency_sum;
+    std::atomic<uint32_t> latency_last;
+    std::atomic<uint32_t> latency_min;
+    std::atomic<uint32_t> latency_max;
+
+    // Only used by the consumer.
+    Command scheduled[SCHEDULED_CAPACITY];
+    uint32_t scheduled_count;
+
+    // Only written from the sound engine callback thread.
+    std::atomic<uint64_t> schedule_count;
+    std::atomic<uint64_t> schedule_late;
+    std::atomic<uint64_t> schedule_error_sum;
+    std::atomic<int32_t> schedule_error_last;
+    std::atomic<int32_t> schedule_error_min;
+    std::atomic<int32_t> schedule_error_max;
+};
+
+struct RenderThread {
+    std::thread thread;
+    std::atomic<bool> running;
+    uint32_t period_us;
+    std::atomic<uint64_t> ticks;
+    std::atomic<uint64_t> overruns;
+};
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Records how far from its sample time a scheduled post started.
+void record_schedule_error(CommandQueues *queues, uint64_t sample_time, uint64_t start_sample) {
+    const int64_t error = (int64_t)(start_sample - sample_time);
+    const int32_t clamped = error > INT32_MAX ? INT32_MAX : error < INT32_MIN ? INT32_MIN : (int32_t)error;
+
+    queues->schedule_error_last.store(clamped, std::memory_order_relaxed);
+    queues->schedule_error_sum.store(queues->schedule_error_sum.load(std::memory_order_relaxed) + (uint64_t)(clamped < 0 ? -(int64_t)clamped : clamped), std::memory_order_relaxed);
+    queues->schedule_count.store(queues->schedule_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (clamped > 0) {
+        queues->schedule_late.store(queues->schedule_late.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
     }
-    
-    // Monitor
-    {
-        AKRESULT result = AK::Monitor::SetLocalOutput(AK::Monitor::ErrorLevel::ErrorLevel_All, local_output_func); 
-        if (result != AK_Success) {
-            log_fatal("Could not AK::Monitor::SetLocalOutput: %d", result);
-        }
+    if (clamped < queues->schedule_error_min.load(std::memory_order_relaxed)) {
+        queues->schedule_error_min.store(clamped, std::memory_order_relaxed);
     }
-    
-    // StreamMgr
-    {
-        AkStreamMgrSettings stm_settings;
-        AK::StreamMgr::GetDefaultSettings(stm_settings);
-        AK::IAkStreamMgr *stream_manager = AK::StreamMgr::Create(stm_settings);
-        if (!stream_manager) {
-            log_fatal("Could not create AK::StreamMgt");
-        }
-        
-        AkDeviceSettings device_settings;
-        AK::StreamMgr::GetDefaultDeviceSettings(device_settings);
-        device_settings.bUseStreamCache = true;
-        
-        low_level_io = MAKE_NEW(allocator, CAkFilePackageLowLevelIODeferred);
-        AKRESULT result = ((CAkFilePackageLowLevelIODeferred *)low_level_io)->Init(device_settings);
-        if (result != AK_Success) {
-            log_fatal("Could not initialize CAkFilePackageLowLevelIODeferred: %d", result);
-        }
-        
-        // TODO: Replace this with config.ini setting
-        ((CAkFilePackageLowLevelIODeferred *)low_level_io)->SetBasePath(AKTEXT("plop_wwise/GeneratedSoundBanks/Windows"));
-        AK::StreamMgr::SetCurrentLanguage(AKTEXT("English(US)"));
+    if (clamped > queues->schedule_error_max.load(std::memory_order_relaxed)) {
+        queues->schedule_error_max.store(clamped, std::memory_order_relaxed);
     }
-    
-    // JobWorkerMgr
-    {
-        AK::JobWorkerMgr::InitSettings job_worker_settings;
-        AK::JobWorkerMgr::GetDefaultInitSettings(job_worker_settings);
-        job_worker_settings.uNumWorkerThreads = 8;
-        
-        AKRESULT result = AK::JobWorkerMgr::InitWorkers(job_worker_settings);
-        if (result != AK_Success) {
-            log_fatal("Could not initialize AK::JobWorkerMgr::InitWorkers: %d", result);
-        }
+}
+
+// Called when the sounds of a queued post start playing.
+void event_started(void *cookie, uint64_t start_sample) {
+    LatencySlot *slot = static_cast<LatencySlot *>(cookie);
+
+    // Only the first sound of the event counts.
+    const int64_t queued_at = slot->queued_at.exchange(0, std::memory_order_acquire);
+    if (queued_at == 0) {
+        return;
     }
-    
-    // SoundEngine
-    {
-        AkInitSettings init_settings;
-        AkPlatformInitSettings platform_init_settings;
-        AK::SoundEngine::GetDefaultInitSettings(init_settings);
-        AK::SoundEngine::GetDefaultPlatformInitSettings(platform_init_settings);
-        AKRESULT result = AK::SoundEngine::Init(&init_settings, &platform_init_settings);
-        if (result != AK_Success) {
-            log_fatal("Could not initialize AK::SoundEngine: %d", result);
+
+    CommandQueues *queues = slot->queues;
+    if (slot->scheduled) {
+        record_schedule_error(queues, slot->sample_time, start_sample);
+    }
+
+    const uint32_t latency = (uint32_t)(now_us() - queued_at);
+    queues->latency_last.store(latency, std::memory_order_relaxed);
+    queues->latency_sum.store(queues->latency_sum.load(std::memory_order_relaxed) + latency, std::memory_order_relaxed);
+    queues->latency_count.store(queues->latency_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (latency < queues->latency_min.load(std::memory_order_relaxed)) {
+        queues->latency_min.store(latency, std::memory_order_relaxed);
+    }
+    if (latency > queues->latency_max.load(std::memory_order_relaxed)) {
+        queues->latency_max.store(latency, std::memory_order_relaxed);
+    }
+}
+
+void init_command_lane(CommandLane &lane, uint32_t capacity) {
+    init_queue(lane.queue, capacity);
+    lane.dropped.store(0, std::memory_order_relaxed);
+    lane.executed.store(0, std::memory_order_relaxed);
+    lane.high_water.store(0, std::memory_order_relaxed);
+}
+
+bool push_command(CommandLane &lane, const Command &command) {
+    if (!push(lane.queue, command)) {
+        lane.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+uint64_t bank_memory_used(const Wwise &wwise) {
+    return wwise.backend->bank_memory_used(wwise.backend_instance);
+}
+
+void push_bank_completion(void *cookie, AkBankID bank_id, AKRESULT result, bool unload) {
+    const BankRequest *request = static_cast<const BankRequest *>(cookie);
+    BankCompletions *completions = request->completions;
+    const BankCompletion completion = {bank_id, result, unload, request->index, completions->backend->bank_memory_used(completions->backend_instance)};
+    uint32_t write = completions->write.load(std::memory_order_relaxed);
+    completions->entries[write % BANK_COMPLETION_CAPACITY] = completion;
+    completions->write.store(write + 1, std::memory_order_release);
+}
+
+void bank_loaded(AkBankID bank_id, AKRESULT result, void *cookie) {
+    push_bank_completion(cookie, bank_id, result, false);
+}
+
+void bank_unloaded(AkBankID bank_id, AKRESULT result, void *cookie) {
+    push_bank_completion(cookie, bank_id, result, true);
+}
+
+constexpr uint32_t MONITOR_MESSAGE_CAPACITY = 64;
+constexpr uint32_t MONITOR_MESSAGE_LENGTH = 256;
+
+struct MonitorMessage {
+    int32_t error_code;
+    bool error;
+    AkPlayingID playing_id;
+    AkGameObjectID game_object_id;
+
+    // Truncated and null terminated.
+    AkOSChar text[MONITOR_MESSAGE_LENGTH];
+};
+
+// Monitor output from the sound engine threads, logged by the game thread.
+struct MonitorMessages {
+    MpscQueue<MonitorMessage, MONITOR_MESSAGE_CAPACITY> queue;
+    std::atomic<uint32_t> dropped;
+};
+
+// The monitor output callback has no cookie.
+MonitorMessages *monitor_messages = nullptr;
+
+// Called from any sound engine thread, including the audio thread, so it only copies the message into the ring.
+void monitor_output(int32_t error_code, bool error, const AkOSChar *text, AkPlayingID playing_id, AkGameObjectID game_object_id) {
+    MonitorMessages *messages = monitor_messages;
+    if (!messages) {
+        return;
+    }
+
+    MonitorMessage message;
+    message.error_code = error_code;
+    message.error = error;
+    message.playing_id = playing_id;
+    message.game_object_id = game_object_id;
+
+    uint32_t length = 0;
+    while (text[length] && length < MONITOR_MESSAGE_LENGTH - 1) {
+        message.text[length] = text[length];
+        ++length;
+    }
+
+    // Don't leave half a surrogate pair at the cut.
+    if (sizeof(AkOSChar) == 2 && length > 0 && text[length] && (uint32_t)message.text[length - 1] - 0xd800u < 0x400u) {
+        --length;
+    }
+    message.text[length] = 0;
+
+    if (!push(messages->queue, message)) {
+        messages->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Writes s as null terminated UTF-8 into out, truncating at a code point boundary. Unpaired surrogates become
+// U+FFFD. Returns the number of bytes written, excluding the terminator.
+uint32_t to_utf8(const AkOSChar *s, char *out, uint32_t out_size) {
+    uint32_t n = 0;
+    for (const AkOSChar *c = s; *c; ++c) {
+        uint32_t code_point = (uint32_t)*c;
+        if (sizeof(AkOSChar) == 1) {
+            // Already UTF-8.
+        } else if (code_point - 0xd800u < 0x400u && (uint32_t)c[1] - 0xdc00u < 0x400u) {
+            code_point = 0x10000u + ((code_point - 0xd800u) << 10) + ((uint32_t)c[1] - 0xdc00u);
+            ++c;
+        } else if (code_point - 0xd800u < 0x800u || code_point > 0x10ffffu) {
+            code_point = 0xfffdu;
+        }
+
+        const uint32_t bytes = (sizeof(AkOSChar) == 1 || code_point < 0x80u) ? 1 : code_point < 0x800u ? 2 : code_point < 0x10000u ? 3 : 4;
+        if (n + bytes >= out_size) {
+            break;
+        }
+
+        if (bytes == 1) {
+            out[n++] = (char)code_point;
+        } else if (bytes == 2) {
+            out[n++] = (char)(0xc0u | (code_point >> 6));
+            out[n++] = (char)(0x80u | (code_point & 0x3fu));
+        } else if (bytes == 3) {
+            out[n++] = (char)(0xe0u | (code_point >> 12));
+            out[n++] = (char)(0x80u | ((code_point >> 6) & 0x3fu));
+            out[n++] = (char)(0x80u | (code_point & 0x3fu));
+        } else {
+            out[n++] = (char)(0xf0u | (code_point >> 18));
+            out[n++] = (char)(0x80u | ((code_point >> 12) & 0x3fu));
+            out[n++] = (char)(0x80u | ((code_point >> 6) & 0x3fu));
+            out[n++] = (char)(0x80u | (code_point & 0x3fu));
         }
     }
-    
-    // Plugins
+
+    out[n] = 0;
+    return n;
+}
+
+GameObjects::GameObjects(Allocator &allocator)
+: generation(allocator)
+, free_slots(allocator)
+, releasing(allocator)
+, registered(0) {
+}
+
+TransformStaging::TransformStaging(Allocator &allocator)
+: game_object(allocator)
+, position_x(allocator)
+, position_y(allocator)
+, position_z(allocator)
+, front_x(allocator)
+, front_y(allocator)
+, front_z(allocator)
+, top_x(allocator)
+, top_y(allocator)
+, top_z(allocator)
+, screen_space(allocator)
+, dirty(allocator)
+, submitted(0) {
+}
+
+Wwise::Wwise(Allocator &allocator, const BackendSettings &settings, const Backend *backend)
+: allocator(allocator)
+, backend(backend ? backend : &default_backend())
+, backend_instance(nullptr)
+, backend_calls()
+, default_listener_id(0)
+, unpositioned_game_object_id(0)
+, loaded_banks(allocator)
+, bank_memory_budget(0)
+, bank_memory(0)
+, bank_clock(0)
+, bank_sequence(0)
+, bank_completions(nullptr)
+, pending_bank_operations(0)
+, bank_memory_baseline(0)
+, game_objects(allocator)
+, transforms(allocator)
+, screen_height(0.0f)
+, game_parameters(allocator)
+, dirty_game_parameters(allocator)
+, object_game_parameters(allocator)
+, game_parameter_epsilon(0.0f)
+, game_parameter_quantum(0.0f)
+, game_parameter_stats{0, 0}
+, commands(nullptr)
+, monitor(nullptr)
+, render_thread(nullptr) {
+    bank_completions = MAKE_NEW(allocator, BankCompletions);
+    for (uint32_t i = 0; i < BANK_COMPLETION_CAPACITY; ++i) {
+        bank_completions->requests[i] = BankRequest{bank_completions, i, 0};
+        bank_completions->free_requests[i] = BANK_COMPLETION_CAPACITY - 1 - i;
+    }
+    bank_completions->free_request_count = BANK_COMPLETION_CAPACITY;
+
+    commands = MAKE_NEW(allocator, CommandQueues);
+    for (uint32_t i = 0; i < (uint32_t)Lane::Count; ++i) {
+        init_command_lane(commands->lanes[i], COMMAND_LANE_CAPACITY[i]);
+    }
+    for (uint32_t i = 0; i < LATENCY_SLOT_COUNT; ++i) {
+        commands->latency_slots[i].queues = commands;
+        commands->latency_slots[i].queued_at.store(0, std::memory_order_relaxed);
+        commands->latency_slots[i].sample_time = 0;
+        commands->latency_slots[i].scheduled = false;
+    }
+    commands->next_latency_slot = 0;
+    commands->latency_count.store(0, std::memory_order_relaxed);
+    commands->latency_sum.store(0, std::memory_order_relaxed);
+    commands->latency_last.store(0, std::memory_order_relaxed);
+    commands->latency_min.store(UINT32_MAX, std::memory_order_relaxed);
+    commands->latency_max.store(0, std::memory_order_relaxed);
+    commands->scheduled_count = 0;
+    commands->schedule_count.store(0, std::memory_order_relaxed);
+    commands->schedule_late.store(0, std::memory_order_relaxed);
+    commands->schedule_error_sum.store(0, std::memory_order_relaxed);
+    commands->schedule_error_last.store(0, std::memory_order_relaxed);
+    commands->schedule_error_min.store(INT32_MAX, std::memory_order_relaxed);
+    commands->schedule_error_max.store(INT32_MIN, std::memory_order_relaxed);
+
+    // Monitor
     {
-//        AK::SoundEngine::RegisterPlugin(A)
+        monitor = MAKE_NEW(allocator, MonitorMessages);
+        init_queue(monitor->queue, MONITOR_MESSAGE_CAPACITY);
+        monitor->dropped.store(0, std::memory_order_relaxed);
+        monitor_messages = monitor;
     }
 
-#if !defined AK_OPTIMIZED
-    // Communication
+    // Backend
     {
-        AkCommSettings comm_settings;
-        AK::Comm::GetDefaultInitSettings(comm_settings);
-        AKPLATFORM::SafeStrCpy(comm_settings.szAppNetworkName, "Plop", AK_COMM_SETTINGS_MAX_STRING_SIZE);
-        AKRESULT result = AK::Comm::Init(comm_settings);
-        if (result != AK_Success) {
-            log_fatal("Could not initialize AK::Comm: %d", result);
+        log_info("Audio backend: %s", this->backend->name);
+
+        const BackendCallbacks callbacks = {bank_loaded, bank_unloaded, event_started, monitor_output};
+        backend_instance = this->backend->init(allocator, callbacks, settings);
+        if (!backend_instance) {
+            log_fatal("Could not initialize the %s audio backend", this->backend->name);
         }
+
+        bank_completions->backend = this->backend;
+        bank_completions->backend_instance = backend_instance;
     }
-#endif
-    
+
     // Load Init bank
     {
-        load_bank(*this, "Init");
+        load_bank(*this, AK::BANKS::INIT);
     }
     
     // Listener
     {
-        default_listener_id = ++game_object_count;
+        default_listener_id = register_game_object(*this, "Default listener");
+        if (default_listener_id == AK_INVALID_GAME_OBJECT) {
+            log_fatal("Could not register the default listener");
+        }
 
-        AKRESULT result = AK::SoundEngine::RegisterGameObj(default_listener_id, "Default listener");
+        AKRESULT result = this->backend->set_default_listener(backend_instance, default_listener_id);
         if (result != AK_Success) {
-            log_fatal("Could not AK::SoundEngine::RegisterGameObj %d", result);
+            log_fatal("Could not set the default listener: %d", result);
         }
-
-        AK::SoundEngine::SetDefaultListeners(&default_listener_id, 1);
     }
     
     // Default objects
     {
-        unpositioned_game_object_id = register_game_object("Unpositioned game object");
+        unpositioned_game_object_id = register_game_object(*this, "Unpositioned game object");
+        if (unpositioned_game_object_id == AK_INVALID_GAME_OBJECT) {
+            log_fatal("Could not register the unpositioned game object");
+        }
     }
 }
 
 Wwise::~Wwise() {
-#if !defined(AK_OPTIMIZED)
-    AK::Comm::Term();
-#endif
+    stop_render_thread(*this);
 
-    AK::JobWorkerMgr::TermWorkers();
-    
-    if (AK::SoundEngine::IsInitialized()) {
-        AK::SoundEngine::UnregisterAllGameObj();
-        AK::SoundEngine::Term();
+    if (backend_instance) {
+        backend->term(allocator, backend_instance);
+        backend_instance = nullptr;
     }
-    
-    if (AK::IAkStreamMgr::Get()) {
-        if (low_level_io) {
-            ((CAkFilePackageLowLevelIODeferred *)low_level_io)->Term();
-            MAKE_DELETE(allocator, CAkFilePackageLowLevelIODeferred, (CAkFilePackageLowLevelIODeferred *)low_level_io);
-            low_level_io = nullptr;
+
+    MAKE_DELETE(allocator, BankCompletions, bank_completions);
+    MAKE_DELETE(allocator, CommandQueues, commands);
+
+    // Log what the sound engine reported while shutting down.
+    flush_monitor_messages(*this);
+    monitor_messages = nullptr;
+    MAKE_DELETE(allocator, MonitorMessages, monitor);
+}
+
+namespace {
+
+Bank find_bank(const Wwise &wwise, AkBankID bank_id) {
+    const Bank unloaded = {bank_id, BankState::Unloaded, AK_Success, 0, 0, 0, 0};
+    return hash::get(wwise.loaded_banks, (uint64_t)bank_id, unloaded);
+}
+
+// For logging only: banks are loaded and tracked by ID.
+const char *bank_log_name(AkBankID bank_id) {
+    const names::Bank *bank = names::find_bank(bank_id);
+    return bank ? bank->name : "not in the generated sound banks";
+}
+
+// Claims a request for an asynchronous bank operation, waiting for one to finish if they're all in flight.
+BankRequest *begin_bank_operation(Wwise &wwise, uint32_t sequence) {
+    BankCompletions &completions = *wwise.bank_completions;
+    while (completions.free_request_count == 0) {
+        update_banks(wwise);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // With nothing in flight, the next completion's bank is the only one changing bank memory from now on.
+    if (wwise.pending_bank_operations == 0) {
+        wwise.bank_memory_baseline = bank_memory_used(wwise);
+    }
+
+    ++wwise.pending_bank_operations;
+    BankRequest &request = completions.requests[completions.free_requests[--completions.free_request_count]];
+    request.sequence = sequence;
+    return &request;
+}
+
+void end_bank_operation(Wwise &wwise, const BankRequest &request) {
+    BankCompletions &completions = *wwise.bank_completions;
+    completions.free_requests[completions.free_request_count++] = request.index;
+    --wwise.pending_bank_operations;
+}
+
+void evict_bank(Wwise &wwise, const Bank &bank) {
+    hash::remove(wwise.loaded_banks, (uint64_t)bank.id);
+    wwise.bank_memory -= bank.memory;
+
+    BankRequest *request = begin_bank_operation(wwise, 0);
+    ++wwise.backend_calls.unload_bank;
+    AKRESULT result = wwise.backend->unload_bank_async(wwise.backend_instance, bank.id, request);
+    if (result != AK_Success) {
+        end_bank_operation(wwise, *request);
+        log_error("Could not unload bank: %u (%s): %d", bank.id, bank_log_name(bank.id), result);
+    }
+}
+
+// The least recently used loaded bank without references, or nullptr.
+const Bank *least_recently_used_bank(const Wwise &wwise) {
+    const Bank *lru = nullptr;
+
+    for (const Hash<Bank>::Entry *it = hash::begin(wwise.loaded_banks); it != hash::end(wwise.loaded_banks); ++it) {
+        const Bank &bank = it->value;
+        if (bank.ref_count > 0 || bank.state != BankState::Loaded) {
+            continue;
+        }
+
+        if (!lru || bank.last_used < lru->last_used) {
+            lru = &bank;
         }
-        
-        AK::IAkStreamMgr::Get()->Destroy();
     }
-    
-    if (AK::MemoryMgr::IsInitialized()) {
-        AK::MemoryMgr::Term();
+
+    return lru;
+}
+
+void trim_banks(Wwise &wwise) {
+    if (wwise.bank_memory_budget == 0) {
+        return;
+    }
+
+    while (wwise.bank_memory > wwise.bank_memory_budget) {
+        const Bank *lru = least_recently_used_bank(wwise);
+        if (!lru) {
+            break;
+        }
+
+        Bank bank = *lru;
+        log_info("Evicting bank %u (%s), %" PRIu64 " bytes", bank.id, bank_log_name(bank.id), bank.memory);
+        evict_bank(wwise, bank);
     }
 }
 
-AkBankID load_bank(Wwise &wwise, const char *bank_name) {
-    AkBankID out_bank_id;
-    AKRESULT result = AK::SoundEngine::LoadBank(bank_name, out_bank_id);
+} // namespace
+
+AkBankID load_bank(Wwise &wwise, AkBankID bank_id) {
+    Bank bank = find_bank(wwise, bank_id);
+    ++bank.ref_count;
+    bank.last_used = ++wwise.bank_clock;
+
+    if (bank.state == BankState::Loaded) {
+        hash::set(wwise.loaded_banks, (uint64_t)bank_id, bank);
+        return bank_id;
+    }
+
+    if (bank.state == BankState::Loading) {
+        hash::set(wwise.loaded_banks, (uint64_t)bank_id, bank);
+        if (!wait_for_banks(wwise, &bank_id, 1)) {
+            log_fatal("Could not load bank: %u (%s)", bank_id, bank_log_name(bank_id));
+        }
+        return bank_id;
+    }
+
+    // The load runs on the bank thread after the operations in flight anyway. Finishing them first leaves the change
+    // in bank memory to this bank alone.
+    while (wwise.pending_bank_operations > 0) {
+        update_banks(wwise);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    uint64_t memory_at_request = bank_memory_used(wwise);
+
+    // Supersedes any earlier load, so its completion is ignored.
+    bank.sequence = ++wwise.bank_sequence;
+
+    ++wwise.backend_calls.load_bank;
+    AKRESULT result = wwise.backend->load_bank(wwise.backend_instance, bank_id);
     if (result != AK_Success) {
-        log_fatal("Could not load bank: %s: %d", bank_name, result);
+        log_fatal("Could not load bank: %u (%s): %d", bank_id, bank_log_name(bank_id), result);
     }
+
+    uint64_t memory_used = bank_memory_used(wwise);
+    wwise.bank_memory_baseline = memory_used;
+    bank.state = BankState::Loaded;
+    bank.result = result;
+    bank.memory = memory_used > memory_at_request ? memory_used - memory_at_request : 0;
+    wwise.bank_memory += bank.memory;
     
-    uint64_t hash_key = murmur_hash_64(bank_name, (uint32_t)strlen(bank_name), 0);
-    hash::set(wwise.loaded_banks, hash_key, out_bank_id);
+    hash::set(wwise.loaded_banks, (uint64_t)bank_id, bank);
+    trim_banks(wwise);
     
-    return out_bank_id;
+    return bank_id;
 }
 
-void unload_bank(Wwise &wwise, const char *bank_name) {
-    uint64_t hash_key = murmur_hash_64(bank_name, (uint32_t)strlen(bank_name), 0);
+AkBankID load_bank(Wwise &wwise, const char *bank_name) {
+    return load_bank(wwise, names::hash(bank_name));
+}
 
-    if (!hash::has(wwise.loaded_banks, hash_key)) {
-        log_error("Trying to unload a bank that isn't loaded: %s", bank_name);
+void unload_bank(Wwise &wwise, AkBankID bank_id) {
+    if (!hash::has(wwise.loaded_banks, (uint64_t)bank_id)) {
+        log_error("Trying to unload a bank that isn't loaded: %u", bank_id);
         return;
     }
-    
-    AkBankID bank_id = hash::get(wwise.loaded_banks, hash_key, (AkBankID)0);
-    hash::remove(wwise.loaded_banks, hash_key);
-    
-    AKRESULT result = AK::SoundEngine::UnloadBank(bank_id, NULL);
+
+    Bank bank = find_bank(wwise, bank_id);
+    if (bank.ref_count == 0) {
+        log_error("Trying to unload a bank that has no references: %u", bank_id);
+        return;
+    }
+
+    --bank.ref_count;
+    bank.last_used = ++wwise.bank_clock;
+
+    if (bank.ref_count == 0 && bank.state == BankState::Failed) {
+        hash::remove(wwise.loaded_banks, (uint64_t)bank_id);
+        return;
+    }
+
+    hash::set(wwise.loaded_banks, (uint64_t)bank_id, bank);
+    trim_banks(wwise);
+}
+
+void unload_bank(Wwise &wwise, const char *bank_name) {
+    unload_bank(wwise, names::hash(bank_name));
+}
+
+AkBankID load_bank_async(Wwise &wwise, AkBankID bank_id) {
+    Bank bank = find_bank(wwise, bank_id);
+    ++bank.ref_count;
+    bank.last_used = ++wwise.bank_clock;
+
+    if (bank.state == BankState::Loading || bank.state == BankState::Loaded) {
+        hash::set(wwise.loaded_banks, (uint64_t)bank_id, bank);
+        return bank_id;
+    }
+
+    bank.sequence = ++wwise.bank_sequence;
+    BankRequest *request = begin_bank_operation(wwise, bank.sequence);
+
+    ++wwise.backend_calls.load_bank;
+    AKRESULT result = wwise.backend->load_bank_async(wwise.backend_instance, bank_id, request);
+    bank.result = result;
+
     if (result != AK_Success) {
-        log_fatal("Could not load bank: %d: %d", bank_id, result);
+        end_bank_operation(wwise, *request);
+        log_error("Could not load bank: %u (%s): %d", bank_id, bank_log_name(bank_id), result);
+        bank.state = BankState::Failed;
+    } else {
+        bank.state = BankState::Loading;
     }
+
+    hash::set(wwise.loaded_banks, (uint64_t)bank_id, bank);
+
+    return bank_id;
 }
 
-AkGameObjectID register_game_object(const char *name) {
-    AkGameObjectID id = ++game_object_count;
-    
-    AKRESULT result = AK::SoundEngine::RegisterGameObj(id, name);
+AkBankID load_bank_async(Wwise &wwise, const char *bank_name) {
+    return load_bank_async(wwise, names::hash(bank_name));
+}
+
+BankState bank_state(const Wwise &wwise, AkBankID bank_id) {
+    return find_bank(wwise, bank_id).state;
+}
+
+uint64_t bank_memory(const Wwise &wwise, AkBankID bank_id) {
+    return find_bank(wwise, bank_id).memory;
+}
+
+void evict_unused_banks(Wwise &wwise) {
+    while (const Bank *lru = least_recently_used_bank(wwise)) {
+        Bank bank = *lru;
+        evict_bank(wwise, bank);
+    }
+}
+
+bool banks_ready(Wwise &wwise, const AkBankID *bank_ids, uint32_t count) {
+    update_banks(wwise);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (bank_state(wwise, bank_ids[i]) == BankState::Loading) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool wait_for_banks(Wwise &wwise, const AkBankID *bank_ids, uint32_t count) {
+    while (!banks_ready(wwise, bank_ids, count)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    bool success = true;
+    for (uint32_t i = 0; i < count; ++i) {
+        success &= bank_state(wwise, bank_ids[i]) == BankState::Loaded;
+    }
+
+    return success;
+}
+
+void update_banks(Wwise &wwise) {
+    BankCompletions &completions = *wwise.bank_completions;
+
+    uint32_t read = completions.read.load(std::memory_order_relaxed);
+    uint32_t write = completions.write.load(std::memory_order_acquire);
+
+    for (; read != write; ++read) {
+        BankCompletion completion = completions.entries[read % BANK_COMPLETION_CAPACITY];
+        const BankRequest &request = completions.requests[completion.request];
+        const uint32_t sequence = request.sequence;
+        end_bank_operation(wwise, request);
+
+        // The backend finishes operations one at a time and in order, so bank memory allocated since the previous
+        // completion belongs to this bank.
+        uint64_t baseline = wwise.bank_memory_baseline;
+        wwise.bank_memory_baseline = completion.bank_memory_used;
+
+        if (completion.unload) {
+            if (completion.result != AK_Success) {
+                log_error("Could not unload bank: %u: %d", completion.bank_id, completion.result);
+            }
+            continue;
+        }
+
+        // A load that was superseded by an unload and a new load, which hasn't finished yet.
+        Bank bank = find_bank(wwise, completion.bank_id);
+        if (bank.state != BankState::Loading || bank.sequence != sequence) {
+            continue;
+        }
+
+        bank.result = completion.result;
+        if (completion.result == AK_Success) {
+            bank.state = BankState::Loaded;
+
+            bank.memory = completion.bank_memory_used > baseline ? completion.bank_memory_used - baseline : 0;
+            wwise.bank_memory += bank.memory;
+        } else {
+            bank.state = BankState::Failed;
+            log_error("Could not load bank: %u: %d", completion.bank_id, completion.result);
+        }
+
+        hash::set(wwise.loaded_banks, (uint64_t)completion.bank_id, bank);
+    }
+
+    completions.read.store(read, std::memory_order_release);
+
+    trim_banks(wwise);
+}
+
+namespace {
+
+constexpr uint32_t TRANSFORM_BLOCK = 64;
+
+uint32_t game_object_slot(AkGameObjectID game_object_id) {
+    return (uint32_t)game_object_id;
+}
+
+uint32_t game_object_generation(AkGameObjectID game_object_id) {
+    return (uint32_t)(game_object_id >> 32);
+}
+
+uint32_t lowest_bit(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(v);
+#endif
+}
+
+void stage_pose(TransformStaging &staging, AkGameObjectID game_object_id, glm::vec3 position, glm::vec3 front, glm::vec3 top, bool screen_space) {
+    const uint32_t slot = game_object_slot(game_object_id);
+
+    if (slot >= array::size(staging.game_object)) {
+        const uint32_t size = (slot / TRANSFORM_BLOCK + 1) * TRANSFORM_BLOCK;
+        array::resize(staging.game_object, size);
+        array::resize(staging.position_x, size);
+        array::resize(staging.position_y, size);
+        array::resize(staging.position_z, size);
+        array::resize(staging.front_x, size);
+        array::resize(staging.front_y, size);
+        array::resize(staging.front_z, size);
+        array::resize(staging.top_x, size);
+        array::resize(staging.top_y, size);
+        array::resize(staging.top_z, size);
+        array::resize(staging.screen_space, size);
+
+        const uint32_t old_words = array::size(staging.dirty);
+        array::resize(staging.dirty, size / TRANSFORM_BLOCK);
+        for (uint32_t w = old_words; w < array::size(staging.dirty); ++w) {
+            staging.dirty[w] = 0;
+        }
+    }
+
+    staging.game_object[slot] = game_object_id;
+    staging.position_x[slot] = position.x;
+    staging.position_y[slot] = position.y;
+    staging.position_z[slot] = position.z;
+    staging.front_x[slot] = front.x;
+    staging.front_y[slot] = front.y;
+    staging.front_z[slot] = front.z;
+    staging.top_x[slot] = top.x;
+    staging.top_y[slot] = top.y;
+    staging.top_z[slot] = top.z;
+    staging.screen_space[slot] = screen_space ? 0xffffffffu : 0u;
+    staging.dirty[slot / TRANSFORM_BLOCK] |= 1ull << (slot % TRANSFORM_BLOCK);
+}
+
+// Writes the world space y components of a block of slots. Screen space poses are mirrored: positions to
+// screen_height - y, directions to -y. World space poses are copied.
+void mirror_block_to_world(const TransformStaging &staging, uint32_t first, float screen_height, float *position_y, float *front_y, float *top_y) {
+    const uint32_t *screen_space = array::begin(staging.screen_space) + first;
+    const float *py = array::begin(staging.position_y) + first;
+    const float *fy = array::begin(staging.front_y) + first;
+    const float *ty = array::begin(staging.top_y) + first;
+
+#if defined(PLOP_WWISE_SSE2)
+    const __m128 height = _mm_set1_ps(screen_height);
+    const __m128 zero = _mm_setzero_ps();
+    for (uint32_t i = 0; i < TRANSFORM_BLOCK; i += 4) {
+        const __m128 mask = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(screen_space + i)));
+        const __m128 p = _mm_loadu_ps(py + i);
+        const __m128 f = _mm_loadu_ps(fy + i);
+        const __m128 t = _mm_loadu_ps(ty + i);
+        _mm_storeu_ps(position_y + i, _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(height, p)), _mm_andnot_ps(mask, p)));
+        _mm_storeu_ps(front_y + i, _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(zero, f)), _mm_andnot_ps(mask, f)));
+        _mm_storeu_ps(top_y + i, _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(zero, t)), _mm_andnot_ps(mask, t)));
+    }
+#else
+    for (uint32_t i = 0; i < TRANSFORM_BLOCK; ++i) {
+        const bool mirror = screen_space[i] != 0;
+        position_y[i] = mirror ? screen_height - py[i] : py[i];
+        front_y[i] = mirror ? -fy[i] : fy[i];
+        top_y[i] = mirror ? -ty[i] : ty[i];
+    }
+#endif
+}
+
+// Hashes the parameter with the whole game object ID, generation included, so the values of a game object that was
+// unregistered never alias those of the one that reuses its slot. Two values colliding on a key is unlikely but
+// possible, so set_game_parameter checks the cached entry is the value's before using it.
+uint64_t game_parameter_key(AkRtpcID parameter_id, AkGameObjectID game_object_id) {
+    uint64_t h = game_object_id ^ ((uint64_t)parameter_id * 0x9e3779b97f4a7c15ull);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Forgets the cached game parameter values of a game object, so a reused ID starts out unset.
+void remove_game_parameters(Wwise &wwise, AkGameObjectID game_object_id) {
+    const Hash<uint64_t>::Entry *e = multi_hash::find_first(wwise.object_game_parameters, game_object_id);
+    for (; e; e = multi_hash::find_next(wwise.object_game_parameters, e)) {
+        hash::remove(wwise.game_parameters, e->value);
+    }
+    multi_hash::remove_all(wwise.object_game_parameters, game_object_id);
+}
+
+} // namespace
+
+AkGameObjectID register_game_object(Wwise &wwise, const char *name) {
+    GameObjects &game_objects = wwise.game_objects;
+
+    uint32_t slot;
+    if (array::size(game_objects.free_slots) > 0) {
+        slot = array::back(game_objects.free_slots);
+        array::pop_back(game_objects.free_slots);
+    } else {
+        slot = array::size(game_objects.generation);
+        assert(slot < UINT32_MAX);
+        array::push_back(game_objects.generation, 1u);
+    }
+
+    const AkGameObjectID id = ((AkGameObjectID)game_objects.generation[slot] << 32) | slot;
+
+    ++wwise.backend_calls.register_game_object;
+    AKRESULT result = wwise.backend->register_game_object(wwise.backend_instance, id, name);
     if (result != AK_Success) {
-        log_fatal("Could not AK::SoundEngine::RegisterGameObj: %s: %d", name, result);
+        log_error("Could not register game object: %s: %d", name, result);
+        array::push_back(game_objects.free_slots, slot);
+        return AK_INVALID_GAME_OBJECT;
     }
-    
+
+    ++game_objects.registered;
     return id;
 }
 
-void unregister_game_object(AkGameObjectID game_object_id) {
-    AKRESULT result = AK::SoundEngine::UnregisterGameObj(game_object_id);
-    if (result != AK_Success) {
-        log_fatal("Could not AK::SoundEngine::UnregisterGameObj: %d: %d", game_object_id, result);
+void register_game_objects(Wwise &wwise, const char *const *names, uint32_t count, AkGameObjectID *game_object_ids) {
+    for (uint32_t i = 0; i < count; ++i) {
+        game_object_ids[i] = register_game_object(wwise, names ? names[i] : nullptr);
+    }
+}
+
+bool game_object_valid(const Wwise &wwise, AkGameObjectID game_object_id) {
+    const uint32_t slot = game_object_slot(game_object_id);
+    if (game_object_id == AK_INVALID_GAME_OBJECT || slot >= array::size(wwise.game_objects.generation)) {
+        return false;
+    }
+
+    // Unregistering bumps the generation, so releasing game objects fail this too.
+    return wwise.game_objects.generation[slot] == game_object_generation(game_object_id);
+}
+
+void unregister_game_object(Wwise &wwise, AkGameObjectID game_object_id) {
+    assert(game_object_valid(wwise, game_object_id));
+    array::push_back(wwise.game_objects.releasing, game_object_id);
+
+    // Skip generation 0 on wrap around, so no ID is ever 0.
+    uint32_t &generation = wwise.game_objects.generation[game_object_slot(game_object_id)];
+    generation = generation == UINT32_MAX ? 1 : generation + 1;
+}
+
+void unregister_game_objects(Wwise &wwise, const AkGameObjectID *game_object_ids, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        unregister_game_object(wwise, game_object_ids[i]);
+    }
+}
+
+void update_game_objects(Wwise &wwise) {
+    GameObjects &game_objects = wwise.game_objects;
+
+    uint32_t i = 0;
+    while (i < array::size(game_objects.releasing)) {
+        const AkGameObjectID game_object_id = game_objects.releasing[i];
+
+        if (wwise.backend->playing_count(wwise.backend_instance, game_object_id) > 0) {
+            ++i;
+            continue;
+        }
+
+        // Drop a pose staged this frame, the game object is gone by the time it would be submitted.
+        const uint32_t slot = game_object_slot(game_object_id);
+        if (slot < array::size(wwise.transforms.game_object)) {
+            wwise.transforms.dirty[slot / TRANSFORM_BLOCK] &= ~(1ull << (slot % TRANSFORM_BLOCK));
+        }
+        remove_game_parameters(wwise, game_object_id);
+
+        ++wwise.backend_calls.unregister_game_object;
+        AKRESULT result = wwise.backend->unregister_game_object(wwise.backend_instance, game_object_id);
+        if (result != AK_Success) {
+            log_error("Could not unregister game object: %" PRIu64 ": %d", game_object_id, result);
+        }
+
+        array::push_back(game_objects.free_slots, slot);
+        --game_objects.registered;
+
+        swap_pop(game_objects.releasing, i);
     }
 }
 
-AkPlayingID post_event(AkUniqueID event_id, AkGameObjectID game_object_id) {
-    AkPlayingID playing_id = AK::SoundEngine::PostEvent(event_id, game_object_id);
+AkPlayingID post_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id) {
+    wwise.backend_calls.post_event.fetch_add(1, std::memory_order_relaxed);
+    AkPlayingID playing_id = wwise.backend->post_event(wwise.backend_instance, event_id, game_object_id, 0, nullptr);
     if (playing_id == AK_INVALID_PLAYING_ID) {
-        log_error("Could not AK::SoundEngine::PostEvent %u for game object %" PRIu64 "", event_id, game_object_id);
+        log_error("Could not post event %u for game object %" PRIu64 "", event_id, game_object_id);
     }
     
     return playing_id;
 }
 
-AkPlayingID post_event(const char *event_name, AkGameObjectID game_object_id) {
-    AkPlayingID playing_id = AK::SoundEngine::PostEvent(event_name, game_object_id);
+AkPlayingID post_event(Wwise &wwise, const char *event_name, AkGameObjectID game_object_id) {
+    AkUniqueID event_id = names::hash(event_name);
+    if (!names::find(event_id, names::Kind::Event)) {
+        log_error("Could not post event %s, it's not in the generated sound banks", event_name);
+        return AK_INVALID_PLAYING_ID;
+    }
+
+    return post_event(wwise, event_id, game_object_id);
+}
+
+bool queue_post_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, Lane lane) {
+    return push_command(wwise.commands->lanes[(uint32_t)lane], Command{CommandType::PostEvent, event_id, game_object_id, 0, now_us(), 0});
+}
+
+bool queue_stop_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs fade, Lane lane) {
+    return push_command(wwise.commands->lanes[(uint32_t)lane], Command{CommandType::StopEvent, event_id, game_object_id, fade, now_us(), 0});
+}
+
+bool queue_seek_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs position, Lane lane) {
+    return push_command(wwise.commands->lanes[(uint32_t)lane], Command{CommandType::SeekEvent, event_id, game_object_id, position, now_us(), 0});
+}
+
+bool queue_post_event_at(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, uint64_t sample_time, Lane lane) {
+    return push_command(wwise.commands->lanes[(uint32_t)lane], Command{CommandType::PostEventAt, event_id, game_object_id, 0, now_us(), sample_time});
+}
+
+namespace {
+
+void post_queued_event(Wwise &wwise, const Command &command, uint32_t frame_offset) {
+    CommandQueues &queues = *wwise.commands;
+    LatencySlot &slot = queues.latency_slots[queues.next_latency_slot++ % LATENCY_SLOT_COUNT];
+    slot.sample_time = command.sample_time;
+    slot.scheduled = command.type == CommandType::PostEventAt;
+    slot.queued_at.store(command.queued_at, std::memory_order_release);
+
+    wwise.backend_calls.post_event.fetch_add(1, std::memory_order_relaxed);
+    AkPlayingID playing_id = wwise.backend->post_event(wwise.backend_instance, command.event_id, command.game_object_id, frame_offset, &slot);
     if (playing_id == AK_INVALID_PLAYING_ID) {
-        log_error("Could not AK::SoundEngine::PostEvent %s for game object %" PRIu64 "", event_name, game_object_id);
+        slot.queued_at.store(0, std::memory_order_relaxed);
+        log_error("Could not post event %u for game object %" PRIu64 "", command.event_id, command.game_object_id);
     }
+}
 
-    return playing_id;
+// Posts the scheduled events that start in the next few audio frames, at their offset from the next frame. A backend
+// that can't start events within a frame gets the ones closer to the start of the next frame than the one after,
+// which keeps the error within half a frame.
+void post_scheduled_events(Wwise &wwise) {
+    CommandQueues &queues = *wwise.commands;
+    if (queues.scheduled_count == 0) {
+        return;
+    }
+
+    uint32_t sample_rate = 0;
+    uint32_t frame_length = 0;
+    wwise.backend->audio_format(wwise.backend_instance, sample_rate, frame_length);
+    const uint64_t clock = wwise.backend->sample_clock(wwise.backend_instance);
+    const uint64_t window_end = clock + (wwise.backend->sample_accurate ? (uint64_t)frame_length * SCHEDULE_AHEAD_FRAMES : (frame_length + 1) / 2);
+
+    for (uint32_t i = 0; i < queues.scheduled_count;) {
+        const Command command = queues.scheduled[i];
+        if (command.sample_time >= window_end && frame_length > 0) {
+            ++i;
+            continue;
+        }
+
+        uint32_t frame_offset = 0;
+        if (wwise.backend->sample_accurate && command.sample_time > clock) {
+            frame_offset = (uint32_t)(command.sample_time - clock);
+        }
+
+        post_queued_event(wwise, command, frame_offset);
+        queues.scheduled[i] = queues.scheduled[--queues.scheduled_count];
+    }
 }
 
-void set_pose(AkGameObjectID game_object_id, glm::vec3 position, glm::vec3 front, glm::vec3 top) {
-    AkVector pos;
-    pos.X = position.x;
-    pos.Y = position.y;
-    pos.Z = position.z;
-    
-    AkVector f;
-    f.X = front.x;
-    f.Y = front.y;
-    f.Z = front.z;
-    
-    AkVector t;
-    t.X = top.x;
-    t.Y = top.y;
-    t.Z = top.z;
+} // namespace
 
-    AkSoundPosition transform;
-    transform.Set(pos, f, t);
+void execute_commands(Wwise &wwise) {
+    for (uint32_t l = (uint32_t)Lane::Count; l > 0; --l) {
+        CommandLane &lane = wwise.commands->lanes[l - 1];
 
-    AKRESULT result = AK::SoundEngine::SetPosition(game_object_id, transform);
-    if (result != AK_Success) {
-        log_error("Could not AK::SoundEngine::SetPosition for game object %" PRIu64 ": %d", game_object_id, result);
+        // Only execute the commands already queued, so producers can't keep the update here.
+        const uint32_t queued = depth(lane.queue);
+        if (queued > lane.high_water.load(std::memory_order_relaxed)) {
+            lane.high_water.store(queued, std::memory_order_relaxed);
+        }
+
+        Command command;
+        for (uint32_t i = 0; i < queued && pop(lane.queue, command); ++i) {
+            switch (command.type) {
+            case CommandType::PostEvent: {
+                post_queued_event(wwise, command, 0);
+                break;
+            }
+            case CommandType::PostEventAt: {
+                CommandQueues &queues = *wwise.commands;
+                if (queues.scheduled_count < SCHEDULED_CAPACITY) {
+                    queues.scheduled[queues.scheduled_count++] = command;
+                } else {
+                    post_queued_event(wwise, command, 0);
+                }
+                break;
+            }
+            case CommandType::StopEvent: {
+                wwise.backend_calls.stop_event.fetch_add(1, std::memory_order_relaxed);
+                AKRESULT result = wwise.backend->stop_event(wwise.backend_instance, command.event_id, command.game_object_id, command.time);
+                if (result != AK_Success) {
+                    log_error("Could not stop event %u for game object %" PRIu64 ": %d", command.event_id, command.game_object_id, result);
+                }
+                break;
+            }
+            case CommandType::SeekEvent: {
+                wwise.backend_calls.seek_event.fetch_add(1, std::memory_order_relaxed);
+                AKRESULT result = wwise.backend->seek_event(wwise.backend_instance, command.event_id, command.game_object_id, command.time);
+                if (result != AK_Success) {
+                    log_error("Could not seek event %u for game object %" PRIu64 ": %d", command.event_id, command.game_object_id, result);
+                }
+                break;
+            }
+            }
+            lane.executed.fetch_add(1, std::memory_order_relaxed);
+        }
     }
+
+    post_scheduled_events(wwise);
 }
 
-void set_position(AkGameObjectID game_object_id, glm::vec3 position) {
-    set_pose(game_object_id, position, glm::vec3 { 0, 0, 1 }, glm::vec3 { 0, 1, 0 });
+CommandLaneStats command_lane_stats(const Wwise &wwise, Lane lane) {
+    const CommandLane &l = wwise.commands->lanes[(uint32_t)lane];
+
+    CommandLaneStats stats;
+    stats.depth = depth(l.queue);
+    stats.high_water = l.high_water.load(std::memory_order_relaxed);
+    stats.dropped = l.dropped.load(std::memory_order_relaxed);
+    stats.executed = l.executed.load(std::memory_order_relaxed);
+    return stats;
 }
 
-void set_game_parameter(AkRtpcID parameter_id, AkGameObjectID game_object_id, AkRtpcValue value) {
-    AKRESULT result = AK::SoundEngine::SetRTPCValue(parameter_id, value, game_object_id);
-    if (result != AK_Success) {
-        log_error("Could not AK::SoundEngine::SetRTPCValue for game object %" PRIu64 ": %d", game_object_id, result);
+void set_pose(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position, glm::vec3 front, glm::vec3 top) {
+    assert(game_object_valid(wwise, game_object_id));
+    stage_pose(wwise.transforms, game_object_id, position, front, top, false);
+}
+
+void set_position(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position) {
+    set_pose(wwise, game_object_id, position, glm::vec3 { 0, 0, 1 }, glm::vec3 { 0, 1, 0 });
+}
+
+void set_screen_pose(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position, glm::vec3 front, glm::vec3 top) {
+    assert(game_object_valid(wwise, game_object_id));
+    stage_pose(wwise.transforms, game_object_id, position, front, top, true);
+}
+
+void set_screen_position(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position) {
+    set_screen_pose(wwise, game_object_id, position, glm::vec3 { 0, 0, 1 }, glm::vec3 { 0, -1, 0 });
+}
+
+void submit_transforms(Wwise &wwise) {
+    TransformStaging &staging = wwise.transforms;
+    staging.submitted = 0;
+
+    float position_y[TRANSFORM_BLOCK];
+    float front_y[TRANSFORM_BLOCK];
+    float top_y[TRANSFORM_BLOCK];
+
+    const uint32_t words = array::size(staging.dirty);
+    for (uint32_t w = 0; w < words; ++w) {
+        uint64_t dirty = staging.dirty[w];
+        if (dirty == 0) {
+            continue;
+        }
+        staging.dirty[w] = 0;
+
+        const uint32_t first = w * TRANSFORM_BLOCK;
+        mirror_block_to_world(staging, first, wwise.screen_height, position_y, front_y, top_y);
+
+        while (dirty) {
+            const uint32_t i = lowest_bit(dirty);
+            dirty &= dirty - 1;
+
+            const uint32_t slot = first + i;
+            const AkVector position = {staging.position_x[slot], position_y[i], staging.position_z[slot]};
+            const AkVector front = {staging.front_x[slot], front_y[i], staging.front_z[slot]};
+            const AkVector top = {staging.top_x[slot], top_y[i], staging.top_z[slot]};
+
+            const AkGameObjectID game_object_id = staging.game_object[slot];
+            ++wwise.backend_calls.set_position;
+            AKRESULT result = wwise.backend->set_position(wwise.backend_instance, game_object_id, position, front, top);
+            if (result != AK_Success) {
+                log_error("Could not set position for game object %" PRIu64 ": %d", game_object_id, result);
+            }
+            ++staging.submitted;
+        }
+    }
+}
+
+void set_game_parameter(Wwise &wwise, AkRtpcID parameter_id, AkGameObjectID game_object_id, AkRtpcValue value) {
+    assert(game_object_id == AK_INVALID_GAME_OBJECT || game_object_valid(wwise, game_object_id));
+    const uint64_t key = game_parameter_key(parameter_id, game_object_id);
+    const GameParameter unset = {parameter_id, game_object_id, 0.0f, 0.0f, false, false};
+    GameParameter parameter = hash::get(wwise.game_parameters, key, unset);
+
+    // The key belongs to another value, which keeps the cache entry. This one isn't cached and is set right away.
+    if (parameter.parameter_id != parameter_id || parameter.game_object_id != game_object_id) {
+        ++wwise.backend_calls.set_game_parameter;
+        AKRESULT result = wwise.backend->set_game_parameter(wwise.backend_instance, parameter_id, value, game_object_id);
+        if (result != AK_Success) {
+            log_error("Could not set game parameter for game object %" PRIu64 ": %d", game_object_id, result);
+        } else {
+            ++wwise.game_parameter_stats.submitted;
+        }
+        return;
+    }
+
+    // The global game object is never unregistered, so its values are never removed.
+    if (game_object_id != AK_INVALID_GAME_OBJECT && !hash::has(wwise.game_parameters, key)) {
+        multi_hash::insert(wwise.object_game_parameters, game_object_id, key);
+    }
+
+    if (parameter.dirty) {
+        ++wwise.game_parameter_stats.suppressed;
+    } else {
+        parameter.dirty = true;
+        array::push_back(wwise.dirty_game_parameters, key);
+    }
+
+    parameter.value = value;
+    hash::set(wwise.game_parameters, key, parameter);
+}
+
+void submit_game_parameters(Wwise &wwise) {
+    for (uint32_t i = 0; i < array::size(wwise.dirty_game_parameters); ++i) {
+        const uint64_t key = wwise.dirty_game_parameters[i];
+        GameParameter parameter = hash::get(wwise.game_parameters, key, GameParameter{});
+        if (!parameter.dirty) {
+            // The game object was unregistered after the value was set.
+            continue;
+        }
+        parameter.dirty = false;
+
+        AkRtpcValue value = parameter.value;
+        if (wwise.game_parameter_quantum > 0.0f) {
+            value = roundf(value / wwise.game_parameter_quantum) * wwise.game_parameter_quantum;
+        }
+
+        if (parameter.submitted && fabsf(value - parameter.submitted_value) <= wwise.game_parameter_epsilon) {
+            ++wwise.game_parameter_stats.suppressed;
+            hash::set(wwise.game_parameters, key, parameter);
+            continue;
+        }
+
+        ++wwise.backend_calls.set_game_parameter;
+        AKRESULT result = wwise.backend->set_game_parameter(wwise.backend_instance, parameter.parameter_id, value, parameter.game_object_id);
+        if (result != AK_Success) {
+            log_error("Could not set game parameter for game object %" PRIu64 ": %d", parameter.game_object_id, result);
+        } else {
+            parameter.submitted_value = value;
+            parameter.submitted = true;
+            ++wwise.game_parameter_stats.submitted;
+        }
+
+        hash::set(wwise.game_parameters, key, parameter);
+    }
+
+    array::clear(wwise.dirty_game_parameters);
+}
+
+void flush_monitor_messages(Wwise &wwise) {
+    MonitorMessages &messages = *wwise.monitor;
+
+    const uint32_t dropped = messages.dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        log_error("Dropped %u Wwise monitor messages", dropped);
+    }
+
+    char text[MONITOR_MESSAGE_LENGTH * 3];
+    MonitorMessage message;
+    while (pop(messages.queue, message)) {
+        to_utf8(message.text, text, sizeof(text));
+
+        char playing[32] = "";
+        if (message.playing_id != AK_INVALID_PLAYING_ID) {
+            snprintf(playing, sizeof(playing), " playing id: %u", message.playing_id);
+        }
+
+        char object[48] = "";
+        if (message.game_object_id != AK_INVALID_GAME_OBJECT) {
+            snprintf(object, sizeof(object), " object id: %" PRIu64, message.game_object_id);
+        }
+
+        if (message.error) {
+            log_error("(%d) %s%s%s", message.error_code, text, playing, object);
+        } else {
+            log_info("(%d) %s%s%s", message.error_code, text, playing, object);
+        }
+    }
+}
+
+AudioLatencyStats audio_latency_stats(const Wwise &wwise) {
+    const CommandQueues &queues = *wwise.commands;
+
+    AudioLatencyStats stats;
+    stats.count = queues.latency_count.load(std::memory_order_relaxed);
+    stats.last_us = queues.latency_last.load(std::memory_order_relaxed);
+    stats.min_us = stats.count > 0 ? queues.latency_min.load(std::memory_order_relaxed) : 0;
+    stats.max_us = queues.latency_max.load(std::memory_order_relaxed);
+    stats.mean_us = stats.count > 0 ? (uint32_t)(queues.latency_sum.load(std::memory_order_relaxed) / stats.count) : 0;
+
+    uint32_t sample_rate = 0;
+    uint32_t frame_length = 0;
+    wwise.backend->audio_format(wwise.backend_instance, sample_rate, frame_length);
+    stats.audio_frame_us = sample_rate > 0 ? (uint32_t)((uint64_t)frame_length * 1000000 / sample_rate) : 0;
+
+    return stats;
+}
+
+uint64_t sample_clock(const Wwise &wwise) {
+    return wwise.backend->sample_clock(wwise.backend_instance);
+}
+
+uint32_t sample_rate(const Wwise &wwise) {
+    uint32_t sample_rate = 0;
+    uint32_t frame_length = 0;
+    wwise.backend->audio_format(wwise.backend_instance, sample_rate, frame_length);
+    return sample_rate;
+}
+
+ScheduleStats schedule_stats(const Wwise &wwise) {
+    const CommandQueues &queues = *wwise.commands;
+
+    ScheduleStats stats;
+    stats.count = queues.schedule_count.load(std::memory_order_relaxed);
+    stats.late = queues.schedule_late.load(std::memory_order_relaxed);
+    stats.last = queues.schedule_error_last.load(std::memory_order_relaxed);
+    stats.min = stats.count > 0 ? queues.schedule_error_min.load(std::memory_order_relaxed) : 0;
+    stats.max = stats.count > 0 ? queues.schedule_error_max.load(std::memory_order_relaxed) : 0;
+    stats.mean_abs = stats.count > 0 ? (uint32_t)(queues.schedule_error_sum.load(std::memory_order_relaxed) / stats.count) : 0;
+    stats.sample_rate = sample_rate(wwise);
+
+    return stats;
+}
+
+bool job_stats(const Wwise &wwise, JobStats &stats) {
+    return wwise.backend->job_stats(wwise.backend_instance, stats);
+}
+
+bool write_job_trace(const Wwise &wwise, const char *path) {
+    return wwise.backend->write_job_trace(wwise.backend_instance, path);
+}
+
+uint32_t set_task_runner(Wwise &wwise, const TaskRunner *runner) {
+    return wwise.backend->set_task_runner(wwise.backend_instance, runner);
+}
+
+void request_task_workers(Wwise &wwise, uint32_t count) {
+    wwise.backend->request_task_workers(wwise.backend_instance, count);
+}
+
+namespace {
+
+void render_thread_main(Wwise *wwise) {
+    RenderThread &render_thread = *wwise->render_thread;
+    const std::chrono::microseconds period(render_thread.period_us);
+
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    while (render_thread.running.load(std::memory_order_acquire)) {
+        execute_commands(*wwise);
+        wwise->backend_calls.render.fetch_add(1, std::memory_order_relaxed);
+        wwise->backend->render(wwise->backend_instance);
+        render_thread.ticks.fetch_add(1, std::memory_order_relaxed);
+
+        // After an overrun start over from now, rather than rendering back to back to catch up.
+        next += period;
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now > next) {
+            render_thread.overruns.fetch_add(1, std::memory_order_relaxed);
+            next = now;
+        }
+
+        std::this_thread::sleep_until(next);
+    }
+}
+
+} // namespace
+
+void start_render_thread(Wwise &wwise, uint32_t period_us) {
+    assert(period_us > 0);
+    if (wwise.render_thread || !wwise.backend_instance) {
+        return;
+    }
+
+    RenderThread *render_thread = MAKE_NEW(wwise.allocator, RenderThread);
+    render_thread->running.store(true, std::memory_order_relaxed);
+    render_thread->period_us = period_us;
+    render_thread->ticks.store(0, std::memory_order_relaxed);
+    render_thread->overruns.store(0, std::memory_order_relaxed);
+    wwise.render_thread = render_thread;
+
+    render_thread->thread = std::thread(render_thread_main, &wwise);
+}
+
+void stop_render_thread(Wwise &wwise) {
+    if (!wwise.render_thread) {
+        return;
     }
+
+    wwise.render_thread->running.store(false, std::memory_order_release);
+    wwise.render_thread->thread.join();
+    MAKE_DELETE(wwise.allocator, RenderThread, wwise.render_thread);
+    wwise.render_thread = nullptr;
 }
 
-void update() {
-    if (AK::SoundEngine::IsInitialized()) {
-        AK::SoundEngine::RenderAudio();
+RenderThreadStats render_thread_stats(const Wwise &wwise) {
+    RenderThreadStats stats = {0, 0, 0};
+    if (wwise.render_thread) {
+        stats.period_us = wwise.render_thread->period_us;
+        stats.ticks = wwise.render_thread->ticks.load(std::memory_order_relaxed);
+        stats.overruns = wwise.render_thread->overruns.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void update(Wwise &wwise) {
+    flush_monitor_messages(wwise);
+    update_banks(wwise);
+    update_game_objects(wwise);
+    submit_transforms(wwise);
+    submit_game_parameters(wwise);
+
+    // The render thread executes the commands and renders on its own period.
+    if (!wwise.render_thread && wwise.backend_instance) {
+        execute_commands(wwise);
+        wwise.backend_calls.render.fetch_add(1, std::memory_order_relaxed);
+        wwise.backend->render(wwise.backend_instance);
     }
 }
 
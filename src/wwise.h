@@ -7,6 +7,7 @@
 #include "Wwise_IDs.h"
 #include <engine/math.inl>
 #include <glm/fwd.hpp>
+#include <atomic>
 
 #pragma warning(pop)
 
@@ -14,32 +15,363 @@
 
 namespace wwise {
 
+struct Backend;
+struct BackendSettings;
+struct JobStats;
+struct TaskRunner;
+struct BankCompletions;
+struct CommandQueues;
+struct MonitorMessages;
+struct RenderThread;
+
+enum class BankState : uint8_t {
+    // Not loaded, or unloaded.
+    Unloaded,
+
+    // A load has been requested and the bank is being loaded on the bank thread.
+    Loading,
+
+    // Loaded and ready to use.
+    Loaded,
+
+    // The load failed.
+    Failed,
+};
+
+struct Bank {
+    AkBankID id;
+    BankState state;
+    AKRESULT result;
+
+    // Number of loads not yet matched by an unload. Unreferenced banks stay resident until evicted.
+    uint32_t ref_count;
+
+    // Bank and media memory allocated by the load of the bank. Media shared with a bank that was loaded before is
+    // counted there.
+    uint64_t memory;
+
+    // Bank clock at the last load or unload, for least recently used eviction.
+    uint64_t last_used;
+
+    // Wwise::bank_sequence at the last load request. Completions of earlier requests are ignored.
+    uint32_t sequence;
+};
+
+/**
+ * @brief Poses waiting to be submitted to the sound engine.
+ *
+ * set_pose writes here and update submits every changed pose in one pass, so a game object moved several times in
+ * a frame costs one AK::SoundEngine::SetPosition. Structure of arrays indexed by game object slot, grown in blocks
+ * of 64 slots so each dirty word covers a whole block.
+ */
+struct TransformStaging {
+    TransformStaging(foundation::Allocator &allocator);
+    DELETE_COPY_AND_MOVE(TransformStaging)
+
+    foundation::Array<AkGameObjectID> game_object;
+    foundation::Array<float> position_x;
+    foundation::Array<float> position_y;
+    foundation::Array<float> position_z;
+    foundation::Array<float> front_x;
+    foundation::Array<float> front_y;
+    foundation::Array<float> front_z;
+    foundation::Array<float> top_x;
+    foundation::Array<float> top_y;
+    foundation::Array<float> top_z;
+
+    // All bits set if the pose is in screen space, which is mirrored to world space when submitted.
+    foundation::Array<uint32_t> screen_space;
+
+    // One bit per slot, set if the pose changed since the last submit.
+    foundation::Array<uint64_t> dirty;
+
+    // Poses submitted by the last update.
+    uint32_t submitted;
+};
+
+/**
+ * @brief Game object IDs handed out by slot, with a generation so a reused slot gets a fresh ID.
+ *
+ * The slot is in the low 32 bits of the ID and its generation in the high 32 bits. Unregistered game objects are
+ * released once the sound engine has nothing playing on them, which frees their slot.
+ */
+struct GameObjects {
+    GameObjects(foundation::Allocator &allocator);
+    DELETE_COPY_AND_MOVE(GameObjects)
+
+    // Generation per slot, bumped when its game object is unregistered. The slot is only reused once it's released.
+    foundation::Array<uint32_t> generation;
+    foundation::Array<uint32_t> free_slots;
+
+    // Unregistered, but possibly still playing.
+    foundation::Array<AkGameObjectID> releasing;
+
+    uint32_t registered;
+};
+
+struct GameParameter {
+    AkRtpcID parameter_id;
+    AkGameObjectID game_object_id;
+
+    // The last value set this frame, and the last value given to the sound engine.
+    AkRtpcValue value;
+    AkRtpcValue submitted_value;
+    bool submitted;
+    bool dirty;
+};
+
+struct GameParameterStats {
+    // Values given to the sound engine.
+    uint64_t submitted;
+
+    // Values dropped, either overwritten later in the same frame or within the epsilon of the submitted value.
+    uint64_t suppressed;
+};
+
+// Queued commands in the priority lane are executed before any in the normal lane, and the lanes are bounded
+// separately, so a flood of normal commands never delays or drops priority ones.
+enum class Lane : uint8_t {
+    Normal,
+    Priority,
+    Count,
+};
+
+struct CommandLaneStats {
+    // Commands waiting to be executed.
+    uint32_t depth;
+
+    // Most commands waiting at one update.
+    uint32_t high_water;
+
+    // Commands dropped because the lane was full.
+    uint64_t dropped;
+
+    uint64_t executed;
+};
+
+// Time from queue_post_event until the first sound of the event starts in the sound engine. It's audible after
+// the audio frame it starts in has been output, so add about one audio frame.
+struct AudioLatencyStats {
+    uint64_t count;
+    uint32_t last_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t mean_us;
+    uint32_t audio_frame_us;
+};
+
+// Error of the posts scheduled with queue_post_event_at, in samples from the requested sample time to the sample the
+// backend reports the event's first sound started at. Positive is late. Events that never start a sound aren't
+// counted, and neither is anything on the null backend, which starts nothing.
+struct ScheduleStats {
+    uint64_t count;
+
+    // Posts that started after their sample time.
+    uint64_t late;
+
+    int32_t last;
+    int32_t min;
+    int32_t max;
+    uint32_t mean_abs;
+    uint32_t sample_rate;
+};
+
+struct RenderThreadStats {
+    // 0 if there's no render thread.
+    uint32_t period_us;
+    uint64_t ticks;
+
+    // Ticks that took longer than the period.
+    uint64_t overruns;
+};
+
+// Calls made to the backend, for measuring the load on the sound engine with any backend.
+struct BackendCalls {
+    std::atomic<uint64_t> load_bank;
+    std::atomic<uint64_t> unload_bank;
+    std::atomic<uint64_t> register_game_object;
+    std::atomic<uint64_t> unregister_game_object;
+    std::atomic<uint64_t> post_event;
+    std::atomic<uint64_t> stop_event;
+    std::atomic<uint64_t> seek_event;
+    std::atomic<uint64_t> set_position;
+    std::atomic<uint64_t> set_game_parameter;
+    std::atomic<uint64_t> render;
+};
+
 struct Wwise {
-    Wwise(foundation::Allocator &allocator);
+    // Starts the sound engine on the backend, or on default_backend() if it's nullptr.
+    Wwise(foundation::Allocator &allocator, const BackendSettings &settings, const Backend *backend = nullptr);
     ~Wwise();
     DELETE_COPY_AND_MOVE(Wwise)
 
     foundation::Allocator &allocator;
-    void *low_level_io;
+    const Backend *backend;
+    void *backend_instance;
+    BackendCalls backend_calls;
+
     AkGameObjectID default_listener_id;
     AkGameObjectID unpositioned_game_object_id;
-    foundation::Hash<AkBankID> loaded_banks;
+
+    // Banks by bank ID, including ones still being loaded.
+    foundation::Hash<Bank> loaded_banks;
+
+    // Unreferenced banks are evicted, least recently used first, while bank_memory exceeds the budget. 0 means
+    // unreferenced banks stay resident.
+    uint64_t bank_memory_budget;
+    uint64_t bank_memory;
+    uint64_t bank_clock;
+    uint32_t bank_sequence;
+
+    // Asynchronous bank load and unload results, written from the bank thread.
+    BankCompletions *bank_completions;
+    uint32_t pending_bank_operations;
+
+    // Backend::bank_memory_used after the last finished bank operation, or when an operation was requested with none
+    // in flight. Its change up to the next completion belongs to that completion's bank.
+    uint64_t bank_memory_baseline;
+
+    GameObjects game_objects;
+    TransformStaging transforms;
+
+    // Height of the screen, for mirroring screen space poses.
+    float screen_height;
+
+    // Game parameter values by parameter and game object, coalesced per frame.
+    foundation::Hash<GameParameter> game_parameters;
+    foundation::Array<uint64_t> dirty_game_parameters;
+
+    // Keys into game_parameters by game object, a multi hash, so unregistering a game object finds its values
+    // without scanning all of them.
+    foundation::Hash<uint64_t> object_game_parameters;
+
+    // Values closer than the epsilon to the submitted value are dropped. Values are rounded to a multiple of the
+    // quantum first, if it's not 0.
+    float game_parameter_epsilon;
+    float game_parameter_quantum;
+    GameParameterStats game_parameter_stats;
+
+    // Commands queued from any thread, executed by update.
+    CommandQueues *commands;
+
+    // Monitor output from the sound engine threads, logged by update.
+    MonitorMessages *monitor;
+
+    // Executes the commands and renders audio at a fixed period, if started.
+    RenderThread *render_thread;
 };
 
+// Takes a reference to a bank, loading it if it isn't resident. Banks are tracked and loaded by ID: the name overload
+// hashes the name once, the ID overload not at all.
+AkBankID load_bank(Wwise &wwise, AkBankID bank_id);
 AkBankID load_bank(Wwise &wwise, const char *bank_name);
+
+// Releases a reference to a bank. The bank stays resident until it's evicted to stay within the memory budget.
+void unload_bank(Wwise &wwise, AkBankID bank_id);
 void unload_bank(Wwise &wwise, const char *bank_name);
 
-AkGameObjectID register_game_object(const char *name);
-void unregister_game_object(AkGameObjectID game_object_id);
+// Takes a reference to a bank like load_bank, but returns immediately and loads it on the bank thread. Poll with
+// bank_state or wait with wait_for_banks.
+AkBankID load_bank_async(Wwise &wwise, AkBankID bank_id);
+AkBankID load_bank_async(Wwise &wwise, const char *bank_name);
+
+BankState bank_state(const Wwise &wwise, AkBankID bank_id);
+
+// Bank and media memory allocated by the load of a resident bank.
+uint64_t bank_memory(const Wwise &wwise, AkBankID bank_id);
+
+// Unloads all unreferenced banks, regardless of the memory budget.
+void evict_unused_banks(Wwise &wwise);
+
+// Whether all the banks are done loading, successfully or not.
+bool banks_ready(Wwise &wwise, const AkBankID *bank_ids, uint32_t count);
+
+// Blocks until all the banks are done loading. Returns whether they all loaded successfully.
+bool wait_for_banks(Wwise &wwise, const AkBankID *bank_ids, uint32_t count);
+
+// Applies the results of finished asynchronous bank operations and evicts banks over the memory budget.
+void update_banks(Wwise &wwise);
+
+// Registers a game object with the sound engine. Returns AK_INVALID_GAME_OBJECT on failure. The sound engine has no
+// call registering several, so register_game_objects registers them one by one, and every ID can be posted on at once.
+AkGameObjectID register_game_object(Wwise &wwise, const char *name);
+void register_game_objects(Wwise &wwise, const char *const *names, uint32_t count, AkGameObjectID *game_object_ids);
+
+// Unregisters a game object once nothing is playing on it anymore. The ID is invalid from this call on.
+void unregister_game_object(Wwise &wwise, AkGameObjectID game_object_id);
+void unregister_game_objects(Wwise &wwise, const AkGameObjectID *game_object_ids, uint32_t count);
+
+// Whether the ID is of a registered game object that hasn't been unregistered.
+bool game_object_valid(const Wwise &wwise, AkGameObjectID game_object_id);
+
+// Releases the unregistered game objects that are done playing, all in one pass. Called by update.
+void update_game_objects(Wwise &wwise);
+
+AkPlayingID post_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id);
+AkPlayingID post_event(Wwise &wwise, const char *event_name, AkGameObjectID game_object_id);
+
+// Queue a command to be executed by the next update. Unlike the functions above they can be called from any
+// thread. Returns false, and counts a drop, if the lane is full.
+bool queue_post_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, Lane lane = Lane::Normal);
+bool queue_stop_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs fade = 0, Lane lane = Lane::Normal);
+bool queue_seek_event(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs position, Lane lane = Lane::Normal);
+
+// Queues a post that starts at a time on the sample clock. It's held until the audio frame the time falls in, and
+// starts at that sample if the backend is sample accurate, otherwise at the closest audio frame start. Queue it
+// at least a game frame and an audio frame ahead, or it starts late.
+bool queue_post_event_at(Wwise &wwise, AkUniqueID event_id, AkGameObjectID game_object_id, uint64_t sample_time, Lane lane = Lane::Priority);
+
+// Executes the queued commands, priority lane first. Called by update.
+void execute_commands(Wwise &wwise);
+
+// Can be called from any thread.
+CommandLaneStats command_lane_stats(const Wwise &wwise, Lane lane);
+
+// Stages a world space pose, submitted by the next update.
+void set_pose(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position, glm::vec3 front, glm::vec3 top);
+void set_position(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position);
+
+// Stages a pose in screen space, with y growing downwards. It's mirrored to world space when submitted.
+void set_screen_pose(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position, glm::vec3 front, glm::vec3 top);
+void set_screen_position(Wwise &wwise, AkGameObjectID game_object_id, glm::vec3 position);
+
+// Submits all poses staged since the last call. Called by update.
+void submit_transforms(Wwise &wwise);
+
+// Sets a game parameter value. Only the last value set in a frame is submitted, by the next update.
+void set_game_parameter(Wwise &wwise, AkRtpcID parameter_id, AkGameObjectID game_object_id, AkRtpcValue value);
+
+// Submits all game parameter values set since the last call. Called by update.
+void submit_game_parameters(Wwise &wwise);
+
+AudioLatencyStats audio_latency_stats(const Wwise &wwise);
+
+// The sample the next audio frame starts at, and the samples per second it advances by, or 0 if unknown. Can be
+// called from any thread.
+uint64_t sample_clock(const Wwise &wwise);
+uint32_t sample_rate(const Wwise &wwise);
+
+ScheduleStats schedule_stats(const Wwise &wwise);
+
+// Snapshot of the sound engine job worker counters, and the recent jobs of each worker written as a Chrome trace
+// event file. Both return false if the backend has no job workers. Can be called from any thread.
+bool job_stats(const Wwise &wwise, JobStats &stats);
+bool write_job_trace(const Wwise &wwise, const char *path);
 
-AkPlayingID post_event(AkUniqueID event_id, AkGameObjectID game_object_id);
-AkPlayingID post_event(const char *event_name, AkGameObjectID game_object_id);
+// Runs game tasks on the job workers between their audio jobs, see Backend::set_task_runner. Returns the number of
+// job workers, 0 if the backend has none.
+uint32_t set_task_runner(Wwise &wwise, const TaskRunner *runner);
+void request_task_workers(Wwise &wwise, uint32_t count);
 
-void set_pose(AkGameObjectID game_object_id, glm::vec3 position, glm::vec3 front, glm::vec3 top);
-void set_position(AkGameObjectID game_object_id, glm::vec3 position);
+// Moves executing the queued commands and AK::SoundEngine::RenderAudio from update to a thread that runs them every
+// period, so audio isn't tied to the game frame rate. Game code should then only post through the command queue.
+void start_render_thread(Wwise &wwise, uint32_t period_us);
+void stop_render_thread(Wwise &wwise);
+RenderThreadStats render_thread_stats(const Wwise &wwise);
 
-void set_game_parameter(AkRtpcID parameter_id, AkGameObjectID game_object_id, AkRtpcValue value);
+// Logs the monitor output reported by the sound engine since the last call. Called by update.
+void flush_monitor_messages(Wwise &wwise);
 
-void update();
+void update(Wwise &wwise);
 
 } // namespace wwise
@@ -0,0 +1,613 @@
+#include "audio_backend.h"
+#include "cpu_topology.h"
+#include "wwise_names.h"
+
+#pragma warning(push, 0)
+#include "memory.h"
+
+#include <engine/log.h>
+
+#include <atomic>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <AK/SoundEngine/Common/AkMemoryMgr.h>
+#include <AK/SoundEngine/Common/AkModule.h>
+#include <AK/SoundEngine/Common/AkSoundEngine.h>
+#include <AK/SoundEngine/Common/AkStreamMgrModule.h>
+#include <AK/SoundEngine/Common/IAkStreamMgr.h>
+#include "SoundEngine/Common/AkJobWorkerMgr.h"
+#include "SoundEngine/Common/AkFilePackageLowLevelIODeferred.h"
+
+#if !defined AK_OPTIMIZED
+#include <AK/Comm/AkCommunication.h>
+#endif
+
+#pragma warning(pop)
+
+namespace wwise {
+
+using namespace foundation;
+
+namespace {
+
+// Banks are loaded by ID. Packages index them by ID, but the default file location opens "<id>.bnk", while the
+// generated bank files are named after their bank. Banks outside the packages are opened under the name the generated
+// bank tables give their ID.
+class LowLevelIO : public CAkFilePackageLowLevelIODeferred {
+  protected:
+    AKRESULT Open(const AkFileOpenData &open_data, AkFileDesc *&file_desc) override {
+        const names::Bank *bank = nullptr;
+        if (!open_data.pszFileName && open_data.pFlags && open_data.pFlags->uCompanyID == AKCOMPANYID_AUDIOKINETIC && AK::IsBankCodecID(open_data.pFlags->uCodecID)) {
+            bank = names::find_bank(open_data.fileID);
+        }
+        if (!bank) {
+            return CAkFilePackageLowLevelIODeferred::Open(open_data, file_desc);
+        }
+
+        AkPackageFileDesc *package_file_desc = nullptr;
+        AKRESULT result = FindInPackages(open_data, package_file_desc);
+        if (result == AK_Success) {
+            file_desc = package_file_desc;
+            return AK_Success;
+        }
+        if (result != AK_FileNotFound || !m_bFallback) {
+            return result;
+        }
+
+        char file_name[256];
+        snprintf(file_name, sizeof(file_name), "%s.bnk", bank->name);
+        AkOSChar *os_file_name = nullptr;
+        CONVERT_CHAR_TO_OSCHAR(file_name, os_file_name);
+
+        AkFileOpenData named_open_data = open_data;
+        named_open_data.pszFileName = os_file_name;
+        named_open_data.fileID = AK_INVALID_FILE_ID;
+        return CAkDefaultIOHookDeferred::Open(named_open_data, file_desc);
+    }
+};
+
+struct WwiseBackend {
+    Allocator *allocator;
+    LowLevelIO *low_level_io;
+    uint32_t job_worker_count;
+};
+
+static_assert(JOB_TYPE_COUNT == AK_NUM_JOB_TYPES, "JobWorkerStats::jobs is indexed by AkJobType");
+static_assert(MAX_JOB_WORKER_STATS >= AK::JobWorkerMgr::k_uMaxWorkerThreads, "JobStats::workers holds every worker");
+
+// Trace event names by AK::JobWorkerMgr::TraceEvent::uKind, the job types followed by trimming, parking and game tasks.
+const char *TRACE_EVENT_NAMES[] = {"Generic", "AudioGraph", "SpatialAudio", "Trim", "Park", "Task"};
+static_assert(sizeof(TRACE_EVENT_NAMES) / sizeof(TRACE_EVENT_NAMES[0]) == AK::JobWorkerMgr::TraceKind_Task + 1, "A name for each trace event kind");
+
+constexpr uint32_t MAX_JOB_WORKERS = plop::MAX_LOGICAL_PROCESSORS;
+
+// Affinity masks for the main thread, the audio thread and job workers, 0 for unpinned.
+struct JobWorkerPlan {
+    uint64_t main_thread_affinity;
+    uint64_t audio_thread_affinity;
+    uint32_t worker_count;
+    uint64_t worker_affinity[MAX_JOB_WORKERS];
+};
+
+// The main thread is pinned to the first reserved core, the audio thread to the last one. Every other core gets a job
+// worker on all its SMT siblings, starting with the cores sharing the audio thread's cache, since the workers
+// process the audio thread's jobs. A configured worker count past the free cores doubles up on them.
+void plan_job_workers(const plop::CpuTopology &topology, const BackendSettings &settings, JobWorkerPlan &plan) {
+    memset(&plan, 0, sizeof(plan));
+
+    // Always leave a core for the workers.
+    const uint32_t reserved = settings.reserved_cores < topology.core_count ? settings.reserved_cores : topology.core_count - 1;
+    const uint32_t audio_core = reserved >= 2 ? reserved - 1 : 0;
+    const uint32_t audio_domain = plop::cpu_topology::cache_domain(topology, audio_core);
+
+    uint32_t cores[MAX_JOB_WORKERS];
+    uint32_t core_count = 0;
+    for (uint32_t pass = 0; pass < 2; ++pass) {
+        for (uint32_t core = reserved; core < topology.core_count; ++core) {
+            bool same_domain = plop::cpu_topology::cache_domain(topology, core) == audio_domain;
+            if (same_domain == (pass == 0)) {
+                cores[core_count++] = core;
+            }
+        }
+    }
+
+    plan.worker_count = settings.job_workers > 0 ? settings.job_workers : core_count;
+    plan.worker_count = plan.worker_count < MAX_JOB_WORKERS ? plan.worker_count : MAX_JOB_WORKERS;
+
+    if (!settings.pin_threads || core_count == 0) {
+        return;
+    }
+
+    plan.main_thread_affinity = reserved >= 1 ? topology.core_mask[0] : 0;
+    plan.audio_thread_affinity = reserved >= 2 ? topology.core_mask[audio_core] : 0;
+    for (uint32_t i = 0; i < plan.worker_count; ++i) {
+        plan.worker_affinity[i] = topology.core_mask[cores[i % core_count]];
+    }
+}
+
+AK::JobWorkerMgr::TrimPolicy trim_policy(TrimPolicy policy) {
+    switch (policy) {
+    case TrimPolicy::OnPark:
+        return AK::JobWorkerMgr::TrimPolicy_OnPark;
+    case TrimPolicy::AfterJobs:
+        return AK::JobWorkerMgr::TrimPolicy_AfterJobs;
+    case TrimPolicy::AfterIdle:
+        return AK::JobWorkerMgr::TrimPolicy_AfterIdle;
+    case TrimPolicy::AboveHighWater:
+        return AK::JobWorkerMgr::TrimPolicy_AboveHighWater;
+    case TrimPolicy::Never:
+        return AK::JobWorkerMgr::TrimPolicy_Never;
+    }
+    return AK::JobWorkerMgr::TrimPolicy_OnPark;
+}
+
+// The sound engine callbacks only carry one cookie, which is wwise.cpp's, so the callbacks are global. There's only
+// ever one sound engine.
+BackendCallbacks callbacks;
+
+// AK::SoundEngine::GetSampleTick widened to 64 bits, since it wraps after about a day at 48 kHz. A tick read on any
+// thread is placed within 2^31 samples of the latest one, which holds as long as the clock is read twice a day.
+std::atomic<uint64_t> sample_tick;
+
+uint64_t widen_sample_tick(AkUInt32 tick) {
+    uint64_t last = sample_tick.load(std::memory_order_relaxed);
+    for (;;) {
+        const uint64_t widened = (uint64_t)((int64_t)last + (int32_t)(tick - (AkUInt32)last));
+        if (widened <= last || sample_tick.compare_exchange_weak(last, widened, std::memory_order_relaxed)) {
+            return widened;
+        }
+    }
+}
+
+void local_output_func(AK::Monitor::ErrorCode in_eErrorCode, const AkOSChar *in_pszError, AK::Monitor::ErrorLevel in_eErrorLevel, AkPlayingID in_playingID, AkGameObjectID in_gameObjID) {
+    callbacks.monitor((int32_t)in_eErrorCode, in_eErrorLevel == AK::Monitor::ErrorLevel::ErrorLevel_Error, in_pszError, in_playingID, in_gameObjID);
+}
+
+void bank_load_callback(AkUInt32 in_bankID, const void *in_pInMemoryBankPtr, AKRESULT in_eLoadResult, void *in_pCookie) {
+    (void)in_pInMemoryBankPtr;
+    callbacks.bank_loaded(in_bankID, in_eLoadResult, in_pCookie);
+}
+
+void bank_unload_callback(AkUInt32 in_bankID, const void *in_pInMemoryBankPtr, AKRESULT in_eLoadResult, void *in_pCookie) {
+    (void)in_pInMemoryBankPtr;
+    callbacks.bank_unloaded(in_bankID, in_eLoadResult, in_pCookie);
+}
+
+// Called on the audio thread while it renders the frame the sound starts in, so the sample tick is that frame's and
+// the sound's start sample: sounds posted with PostEvent start at the beginning of a frame.
+void event_callback(AkCallbackType in_eType, AkCallbackInfo *in_pCallbackInfo) {
+    (void)in_eType;
+    callbacks.event_started(in_pCallbackInfo->pCookie, widen_sample_tick(AK::SoundEngine::GetSampleTick()));
+}
+
+void *init(Allocator &allocator, const BackendCallbacks &backend_callbacks, const BackendSettings &settings) {
+    callbacks = backend_callbacks;
+    sample_tick.store(0, std::memory_order_relaxed);
+
+    plop::CpuTopology topology;
+    plop::cpu_topology::detect(topology);
+
+    JobWorkerPlan plan;
+    plan_job_workers(topology, settings, plan);
+    log_info("Audio job workers: %u, %spinned, on %u cores with %u logical processors in %u cache domains", plan.worker_count, settings.pin_threads ? "" : "not ", topology.core_count, topology.logical_count, topology.cache_domain_count);
+
+    WwiseBackend *backend = MAKE_NEW(allocator, WwiseBackend);
+    backend->allocator = &allocator;
+    backend->low_level_io = nullptr;
+    backend->job_worker_count = 0;
+
+    // MemoryMgr
+    {
+        AkMemSettings mem_settings;
+        AK::MemoryMgr::GetDefaultSettings(mem_settings);
+        AKRESULT result = AK::MemoryMgr::Init(&mem_settings);
+        if (result != AK_Success) {
+            log_fatal("Could not initialize AK::MemoryMgr: %d", result);
+        }
+    }
+
+    // Monitor
+    {
+        AKRESULT result = AK::Monitor::SetLocalOutput(AK::Monitor::ErrorLevel::ErrorLevel_All, local_output_func);
+        if (result != AK_Success) {
+            log_fatal("Could not AK::Monitor::SetLocalOutput: %d", result);
+        }
+    }
+
+    // StreamMgr
+    {
+        AkStreamMgrSettings stm_settings;
+        AK::StreamMgr::GetDefaultSettings(stm_settings);
+        AK::IAkStreamMgr *stream_manager = AK::StreamMgr::Create(stm_settings);
+        if (!stream_manager) {
+            log_fatal("Could not create AK::StreamMgt");
+        }
+
+        AkDeviceSettings device_settings;
+        AK::StreamMgr::GetDefaultDeviceSettings(device_settings);
+        device_settings.bUseStreamCache = true;
+
+        backend->low_level_io = MAKE_NEW(allocator, LowLevelIO);
+        AKRESULT result = backend->low_level_io->Init(device_settings);
+        if (result != AK_Success) {
+            log_fatal("Could not initialize CAkFilePackageLowLevelIODeferred: %d", result);
+        }
+
+#if !defined(_WIN32)
+        log_info("Streaming I/O uses %s", backend->low_level_io->UsesIoUring() ? "io_uring" : "a pread thread pool");
+#endif
+
+        AkOSChar *bank_path = nullptr;
+        CONVERT_CHAR_TO_OSCHAR(settings.bank_path, bank_path);
+        backend->low_level_io->SetBasePath(bank_path);
+        AK::StreamMgr::SetCurrentLanguage(AKTEXT("English(US)"));
+    }
+
+    // JobWorkerMgr
+    AK::JobWorkerMgr::InitSettings job_worker_settings;
+    {
+        AK::JobWorkerMgr::GetDefaultInitSettings(job_worker_settings);
+        job_worker_settings.uNumWorkerThreads = plan.worker_count;
+        job_worker_settings.eTrimPolicy = trim_policy(settings.trim_policy);
+        job_worker_settings.uTrimAfterJobs = settings.trim_after_jobs;
+        job_worker_settings.uTrimIdleTimeoutMs = settings.trim_idle_ms;
+        job_worker_settings.uTrimHighWaterBytes = (AkUInt64)settings.trim_high_water_kb * 1024;
+
+        AkThreadProperties worker_properties[MAX_JOB_WORKERS];
+        for (uint32_t i = 0; i < plan.worker_count; ++i) {
+            AKPLATFORM::AkGetDefaultHighPriorityThreadProperties(worker_properties[i]);
+            if (plan.worker_affinity[i]) {
+                worker_properties[i].dwAffinityMask = (decltype(worker_properties[i].dwAffinityMask))plan.worker_affinity[i];
+            }
+        }
+        job_worker_settings.arThreadWorkerProperties = worker_properties;
+
+        AKRESULT result = AK::JobWorkerMgr::InitWorkers(job_worker_settings);
+        if (result != AK_Success) {
+            log_fatal("Could not initialize AK::JobWorkerMgr::InitWorkers: %d", result);
+        }
+        backend->job_worker_count = plan.worker_count;
+
+        // The workers have copied their properties.
+        job_worker_settings.arThreadWorkerProperties = nullptr;
+    }
+
+    // SoundEngine
+    {
+        AkInitSettings init_settings;
+        AkPlatformInitSettings platform_init_settings;
+        AK::SoundEngine::GetDefaultInitSettings(init_settings);
+        AK::SoundEngine::GetDefaultPlatformInitSettings(platform_init_settings);
+
+        // Without the job manager settings the sound engine never hands jobs to the workers.
+        init_settings.settingsJobManager = job_worker_settings.GetJobMgrSettings();
+
+        if (plan.audio_thread_affinity) {
+            platform_init_settings.threadLEngine.dwAffinityMask = (decltype(platform_init_settings.threadLEngine.dwAffinityMask))plan.audio_thread_affinity;
+        }
+        platform_init_settings.bUseLEngineThread = !settings.offline_render;
+
+        AKRESULT result = AK::SoundEngine::Init(&init_settings, &platform_init_settings);
+        if (result != AK_Success) {
+            log_fatal("Could not initialize AK::SoundEngine: %d", result);
+        }
+
+        if (settings.offline_render) {
+            result = AK::SoundEngine::SetOfflineRendering(true);
+            if (result != AK_Success) {
+                log_fatal("Could not AK::SoundEngine::SetOfflineRendering: %d", result);
+            }
+        }
+    }
+
+    // Plugins
+    {
+//        AK::SoundEngine::RegisterPlugin(A)
+    }
+
+#if !defined AK_OPTIMIZED
+    // Communication
+    {
+        AkCommSettings comm_settings;
+        AK::Comm::GetDefaultInitSettings(comm_settings);
+        AKPLATFORM::SafeStrCpy(comm_settings.szAppNetworkName, "Plop", AK_COMM_SETTINGS_MAX_STRING_SIZE);
+        AKRESULT result = AK::Comm::Init(comm_settings);
+        if (result != AK_Success) {
+            log_fatal("Could not initialize AK::Comm: %d", result);
+        }
+    }
+#endif
+
+    // Last, since on Linux threads started from here on inherit the pin. Of the game's threads only the render
+    // thread starts later, and it only hands commands to the audio thread, so it can share the main thread's core.
+    if (plan.main_thread_affinity && !plop::cpu_topology::pin_current_thread(plan.main_thread_affinity)) {
+        log_info("Could not pin the main thread to its core, it runs unpinned");
+    }
+
+    return backend;
+}
+
+bool job_stats(void *, JobStats &stats) {
+    memset(&stats, 0, sizeof(stats));
+    if (!AK::JobWorkerMgr::IsInitialized()) {
+        return false;
+    }
+
+    AK::JobWorkerMgr::Stats ak_stats;
+    AK::JobWorkerMgr::GetStats(ak_stats);
+
+    stats.worker_count = ak_stats.uNumWorkers;
+    stats.elapsed_us = ak_stats.uElapsedUSec;
+    stats.requests = ak_stats.uRequests;
+    stats.enqueue_retries = ak_stats.uEnqueueRetries;
+    stats.queue_depth_total = ak_stats.uQueueDepthTotal;
+    stats.max_queue_depth = ak_stats.uMaxQueueDepth;
+    stats.spin_budget_us = ak_stats.uSpinBudgetUSec;
+
+    for (uint32_t i = 0; i < ak_stats.uNumWorkers; ++i) {
+        const AK::JobWorkerMgr::WorkerStats &ak_worker = ak_stats.workers[i];
+        JobWorkerStats &worker = stats.workers[i];
+        worker.busy_us = ak_worker.uBusyUSec;
+        worker.spin_us = ak_worker.uSpinUSec;
+        worker.parked_us = ak_worker.uParkedUSec;
+        worker.trim_us = ak_worker.uTrimUSec;
+        worker.trims = ak_worker.uTrims;
+        worker.task_us = ak_worker.uTaskUSec;
+        for (uint32_t type = 0; type < JOB_TYPE_COUNT; ++type) {
+            worker.jobs[type] = ak_worker.uJobs[type];
+        }
+        worker.tasks = ak_worker.uTasks;
+        worker.spin_hits = ak_worker.uSpinHits;
+        worker.parks = ak_worker.uParks;
+        worker.wakes = ak_worker.uWakes;
+        worker.wake_latency_us = ak_worker.uWakeLatencyUSec;
+        worker.max_wake_latency_us = ak_worker.uMaxWakeLatencyUSec;
+        worker.queue_depth = ak_worker.uQueueDepth;
+    }
+
+    return true;
+}
+
+void term(Allocator &allocator, void *instance) {
+    WwiseBackend *backend = static_cast<WwiseBackend *>(instance);
+
+#if !defined(AK_OPTIMIZED)
+    AK::Comm::Term();
+#endif
+
+    // The sound engine requests job workers until it is terminated, so the workers go after it.
+    if (AK::SoundEngine::IsInitialized()) {
+        AK::SoundEngine::UnregisterAllGameObj();
+        AK::SoundEngine::Term();
+    }
+
+    if (AK::JobWorkerMgr::IsInitialized()) {
+        JobStats stats;
+        job_stats(backend, stats);
+
+        JobWorkerStats total = {};
+        for (uint32_t i = 0; i < stats.worker_count; ++i) {
+            const JobWorkerStats &worker = stats.workers[i];
+            total.busy_us += worker.busy_us;
+            total.spin_us += worker.spin_us;
+            total.trims += worker.trims;
+            total.trim_us += worker.trim_us;
+            total.spin_hits += worker.spin_hits;
+            total.parks += worker.parks;
+            total.wakes += worker.wakes;
+            total.wake_latency_us += worker.wake_latency_us;
+            total.max_wake_latency_us = worker.max_wake_latency_us > total.max_wake_latency_us ? worker.max_wake_latency_us : total.max_wake_latency_us;
+        }
+        log_info("Audio job worker totals: %" PRIu64 " requests, %.1f ms busy, %.1f ms spinning, %" PRIu64 " spin hits, %" PRIu64 " parks, wake latency mean %.1f us max %" PRIu64 " us, spin budget %u us, %" PRIu64 " trims taking %.1f ms", stats.requests, total.busy_us / 1000.0, total.spin_us / 1000.0, total.spin_hits, total.parks, total.wakes > 0 ? (double)total.wake_latency_us / total.wakes : 0.0, total.max_wake_latency_us, stats.spin_budget_us, total.trims, total.trim_us / 1000.0);
+    }
+
+    AK::JobWorkerMgr::TermWorkers();
+
+    if (AK::IAkStreamMgr::Get()) {
+        if (backend->low_level_io) {
+            CAkFilePackageLowLevelIODeferred::MountStats mount_stats;
+            backend->low_level_io->GetMountStats(mount_stats);
+            log_info("Audio package loading: %" PRIu64 " packages, last %.1f ms, max %.1f ms, %" PRIu64 " opens meanwhile, slowest %" PRIu64 " us", mount_stats.uMounts, mount_stats.uLastMountUSec / 1000.0, mount_stats.uMaxMountUSec / 1000.0, mount_stats.uOpensDuringMount, mount_stats.uMaxOpenDuringMountUSec);
+
+            backend->low_level_io->Term();
+            MAKE_DELETE(allocator, LowLevelIO, backend->low_level_io);
+            backend->low_level_io = nullptr;
+        }
+
+        AK::IAkStreamMgr::Get()->Destroy();
+    }
+
+    if (AK::MemoryMgr::IsInitialized()) {
+        AK::MemoryMgr::Term();
+    }
+
+    MAKE_DELETE(allocator, WwiseBackend, backend);
+}
+
+AKRESULT load_bank(void *, AkBankID bank_id) {
+    return AK::SoundEngine::LoadBank(bank_id);
+}
+
+AKRESULT load_bank_async(void *, AkBankID bank_id, void *cookie) {
+    return AK::SoundEngine::LoadBank(bank_id, bank_load_callback, cookie);
+}
+
+AKRESULT unload_bank_async(void *, AkBankID bank_id, void *cookie) {
+    return AK::SoundEngine::UnloadBank(bank_id, nullptr, bank_unload_callback, cookie);
+}
+
+// Bank data and loaded media. Voices, streams, game objects and the job workers allocate in other categories, and
+// the bank thread loads and unloads one bank at a time.
+uint64_t bank_memory_used(void *) {
+    AK::MemoryMgr::CategoryStats bank_stats;
+    AK::MemoryMgr::CategoryStats media_stats;
+    AK::MemoryMgr::GetCategoryStats(AkMemID_SoundBank, bank_stats);
+    AK::MemoryMgr::GetCategoryStats(AkMemID_Media, media_stats);
+    return bank_stats.uUsed + media_stats.uUsed;
+}
+
+AKRESULT register_game_object(void *, AkGameObjectID game_object_id, const char *name) {
+    return AK::SoundEngine::RegisterGameObj(game_object_id, name);
+}
+
+AKRESULT unregister_game_object(void *, AkGameObjectID game_object_id) {
+    return AK::SoundEngine::UnregisterGameObj(game_object_id);
+}
+
+AKRESULT set_default_listener(void *, AkGameObjectID game_object_id) {
+    return AK::SoundEngine::SetDefaultListeners(&game_object_id, 1);
+}
+
+uint32_t playing_count(void *, AkGameObjectID game_object_id) {
+    AkUInt32 count = 0;
+    if (AK::SoundEngine::Query::GetPlayingIDsFromGameObject(game_object_id, count, nullptr) != AK_Success) {
+        return 0;
+    }
+    return count;
+}
+
+// PostEvent starts the event at the next audio frame, whatever the offset, so the backend isn't sample accurate.
+AkPlayingID post_event(void *, AkUniqueID event_id, AkGameObjectID game_object_id, uint32_t frame_offset, void *start_cookie) {
+    (void)frame_offset;
+
+    // The duration callback comes when each sound of the event starts.
+    const AkUInt32 flags = start_cookie ? AK_Duration : 0;
+    AkCallbackFunc callback = start_cookie ? event_callback : nullptr;
+    return AK::SoundEngine::PostEvent(event_id, game_object_id, flags, callback, start_cookie);
+}
+
+AKRESULT stop_event(void *, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs fade) {
+    return AK::SoundEngine::ExecuteActionOnEvent(event_id, AkActionOnEventType_Stop, game_object_id, fade);
+}
+
+AKRESULT seek_event(void *, AkUniqueID event_id, AkGameObjectID game_object_id, AkTimeMs position) {
+    return AK::SoundEngine::SeekOnEvent(event_id, game_object_id, position);
+}
+
+AKRESULT set_position(void *, AkGameObjectID game_object_id, const AkVector &position, const AkVector &front, const AkVector &top) {
+    AkSoundPosition transform;
+    transform.Set(position, front, top);
+    return AK::SoundEngine::SetPosition(game_object_id, transform);
+}
+
+AKRESULT set_game_parameter(void *, AkRtpcID parameter_id, AkRtpcValue value, AkGameObjectID game_object_id) {
+    return AK::SoundEngine::SetRTPCValue(parameter_id, value, game_object_id);
+}
+
+void render(void *) {
+    AK::SoundEngine::RenderAudio();
+}
+
+void audio_format(void *, uint32_t &sample_rate, uint32_t &frame_length) {
+    AkAudioSettings audio_settings;
+    if (AK::SoundEngine::GetAudioSettings(audio_settings) != AK_Success) {
+        sample_rate = 0;
+        frame_length = 0;
+        return;
+    }
+    sample_rate = audio_settings.uNumSamplesPerSecond;
+    frame_length = audio_settings.uNumSamplesPerFrame;
+}
+
+uint64_t sample_clock(void *) {
+    return widen_sample_tick(AK::SoundEngine::GetSampleTick());
+}
+
+// Complete events on one thread per worker, which chrome://tracing and Perfetto open.
+bool write_job_trace(void *instance, const char *path) {
+    WwiseBackend *backend = static_cast<WwiseBackend *>(instance);
+    if (!AK::JobWorkerMgr::IsInitialized()) {
+        return false;
+    }
+
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        log_error("Could not open %s for writing the audio job trace", path);
+        return false;
+    }
+
+    AK::JobWorkerMgr::Stats stats;
+    AK::JobWorkerMgr::GetStats(stats);
+
+    const uint32_t capacity = AK::JobWorkerMgr::k_uTraceCapacity;
+    AK::JobWorkerMgr::TraceEvent *events = static_cast<AK::JobWorkerMgr::TraceEvent *>(backend->allocator->allocate(sizeof(AK::JobWorkerMgr::TraceEvent) * capacity, alignof(AK::JobWorkerMgr::TraceEvent)));
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (uint32_t worker = 0; worker < stats.uNumWorkers; ++worker) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Audio job worker %u\"}}", worker > 0 ? ",\n" : "", worker, worker);
+
+        const uint32_t count = AK::JobWorkerMgr::GetTrace(worker, events, capacity);
+        for (uint32_t i = 0; i < count; ++i) {
+            const char *name = events[i].uKind <= AK::JobWorkerMgr::TraceKind_Task ? TRACE_EVENT_NAMES[events[i].uKind] : "Unknown";
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 "}", name, worker, events[i].uStartUSec, events[i].uDurationUSec);
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    backend->allocator->deallocate(events);
+
+    const bool written = ferror(file) == 0;
+    if (fclose(file) != 0 || !written) {
+        log_error("Could not write the audio job trace to %s", path);
+        return false;
+    }
+
+    log_info("Wrote the audio job trace to %s", path);
+    return true;
+}
+
+uint32_t set_task_runner(void *instance, const TaskRunner *runner) {
+    WwiseBackend *backend = static_cast<WwiseBackend *>(instance);
+    if (!AK::JobWorkerMgr::IsInitialized()) {
+        return 0;
+    }
+
+    if (!runner) {
+        AK::JobWorkerMgr::SetTaskRunner(nullptr);
+        return 0;
+    }
+
+    AK::JobWorkerMgr::TaskRunner ak_runner;
+    ak_runner.fnRunTask = runner->run_task;
+    ak_runner.fnHasTask = runner->has_task;
+    ak_runner.pCookie = runner->cookie;
+    AK::JobWorkerMgr::SetTaskRunner(&ak_runner);
+    return backend->job_worker_count;
+}
+
+void request_task_workers(void *, uint32_t count) {
+    AK::JobWorkerMgr::RequestTaskWorkers(count);
+}
+
+} // namespace
+
+const Backend WWISE_BACKEND = {
+    "wwise",
+    false,
+    init,
+    term,
+    load_bank,
+    load_bank_async,
+    unload_bank_async,
+    bank_memory_used,
+    register_game_object,
+    unregister_game_object,
+    set_default_listener,
+    playing_count,
+    post_event,
+    stop_event,
+    seek_event,
+    set_position,
+    set_game_parameter,
+    render,
+    audio_format,
+    sample_clock,
+    job_stats,
+    write_job_trace,
+    set_task_runner,
+    request_task_workers,
+};
+
+} // namespace wwise
@@ -0,0 +1,204 @@
+#pragma once
+
+#pragma warning(push, 0)
+#include <AK/SoundEngine/Common/AkTypes.h>
+#include "Wwise_IDs.h"
+#pragma warning(pop)
+
+#include <array>
+#include <stdint.h>
+
+// Compile time tables of the Wwise names in the generated sound banks.
+//
+// The entries come from wwise_names.inl, which cmake/GenerateWwiseNames.cmake
+// generates from SoundbanksInfo.xml at build time. Wwise IDs are the 32 bit
+// FNV-1 hash of the lower case name, so a name resolves to its ID at compile
+// time and the ID and kind index a perfect hash table built at compile time.
+namespace wwise {
+namespace names {
+
+enum class Kind : uint8_t {
+    Bank,
+    Event,
+    GameParameter,
+    StateGroup,
+    SwitchGroup,
+    Bus,
+    AuxBus,
+};
+
+struct Name {
+    const char *name;
+    AkUniqueID id;
+    Kind kind;
+    uint64_t banks; // Bit i is set if the name is included in BANKS[i].
+};
+
+struct Bank {
+    const char *name;
+    AkBankID id;
+};
+
+struct EventMedia {
+    AkUniqueID event_id;
+
+    // File name in the Wwise project's Originals folder.
+    const char *file;
+};
+
+// The same hash as AK::SoundEngine::GetIDFromString.
+constexpr AkUniqueID hash(const char *name) {
+    uint32_t h = 2166136261u;
+    for (const char *c = name; *c; ++c) {
+        char lower = (*c >= 'A' && *c <= 'Z') ? (char)(*c - 'A' + 'a') : *c;
+        h = h * 16777619u;
+        h = h ^ (uint8_t)lower;
+    }
+    return h;
+}
+
+#define WWISE_BANK_BIT(index) (1ull << (index))
+
+inline constexpr Bank BANKS[] = {
+#define WWISE_BANK(index, name, id) {name, id},
+#include "wwise_names.inl"
+#undef WWISE_BANK
+};
+
+inline constexpr Name NAMES[] = {
+#define WWISE_NAME(kind, name, id, banks) {name, id, Kind::kind, banks},
+#include "wwise_names.inl"
+#undef WWISE_NAME
+};
+
+#undef WWISE_BANK_BIT
+
+// Ends with a null file, since there may be no media at all.
+inline constexpr EventMedia EVENT_MEDIA[] = {
+#define WWISE_EVENT_MEDIA(event_id, file) {event_id, file},
+#include "wwise_names.inl"
+#undef WWISE_EVENT_MEDIA
+    {0, nullptr},
+};
+
+inline constexpr uint32_t BANK_COUNT = sizeof(BANKS) / sizeof(BANKS[0]);
+inline constexpr uint32_t NAME_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+inline constexpr uint32_t EVENT_MEDIA_COUNT = sizeof(EVENT_MEDIA) / sizeof(EVENT_MEDIA[0]) - 1;
+
+namespace detail {
+
+// Objects of different kinds with the same name have the same ID, so the tables are keyed on both.
+constexpr uint64_t key(AkUniqueID id, Kind kind) {
+    return ((uint64_t)kind << 32) | id;
+}
+
+constexpr uint64_t MULTIPLIERS[] = {0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull, 0xd6e8feb86659fd93ull, 0xff51afd7ed558ccdull};
+constexpr uint32_t MAX_TABLE_BITS = 16;
+
+constexpr uint32_t slot(uint64_t key, uint64_t multiplier, uint32_t bits) {
+    return bits == 0 ? 0 : (uint32_t)((key * multiplier) >> (64 - bits));
+}
+
+constexpr bool collision_free(uint64_t multiplier, uint32_t bits) {
+    std::array<uint64_t, (1u << MAX_TABLE_BITS) / 64> used{};
+    for (uint32_t i = 0; i < NAME_COUNT; ++i) {
+        uint32_t s = slot(key(NAMES[i].id, NAMES[i].kind), multiplier, bits);
+        uint64_t bit = 1ull << (s & 63);
+        if (used[s >> 6] & bit) {
+            return false;
+        }
+        used[s >> 6] |= bit;
+    }
+    return true;
+}
+
+struct Parameters {
+    uint64_t multiplier;
+    uint32_t bits;
+};
+
+// Searches for the smallest table, starting at twice the number of names, where no two keys share a slot.
+constexpr Parameters find_parameters() {
+    uint32_t bits = 0;
+    while ((1u << bits) < NAME_COUNT * 2) {
+        ++bits;
+    }
+
+    for (; bits <= MAX_TABLE_BITS; ++bits) {
+        for (uint64_t multiplier : MULTIPLIERS) {
+            if (collision_free(multiplier, bits)) {
+                return Parameters{multiplier, bits};
+            }
+        }
+    }
+
+    return Parameters{0, 0};
+}
+
+inline constexpr Parameters PARAMETERS = find_parameters();
+static_assert(PARAMETERS.multiplier != 0, "No perfect hash found for the Wwise names");
+
+// Index + 1 into NAMES, or 0 for an empty slot.
+constexpr std::array<uint16_t, (1u << PARAMETERS.bits)> build_table() {
+    std::array<uint16_t, (1u << PARAMETERS.bits)> table{};
+    for (uint32_t i = 0; i < NAME_COUNT; ++i) {
+        table[slot(key(NAMES[i].id, NAMES[i].kind), PARAMETERS.multiplier, PARAMETERS.bits)] = (uint16_t)(i + 1);
+    }
+    return table;
+}
+
+inline constexpr std::array<uint16_t, (1u << PARAMETERS.bits)> TABLE = build_table();
+
+} // namespace detail
+
+// Finds the name of the kind with the ID in a single probe, or nullptr if it isn't in any generated bank.
+constexpr const Name *find(AkUniqueID id, Kind kind) {
+    uint16_t entry = detail::TABLE[detail::slot(detail::key(id, kind), detail::PARAMETERS.multiplier, detail::PARAMETERS.bits)];
+    if (entry == 0 || NAMES[entry - 1].id != id || NAMES[entry - 1].kind != kind) {
+        return nullptr;
+    }
+    return &NAMES[entry - 1];
+}
+
+// Finds a bank by ID, or nullptr.
+constexpr const Bank *find_bank(AkBankID id) {
+    const Name *n = find(id, Kind::Bank);
+    if (!n) {
+        return nullptr;
+    }
+
+    for (uint32_t i = 0; i < BANK_COUNT; ++i) {
+        if (n->banks == (1ull << i)) {
+            return &BANKS[i];
+        }
+    }
+
+    return nullptr;
+}
+
+// Whether the name of the kind with the ID is included in the bank.
+constexpr bool in_bank(AkUniqueID id, Kind kind, AkBankID bank_id) {
+    const Name *n = find(id, kind);
+    const Name *b = find(bank_id, Kind::Bank);
+    return n && b && (n->banks & b->banks) != 0;
+}
+
+#define WWISE_CHECK(group, kind, name) static_assert(find(AK::group::name, Kind::kind) != nullptr, "Wwise_IDs.h " #group "::" #name " is missing from SoundbanksInfo.xml");
+#include "wwise_names.inl"
+#undef WWISE_CHECK
+
+} // namespace names
+} // namespace wwise
+
+// Resolves a Wwise name of a kind to its ID at compile time. Fails the build if
+// the name isn't in the generated sound banks.
+#define WWISE_ID(kind, name)                                                                                      \
+    ([]() constexpr -> AkUniqueID {                                                                              \
+        constexpr const ::wwise::names::Name *n = ::wwise::names::find(::wwise::names::hash(name), ::wwise::names::Kind::kind); \
+        static_assert(n != nullptr, "Unknown Wwise " #kind ": " name);                                           \
+        return n->id;                                                                                             \
+    }())
+
+#define WWISE_EVENT_ID(name) WWISE_ID(Event, name)
+#define WWISE_BANK_ID(name) WWISE_ID(Bank, name)
+#define WWISE_GAME_PARAMETER_ID(name) WWISE_ID(GameParameter, name)